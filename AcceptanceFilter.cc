@@ -0,0 +1,156 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file AcceptanceFilter.cc
+/// \brief Implementation of the B2a::AcceptanceFilter class
+
+#include "AcceptanceFilter.hh"
+
+#include "DetectorConstruction.hh"
+#include "FilterMessenger.hh"
+
+#include "G4Ions.hh"
+#include "G4LogicalVolume.hh"
+#include "G4LossTableManager.hh"
+#include "G4Material.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4RunManager.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4VSolid.hh"
+#include "G4VTouchable.hh"
+
+#include <algorithm>
+#include <cmath>
+
+namespace B2a
+{
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+AcceptanceFilter::AcceptanceFilter()
+{
+  fMessenger = new FilterMessenger(this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+AcceptanceFilter::~AcceptanceFilter()
+{
+  delete fMessenger;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+AcceptanceFilter::Verdict AcceptanceFilter::Classify(const G4ParticleDefinition* particle,
+                                                     G4double kineticEnergy,
+                                                     const G4ThreeVector& position,
+                                                     const G4ThreeVector& direction,
+                                                     const G4TouchableHandle& touchable) const
+{
+  // primaries are not located yet
+  if (!fEnabled || !touchable || !touchable->GetVolume()) return kReach;
+
+  auto lv = touchable->GetVolume()->GetLogicalVolume();
+  if (lv->GetSensitiveDetector()) return kReach;
+
+  G4bool charged = (particle->GetPDGCharge() != 0.);
+
+  // Energy: a charged particle which cannot leave a volume without layers,
+  // and leaves nothing that could: stable, not an antiparticle (a positron
+  // annihilates into two photons), not an excited ion
+  G4bool inert = particle->GetPDGStable() && particle->GetPDGEncoding() > 0;
+  auto ion = dynamic_cast<const G4Ions*>(particle);
+  if (ion && ion->GetExcitationEnergy() > 0.) inert = false;
+  if (charged && inert && kineticEnergy < fRangeEnergy && lv->GetNoDaughters() == 0) {
+    G4double range = G4LossTableManager::Instance()->GetRange(particle, kineticEnergy,
+                                                              lv->GetMaterialCutsCouple());
+    auto localPosition = touchable->GetHistory()->GetTopTransform().TransformPoint(position);
+    if (range < lv->GetSolid()->DistanceToOut(localPosition)) return kNever;
+  }
+
+  // Direction: straight lines only, the charged particles in no field
+  if (charged) {
+    auto detector = static_cast<const DetectorConstruction*>(
+      G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+    if (kineticEnergy < fChargedEnergy || detector->HasField()) return kReach;
+  }
+  if (HitsStack(position, direction)) return kReach;
+
+  return (lv->GetMaterial()->GetDensity() < fMaxLightDensity) ? kNever : kMaybe;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool AcceptanceFilter::HitsStack(const G4ThreeVector& position,
+                                   const G4ThreeVector& direction) const
+{
+  auto detector = static_cast<const DetectorConstruction*>(
+    G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+  const auto& layers = detector->GetLayerExtents();
+  G4double halfWidth = detector->GetLayerHalfWidth() + fMargin;
+
+  // Interval of the half line inside the transverse square of the layers
+  // (which contains the target)
+  G4double tMin = 0.;
+  G4double tMax = DBL_MAX;
+  for (G4int axis = 0; axis < 2; ++axis) {
+    G4double p = position[axis];
+    G4double d = direction[axis];
+    if (d == 0.) {
+      if (std::abs(p) > halfWidth) return false;
+      continue;
+    }
+    G4double t1 = (-halfWidth - p) / d;
+    G4double t2 = (halfWidth - p) / d;
+    tMin = std::max(tMin, std::min(t1, t2));
+    tMax = std::min(tMax, std::max(t1, t2));
+    if (tMin > tMax) return false;
+  }
+
+  // z covered in that interval, against the layers sorted along z
+  G4double z1 = position.z();
+  G4double z2 = position.z();
+  if (direction.z() != 0.) {
+    z1 += tMin * direction.z();
+    z2 = (tMax < DBL_MAX) ? z2 + tMax * direction.z() : (direction.z() > 0. ? DBL_MAX : -DBL_MAX);
+  }
+  G4double zMin = std::min(z1, z2) - fMargin;
+  G4double zMax = std::max(z1, z2) + fMargin;
+
+  // a particle scattered back by the target can still reach the layers
+  const auto& target = detector->GetTargetExtent();
+  if (target.zMin <= zMax && zMin <= target.zMax) return true;
+
+  // first layer ending above zMin
+  auto layer = std::lower_bound(
+    layers.begin(), layers.end(), zMin,
+    [](const DetectorConstruction::LayerExtent& extent, G4double z) { return extent.zMax < z; });
+  return layer != layers.end() && layer->zMin <= zMax;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}  // namespace B2a
@@ -0,0 +1,108 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file AcceptanceFilter.hh
+/// \brief Definition of the B2a::AcceptanceFilter class
+
+#ifndef B2aAcceptanceFilter_h
+#define B2aAcceptanceFilter_h 1
+
+#include "CLHEP/Units/SystemOfUnits.h"
+#include "G4ThreeVector.hh"
+#include "G4TouchableHandle.hh"
+#include "globals.hh"
+
+class G4ParticleDefinition;
+
+namespace B2a
+{
+
+class FilterMessenger;
+
+/// Decides whether a track can still deposit energy in a layer, from the
+/// known stack geometry (see DetectorConstruction::GetLayerExtents()).
+///
+/// - kNever: a stable charged particle, below the range energy (no
+///   significant bremsstrahlung), whose range is shorter than the distance
+///   to the boundary of its (daughter-less, non sensitive) volume, or a
+///   track in a light (air) volume whose straight line misses all the
+///   layers and the target, widened by a margin;
+/// - kMaybe: a track in a dense volume whose straight line misses the
+///   layers: it may still scatter towards them;
+/// - kReach: anything else, including the charged particles which are
+///   not on straight lines (below an energy, or with a magnetic field).
+///
+/// The range rule leaves the antiparticles, the unstable particles and
+/// the excited ions alone: their annihilation or decay products (e.g. the
+/// 511 keV photons of a positron stopping in the target) may escape.
+/// The straight line rule is exact for neutral particles in air up to
+/// interactions in the air, with mean free paths of tens of metres, so
+/// the physics results are unchanged within statistics.
+///
+/// One filter per thread, configured by its FilterMessenger.
+
+class AcceptanceFilter
+{
+  public:
+    enum Verdict
+    {
+      kNever,
+      kMaybe,
+      kReach
+    };
+
+    AcceptanceFilter();
+    ~AcceptanceFilter();
+
+    Verdict Classify(const G4ParticleDefinition* particle, G4double kineticEnergy,
+                     const G4ThreeVector& position, const G4ThreeVector& direction,
+                     const G4TouchableHandle& touchable) const;
+
+    void SetEnabled(G4bool enabled) { fEnabled = enabled; }
+    void SetAbortEvents(G4bool abortEvents) { fAbortEvents = abortEvents; }
+    void SetChargedEnergy(G4double energy) { fChargedEnergy = energy; }
+    void SetRangeEnergy(G4double energy) { fRangeEnergy = energy; }
+    void SetMargin(G4double margin) { fMargin = margin; }
+
+    G4bool IsEnabled() const { return fEnabled; }
+    G4bool IsAbortingEvents() const { return fAbortEvents; }
+
+  private:
+    G4bool HitsStack(const G4ThreeVector& position, const G4ThreeVector& direction) const;
+
+    G4bool fEnabled = false;
+    G4bool fAbortEvents = false;  // drop the kMaybe tracks (approximation)
+    G4double fChargedEnergy = 100. * CLHEP::MeV;  // straight line rule above
+    G4double fRangeEnergy = 2. * CLHEP::MeV;  // range rule below
+    G4double fMargin = 1. * CLHEP::cm;
+    G4double fMaxLightDensity = 0.01 * CLHEP::g / CLHEP::cm3;
+
+    FilterMessenger* fMessenger = nullptr;
+};
+
+}  // namespace B2a
+
+#endif
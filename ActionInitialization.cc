@@ -0,0 +1,103 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file ActionInitialization.cc
+/// \brief Implementation of the B2a::ActionInitialization class
+
+#include "ActionInitialization.hh"
+
+#include "EventAction.hh"
+#include "PhaseSpaceReader.hh"
+#include "RunAction.hh"
+#include "SourceMessenger.hh"
+#include "StackingAction.hh"
+#include "SteppingAction.hh"
+#include "SubEventDriver.hh"
+#include "TrackingAction.hh"
+
+namespace B2a
+{
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ActionInitialization::ActionInitialization()
+{
+  fPhaseSpace = new PhaseSpaceReader;
+  fSourceMessenger = new SourceMessenger(fPhaseSpace, &fSourceParameters);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ActionInitialization::~ActionInitialization()
+{
+  delete fSourceMessenger;
+  delete fPhaseSpace;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ActionInitialization::BuildForMaster() const
+{
+  if (auto subEvent = SubEventDriver::GetInstance()) {
+    subEvent->SetEventAction(BuildEventActions());
+    return;
+  }
+  SetUserAction(new RunAction);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ActionInitialization::Build() const
+{
+  BuildEventActions();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EventAction* ActionInitialization::BuildEventActions() const
+{
+  SetUserAction(new GeneratorAction(fPhaseSpace, &fSourceParameters));
+
+  auto runAction = new RunAction;
+  SetUserAction(runAction);
+
+  auto eventAction = new EventAction(runAction);
+  SetUserAction(eventAction);
+
+  // the acceptance filter of the thread is shared by both actions
+  auto stackingAction = new StackingAction;
+  SetUserAction(stackingAction);
+
+  auto steppingAction = new SteppingAction(stackingAction->GetFilter());
+  SetUserAction(steppingAction);
+  SetUserAction(new TrackingAction(steppingAction));
+
+  return eventAction;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}  // namespace B2a
@@ -0,0 +1,74 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file ActionInitialization.hh
+/// \brief Definition of the B2a::ActionInitialization class
+
+#ifndef B2aActionInitialization_h
+#define B2aActionInitialization_h 1
+
+#include "GeneratorAction.hh"
+
+#include "G4VUserActionInitialization.hh"
+
+namespace B2a
+{
+
+class EventAction;
+class PhaseSpaceReader;
+class SourceMessenger;
+
+/// Action initialization class.
+///
+/// Build() is called once per worker thread (or once in sequential mode),
+/// BuildForMaster() once on the master in MT/tasking mode. In sub-event
+/// mode (see SubEventDriver) the master processes the events, and gets
+/// the actions of a worker.
+///
+/// The single instance owns what the actions of all threads share: the
+/// replayed phase space and the source parameters of the primary
+/// generators.
+
+class ActionInitialization : public G4VUserActionInitialization
+{
+  public:
+    ActionInitialization();
+    ~ActionInitialization() override;
+
+    void BuildForMaster() const override;
+    void Build() const override;
+
+  private:
+    EventAction* BuildEventActions() const;
+
+    PhaseSpaceReader* fPhaseSpace = nullptr;
+    SourceParameters fSourceParameters;
+    SourceMessenger* fSourceMessenger = nullptr;
+};
+
+}  // namespace B2a
+
+#endif
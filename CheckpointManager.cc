@@ -0,0 +1,398 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file CheckpointManager.cc
+/// \brief Implementation of the B2a::CheckpointManager class
+
+#include "CheckpointManager.hh"
+
+#include "CheckpointMessenger.hh"
+#include "OnlineHistograms.hh"
+#include "Run.hh"
+#include "ShardDriver.hh"
+#include "StateIO.hh"
+
+#include "Randomize.hh"
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+namespace B2a
+{
+
+CheckpointManager* CheckpointManager::fgInstance = nullptr;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int CheckpointManager::Segment::GetNbOfEvents() const
+{
+  G4int nofEvents = 0;
+  for (const auto& range : events) nofEvents += range.last - range.first;
+  return nofEvents;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+CheckpointManager::CheckpointManager(G4bool resume) : fResume(resume)
+{
+  fgInstance = this;
+  fMessenger = new CheckpointMessenger(this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+CheckpointManager::~CheckpointManager()
+{
+  StopWriter();
+  delete fMessenger;
+  fgInstance = nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4String CheckpointManager::GetFileTag() const
+{
+  return (fGeneration > 0) ? "_c" + std::to_string(fGeneration) : G4String();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4long CheckpointManager::GetSeed() const
+{
+  // the seed of the events, see SeedEvent()
+  auto shard = ShardDriver::GetInstance();
+  return shard ? shard->GetSeed() : fSeed;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void CheckpointManager::BeginOfRun(G4int runID, const G4String& unsavedStages)
+{
+  fRunID = runID;
+  fGeneration = 0;
+  fRestored.clear();
+  fRestoredEvents.clear();
+  fLatest.clear();
+  fPending = false;
+  fStop = false;
+
+  if (!IsEnabled()) {
+    if (fResume) {
+      G4ExceptionDescription msg;
+      msg << "Run " << runID << " is not checkpointed (/B2/checkpoint/interval), it is not resumed";
+      G4Exception("CheckpointManager::BeginOfRun()", "B2aCheckpoint004", JustWarning, msg);
+    }
+    return;
+  }
+
+  auto shard = ShardDriver::GetInstance();
+  fPath = fFileName + "_r" + std::to_string(runID) + (shard ? shard->GetFileTag() : "") + ".ckpt";
+
+  if (fResume && fs::exists(fPath.c_str())) {
+    if (!unsavedStages.empty()) {
+      G4ExceptionDescription msg;
+      msg << "Cannot resume run " << runID << " from " << fPath
+          << ": not saved in the checkpoints:" << unsavedStages;
+      G4Exception("CheckpointManager::BeginOfRun()", "B2aCheckpoint003", FatalException, msg);
+      return;
+    }
+    if (!ReadFile(fPath)) return;
+    TruncateOutputs();
+
+    // the events of all the segments, as disjoint sorted ranges
+    std::vector<EventRange> ranges;
+    for (const auto& segment : fRestored) {
+      ranges.insert(ranges.end(), segment->events.begin(), segment->events.end());
+    }
+    std::sort(ranges.begin(), ranges.end(),
+              [](const EventRange& a, const EventRange& b) { return a.first < b.first; });
+    G4int nofEvents = 0;
+    for (const auto& range : ranges) {
+      nofEvents += range.last - range.first;
+      if (!fRestoredEvents.empty() && range.first <= fRestoredEvents.back().last) {
+        fRestoredEvents.back().last = std::max(fRestoredEvents.back().last, range.last);
+      }
+      else {
+        fRestoredEvents.push_back(range);
+      }
+    }
+
+    G4cout << G4endl << "----> Run " << runID << " resumed from " << fPath << ": " << nofEvents
+           << " events restored, outputs tagged " << GetFileTag() << G4endl;
+  }
+
+  fWriter = std::thread(&CheckpointManager::WriterLoop, this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool CheckpointManager::IsRestored(G4int eventID) const
+{
+  // first range starting after the event
+  auto next = std::upper_bound(
+    fRestoredEvents.begin(), fRestoredEvents.end(), eventID,
+    [](G4int id, const EventRange& range) { return id < range.first; });
+  return next != fRestoredEvents.begin() && eventID < std::prev(next)->last;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void CheckpointManager::SeedEvent(G4int runID, G4int eventID) const
+{
+  // as in a sharded job, see ShardDriver::SeedEvent()
+  long seeds[3] = {long(fSeed), long(runID), long(eventID)};
+  G4Random::setTheSeeds(seeds, 3);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void CheckpointManager::Post(G4int threadID, Segment&& segment)
+{
+  SegmentPtr latest = std::make_shared<const Segment>(std::move(segment));
+  {
+    std::lock_guard<std::mutex> lock(fMutex);
+    std::swap(fLatest[threadID], latest);
+    fPending = true;
+  }
+  fCondition.notify_one();
+  // the previous state of the thread is released here, out of the lock
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::vector<CheckpointManager::SegmentPtr> CheckpointManager::CollectSegments()
+{
+  // with fMutex locked, or once the writer has stopped
+  std::vector<SegmentPtr> segments = fRestored;
+  for (const auto& entry : fLatest) segments.push_back(entry.second);
+  fPending = false;
+  return segments;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void CheckpointManager::WriterLoop()
+{
+  while (true) {
+    std::vector<SegmentPtr> segments;
+    {
+      std::unique_lock<std::mutex> lock(fMutex);
+      fCondition.wait(lock, [this] { return fPending || fStop; });
+      if (fStop) return;
+      segments = CollectSegments();
+    }
+    WriteFile(segments, false);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void CheckpointManager::StopWriter()
+{
+  if (!fWriter.joinable()) return;
+
+  {
+    std::lock_guard<std::mutex> lock(fMutex);
+    fStop = true;
+  }
+  fCondition.notify_one();
+  fWriter.join();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void CheckpointManager::EndOfRun(Run* run, OnlineHistograms* histograms)
+{
+  // the threads processing events have posted their last state
+  if (!fWriter.joinable()) return;
+  StopWriter();
+
+  G4int nofFailures = 0;
+  for (const auto& segment : fRestored) {
+    Run restored;
+    std::istringstream runState(segment->run);
+    std::istringstream histoState(segment->histograms);
+    if (!restored.ReadState(runState, segment->GetNbOfEvents())) {
+      ++nofFailures;
+      continue;
+    }
+    run->Merge(&restored);
+    if (!histograms->AddState(histoState)) ++nofFailures;
+  }
+  if (nofFailures > 0) {
+    G4ExceptionDescription msg;
+    msg << nofFailures << " restored states of run " << fRunID
+        << " could not be added (other histogram binning?)";
+    G4Exception("CheckpointManager::EndOfRun()", "B2aCheckpoint005", JustWarning, msg);
+  }
+
+  if (WriteFile(CollectSegments(), true)) {
+    G4cout << G4endl << "----> Checkpoint of run " << fRunID << " written to " << fPath << G4endl;
+  }
+  fLatest.clear();
+  fRestored.clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool CheckpointManager::WriteFile(const std::vector<SegmentPtr>& segments,
+                                    G4bool complete) const
+{
+  using namespace StateIO;
+
+  // Write a private copy, then replace the checkpoint with an atomic
+  // rename: a crash leaves the previous checkpoint
+  G4String temporary = fPath + ".tmp";
+  {
+    std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+    char magic[8] = {'B', '2', 'A', 'C', 'K', 'P', 'T', '\0'};
+    file.write(magic, sizeof(magic));
+    Write(file, kVersion);
+    Write(file, fGeneration);
+    Write(file, std::int32_t(fRunID));
+    Write(file, std::uint32_t(complete));
+    Write(file, std::int64_t(GetSeed()));
+    Write(file, std::uint64_t(segments.size()));
+    for (const auto& segment : segments) {
+      WriteVector(file, segment->events);
+      WriteString(file, segment->hitFile);
+      Write(file, segment->hitFileSize);
+      WriteString(file, segment->phaseSpaceFile);
+      Write(file, segment->phaseSpaceFileSize);
+      WriteString(file, segment->run);
+      WriteString(file, segment->histograms);
+    }
+    file.close();
+    if (!file) {
+      G4ExceptionDescription msg;
+      msg << "Cannot write checkpoint file " << temporary;
+      G4Exception("CheckpointManager::WriteFile()", "B2aCheckpoint001", JustWarning, msg);
+      return false;
+    }
+  }
+
+  std::error_code error;
+  fs::rename(temporary.c_str(), fPath.c_str(), error);
+  if (error) {
+    G4ExceptionDescription msg;
+    msg << "Cannot replace checkpoint file " << fPath << ": " << error.message();
+    G4Exception("CheckpointManager::WriteFile()", "B2aCheckpoint001", JustWarning, msg);
+    return false;
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool CheckpointManager::ReadFile(const G4String& fileName)
+{
+  using namespace StateIO;
+
+  // Resuming from a checkpoint which cannot be used would overwrite the
+  // outputs of the previous job: the job is stopped instead
+  auto fail = [&fileName](const G4String& reason) {
+    G4ExceptionDescription msg;
+    msg << "Cannot resume from checkpoint file " << fileName << ": " << reason;
+    G4Exception("CheckpointManager::ReadFile()", "B2aCheckpoint002", FatalException, msg);
+    return false;
+  };
+
+  std::ifstream file(fileName, std::ios::binary);
+  char magic[8] = {};
+  std::uint32_t version = 0;
+  std::uint32_t generation = 0;
+  std::int32_t runID = 0;
+  std::uint32_t complete = 0;  // all the events are restored
+  std::int64_t seed = 0;
+  std::uint64_t nofSegments = 0;
+  file.read(magic, sizeof(magic));
+  Read(file, version);
+  Read(file, generation);
+  Read(file, runID);
+  Read(file, complete);
+  Read(file, seed);
+  Read(file, nofSegments);
+  if (!file || std::memcmp(magic, "B2ACKPT", 8) != 0 || version != kVersion) {
+    return fail("not a checkpoint of version " + std::to_string(kVersion));
+  }
+  if (runID != fRunID) {
+    return fail("checkpoint of run " + std::to_string(runID));
+  }
+  if (seed != GetSeed()) {
+    return fail("checkpoint of seed " + std::to_string(seed) + ", not "
+                + std::to_string(GetSeed()));
+  }
+
+  for (std::uint64_t i = 0; i < nofSegments; ++i) {
+    auto segment = std::make_shared<Segment>();
+    ReadVector(file, segment->events);
+    ReadString(file, segment->hitFile);
+    Read(file, segment->hitFileSize);
+    ReadString(file, segment->phaseSpaceFile);
+    Read(file, segment->phaseSpaceFileSize);
+    ReadString(file, segment->run);
+    ReadString(file, segment->histograms);
+    if (!file) return fail("truncated segment " + std::to_string(i));
+    fRestored.push_back(segment);
+  }
+
+  fGeneration = generation + 1;
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void CheckpointManager::TruncateOutputs() const
+{
+  // the events written after the checkpoint are processed again
+  auto truncate = [](const G4String& fileName, std::uint64_t size) {
+    if (fileName.empty()) return;
+    std::error_code error;
+    auto fileSize = fs::file_size(fileName.c_str(), error);
+    if (!error && fileSize >= size) fs::resize_file(fileName.c_str(), size, error);
+    if (error || fileSize < size) {
+      G4ExceptionDescription msg;
+      msg << fileName << " is missing or shorter than at the checkpoint, events are lost";
+      G4Exception("CheckpointManager::TruncateOutputs()", "B2aCheckpoint006", JustWarning, msg);
+    }
+  };
+
+  for (const auto& segment : fRestored) {
+    truncate(segment->hitFile, segment->hitFileSize);
+    truncate(segment->phaseSpaceFile, segment->phaseSpaceFileSize);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}  // namespace B2a
@@ -0,0 +1,190 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file CheckpointManager.hh
+/// \brief Definition of the B2a::CheckpointManager class
+
+#ifndef B2aCheckpointManager_h
+#define B2aCheckpointManager_h 1
+
+#include "globals.hh"
+
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace B2a
+{
+
+class CheckpointMessenger;
+class OnlineHistograms;
+class Run;
+
+/// Periodic checkpoints of the runs, and their resume (--resume).
+///
+/// With /B2/checkpoint/interval n, each thread processing events saves
+/// its state every n of its events and at its end of run (see
+/// RunAction): the numbers of the events it completed, its Run
+/// accumulators, its online histograms and the sizes of its hit and
+/// phase-space files, their buffers written. The thread serialises its
+/// state in memory and posts it; the writer thread of the manager then
+/// writes the checkpoint of the run, <name>_r<run>.ckpt, from the last
+/// state of each thread, while the event loop goes on. The checkpoint is
+/// written to a temporary file and renamed, so that the file on disk is
+/// always a consistent one.
+///
+/// The events are seeded from the seed, the run number and the event
+/// number only (by the ShardDriver in a sharded job): the states of the
+/// random engines at the event boundaries follow from the event numbers
+/// and need not be saved.
+///
+/// With --resume the job executes its macro again. At the beginning of
+/// each run the checkpoint of the run is read, if any: the output files
+/// are truncated to their checkpointed sizes, the events of the
+/// checkpoint are generated empty and skipped (see GeneratorAction),
+/// and the saved states are added to the results at the end of the run,
+/// which are then those of an uninterrupted run to the rounding of the
+/// sums. The outputs of a resumed run carry the generation of the job,
+/// _c1, _c2, ...; its checkpoints keep the restored states, so that it
+/// can be resumed in turn. The digitization summary and the voxel maps
+/// (see VoxelScorer) are not saved: the job stops rather than resume a
+/// run with digitization or voxel scoring, whose results would only
+/// cover the events it processes.
+///
+/// File layout (host byte order, see StateIO):
+///
+///   header
+///     char     magic[8]      "B2ACKPT\0"
+///     uint32   version       2
+///     uint32   generation    0 for the first job
+///     int32    runID
+///     uint32   complete      1 when written at the end of the run
+///     int64    seed
+///     uint64   nofSegments
+///   segments, the state of one thread of one job each
+///     vector   events        int32 pairs [first, last) of event numbers
+///     string   hitFile,        uint64 size
+///     string   phaseSpaceFile, uint64 size
+///     string   run           Run::WriteState
+///     string   histograms    OnlineHistograms::WriteState
+///
+/// Master thread only, driven by CheckpointMessenger; the threads
+/// processing events post their states and read the restored events.
+
+class CheckpointManager
+{
+  public:
+    // Event numbers [first, last)
+    struct EventRange {
+      G4int first;
+      G4int last;
+    };
+
+    struct Segment {
+      std::vector<EventRange> events;
+      G4String hitFile;
+      std::uint64_t hitFileSize = 0;
+      G4String phaseSpaceFile;
+      std::uint64_t phaseSpaceFileSize = 0;
+      std::string run;
+      std::string histograms;
+
+      G4int GetNbOfEvents() const;
+    };
+
+    static constexpr std::uint32_t kVersion = 2;
+
+    explicit CheckpointManager(G4bool resume);
+    ~CheckpointManager();
+
+    // nullptr in a job without checkpointing support
+    static CheckpointManager* GetInstance() { return fgInstance; }
+
+    void SetFileName(const G4String& name) { fFileName = name; }
+    void SetInterval(G4int nofEvents) { fInterval = nofEvents; }
+    void SetSeed(G4long seed) { fSeed = seed; }
+
+    // Checkpointed runs, the events of which are seeded individually
+    G4bool IsEnabled() const { return fInterval > 0; }
+    G4int GetInterval() const { return fInterval; }
+
+    // Tag of the outputs of the current run: "_c<generation>" if resumed
+    G4String GetFileTag() const;
+
+    // Master: restores the checkpoint of the run, writes the last one; the
+    // job stops if the run has a checkpoint and unsaved stages are enabled
+    void BeginOfRun(G4int runID, const G4String& unsavedStages);
+    void EndOfRun(Run* run, OnlineHistograms* histograms);
+
+    // Threads processing events
+    G4bool IsRestored(G4int eventID) const;
+    void SeedEvent(G4int runID, G4int eventID) const;
+    void Post(G4int threadID, Segment&& segment);
+
+  private:
+    using SegmentPtr = std::shared_ptr<const Segment>;
+
+    G4bool ReadFile(const G4String& fileName);
+    G4bool WriteFile(const std::vector<SegmentPtr>& segments, G4bool complete) const;
+    G4long GetSeed() const;
+    std::vector<SegmentPtr> CollectSegments();
+    void TruncateOutputs() const;
+    void WriterLoop();
+    void StopWriter();
+
+    static CheckpointManager* fgInstance;
+
+    G4bool fResume = false;
+    G4String fFileName = "checkpoint";
+    G4int fInterval = 0;
+    G4long fSeed = 12345;
+
+    // Current run
+    G4int fRunID = -1;
+    G4String fPath;
+    std::uint32_t fGeneration = 0;
+    std::vector<SegmentPtr> fRestored;
+    std::vector<EventRange> fRestoredEvents;  // sorted, disjoint
+
+    // Last state of each thread, by thread ID; the writer thread
+    std::map<G4int, SegmentPtr> fLatest;
+    G4bool fPending = false;
+    G4bool fStop = false;
+    std::thread fWriter;
+    std::mutex fMutex;
+    std::condition_variable fCondition;
+
+    CheckpointMessenger* fMessenger = nullptr;
+};
+
+}  // namespace B2a
+
+#endif
@@ -0,0 +1,102 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file CheckpointMessenger.cc
+/// \brief Implementation of the B2a::CheckpointMessenger class
+
+#include "CheckpointMessenger.hh"
+
+#include "CheckpointManager.hh"
+
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIdirectory.hh"
+
+namespace B2a
+{
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+CheckpointMessenger::CheckpointMessenger(CheckpointManager* manager) : fManager(manager)
+{
+  fDirectory = new G4UIdirectory("/B2/checkpoint/");
+  fDirectory->SetGuidance("Periodic checkpoints of the runs, resumed with --resume.");
+
+  fIntervalCmd = new G4UIcmdWithAnInteger("/B2/checkpoint/interval", this);
+  fIntervalCmd->SetGuidance("Events of a thread between its checkpoints, 0 (default) for");
+  fIntervalCmd->SetGuidance("no checkpoint. The events of checkpointed runs are seeded");
+  fIntervalCmd->SetGuidance("individually (see /B2/checkpoint/seed): the resumed job must");
+  fIntervalCmd->SetGuidance("execute the same macro.");
+  fIntervalCmd->SetParameterName("nofEvents", false);
+  fIntervalCmd->SetRange("nofEvents>=0");
+  fIntervalCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fIntervalCmd->SetToBeBroadcasted(false);
+
+  fFileCmd = new G4UIcmdWithAString("/B2/checkpoint/file", this);
+  fFileCmd->SetGuidance("Base name of the checkpoint files, <name>_r<run>.ckpt.");
+  fFileCmd->SetParameterName("name", false);
+  fFileCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fFileCmd->SetToBeBroadcasted(false);
+
+  fSeedCmd = new G4UIcmdWithAnInteger("/B2/checkpoint/seed", this);
+  fSeedCmd->SetGuidance("Seed of the job: each event is seeded from it, the run number");
+  fSeedCmd->SetGuidance("and the event number. A sharded job uses /B2/shard/seed.");
+  fSeedCmd->SetParameterName("seed", false);
+  fSeedCmd->SetRange("seed>0");
+  fSeedCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fSeedCmd->SetToBeBroadcasted(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+CheckpointMessenger::~CheckpointMessenger()
+{
+  delete fIntervalCmd;
+  delete fFileCmd;
+  delete fSeedCmd;
+  delete fDirectory;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void CheckpointMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+  if (command == fIntervalCmd) {
+    fManager->SetInterval(fIntervalCmd->GetNewIntValue(newValue));
+  }
+
+  if (command == fFileCmd) {
+    fManager->SetFileName(newValue);
+  }
+
+  if (command == fSeedCmd) {
+    fManager->SetSeed(fSeedCmd->GetNewIntValue(newValue));
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}  // namespace B2a
@@ -0,0 +1,74 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file CheckpointMessenger.hh
+/// \brief Definition of the B2a::CheckpointMessenger class
+
+#ifndef B2aCheckpointMessenger_h
+#define B2aCheckpointMessenger_h 1
+
+#include "G4UImessenger.hh"
+
+class G4UIdirectory;
+class G4UIcmdWithAString;
+class G4UIcmdWithAnInteger;
+
+namespace B2a
+{
+
+class CheckpointManager;
+
+/// Messenger class that defines commands for CheckpointManager.
+///
+/// It implements commands:
+/// - /B2/checkpoint/interval nofEvents
+/// - /B2/checkpoint/file name
+/// - /B2/checkpoint/seed value
+///
+/// The checkpoints are managed from the master only, so no command is
+/// broadcast.
+
+class CheckpointMessenger : public G4UImessenger
+{
+  public:
+    CheckpointMessenger(CheckpointManager*);
+    ~CheckpointMessenger() override;
+
+    void SetNewValue(G4UIcommand*, G4String) override;
+
+  private:
+    CheckpointManager* fManager = nullptr;
+
+    G4UIdirectory* fDirectory = nullptr;
+
+    G4UIcmdWithAnInteger* fIntervalCmd = nullptr;
+    G4UIcmdWithAString* fFileCmd = nullptr;
+    G4UIcmdWithAnInteger* fSeedCmd = nullptr;
+};
+
+}  // namespace B2a
+
+#endif
@@ -0,0 +1,216 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file CoincidenceTrigger.cc
+/// \brief Implementation of the B2a::CoincidenceTrigger class
+
+#include "CoincidenceTrigger.hh"
+
+#include "DetectorConstruction.hh"
+#include "Run.hh"
+#include "TriggerMessenger.hh"
+
+#include "G4PhysicalConstants.hh"
+#include "G4RunManager.hh"
+
+#include <algorithm>
+#include <cmath>
+
+namespace B2a
+{
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+CoincidenceTrigger::CoincidenceTrigger()
+{
+  fMessenger = new TriggerMessenger(this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+CoincidenceTrigger::~CoincidenceTrigger()
+{
+  delete fMessenger;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void CoincidenceTrigger::AddCondition(const G4String& name, const G4String& scatterSet,
+                                      const G4String& absorberSet)
+{
+  auto condition = GetCondition(name);
+  if (!condition) {
+    fConditions.emplace_back();
+    condition = &fConditions.back();
+    condition->name = name;
+  }
+  condition->scatterSet = scatterSet;
+  condition->absorberSet = absorberSet;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+CoincidenceTrigger::Condition* CoincidenceTrigger::GetCondition(const G4String& name)
+{
+  for (auto& condition : fConditions) {
+    if (condition.name == name) return &condition;
+  }
+  return nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void CoincidenceTrigger::Resolve(const G4String& set, std::vector<G4int>& layers) const
+{
+  // the layer layout is constant during a run (see DetectorConstruction)
+  auto detector = static_cast<const DetectorConstruction*>(
+    G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+  layers = detector->GetLayerSet(set);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void CoincidenceTrigger::BeginOfRun()
+{
+  if (fConditions.empty()) return;
+
+  for (auto& condition : fConditions) {
+    Resolve(condition.scatterSet, condition.scatterLayers);
+    Resolve(condition.absorberSet, condition.absorberLayers);
+    if (condition.scatterLayers.empty() || condition.absorberLayers.empty()) {
+      G4ExceptionDescription msg;
+      msg << "Trigger " << condition.name << ": no layer in \"" << condition.scatterSet
+          << "\" or \"" << condition.absorberSet << "\", no event will pass it";
+      G4Exception("CoincidenceTrigger::BeginOfRun()", "B2aTrigger001", JustWarning, msg);
+    }
+  }
+
+  auto detector = static_cast<const DetectorConstruction*>(
+    G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+  fLayerEdep.assign(detector->GetNbOfLayers(), 0.);
+  fLayerTime.assign(detector->GetNbOfLayers(), 0.);
+  fTouched.clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void CoincidenceTrigger::AddDeposit(G4int layer, G4double edep, G4double time)
+{
+  if (fLayerEdep[layer] == 0.) {
+    fTouched.push_back(layer);
+    fLayerTime[layer] = time;
+  }
+  else {
+    fLayerTime[layer] = std::min(fLayerTime[layer], time);
+  }
+  fLayerEdep[layer] += edep;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void CoincidenceTrigger::Clear()
+{
+  for (auto layer : fTouched) fLayerEdep[layer] = 0.;
+  fTouched.clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool CoincidenceTrigger::Accept(const TrackerHitsCollection& hits, Run* run,
+                                  G4double weight)
+{
+  if (fConditions.empty()) return true;
+
+  for (std::size_t i = 0; i < hits.entries(); ++i) {
+    AddDeposit(hits[i]->GetChamberNb(), hits[i]->GetEdep(), hits[i]->GetTime());
+  }
+  G4bool accepted = Evaluate(run, weight);
+  Clear();
+  return accepted;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool CoincidenceTrigger::Accept(const PixelHitsCollection& pixels, Run* run,
+                                  G4double weight)
+{
+  if (fConditions.empty()) return true;
+
+  for (std::size_t i = 0; i < pixels.entries(); ++i) {
+    AddDeposit(pixels.GetLayer(i), pixels.GetEdep(i), pixels.GetTime(i));
+  }
+  G4bool accepted = Evaluate(run, weight);
+  Clear();
+  return accepted;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool CoincidenceTrigger::Evaluate(Run* run, G4double weight)
+{
+  G4bool accepted = false;
+
+  for (const auto& condition : fConditions) {
+    // first (scatter, absorber) pair of layers fulfilling the condition
+    G4bool found = false;
+    G4double energy = 0.;
+    G4double angle = 0.;
+    for (auto scatter : condition.scatterLayers) {
+      G4double e1 = fLayerEdep[scatter];
+      if (e1 <= 0. || e1 < condition.scatterMin || e1 > condition.scatterMax) continue;
+      for (auto absorber : condition.absorberLayers) {
+        G4double e2 = fLayerEdep[absorber];
+        if (absorber == scatter || e2 <= 0.) continue;
+        if (e2 < condition.absorberMin || e2 > condition.absorberMax) continue;
+        if (e1 + e2 < condition.totalMin || e1 + e2 > condition.totalMax) continue;
+        if (std::abs(fLayerTime[absorber] - fLayerTime[scatter]) > condition.timeWindow) continue;
+
+        G4double cosTheta = 1. - electron_mass_c2 * (1. / e2 - 1. / (e1 + e2));
+        if (condition.compton && (cosTheta < -1. || cosTheta > 1.)) continue;
+
+        found = true;
+        energy = e1 + e2;
+        angle = std::acos(std::clamp(cosTheta, -1., 1.));
+        break;
+      }
+      if (found) break;
+    }
+
+    if (!found) continue;
+    auto& counters = run->GetTriggerCounters(condition.name);
+    ++counters.accepted;
+    counters.weight += weight;
+    counters.energy += energy;
+    counters.angle += angle;
+    accepted = true;
+  }
+
+  return accepted;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}  // namespace B2a
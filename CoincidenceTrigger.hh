@@ -0,0 +1,122 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file CoincidenceTrigger.hh
+/// \brief Definition of the B2a::CoincidenceTrigger class
+
+#ifndef B2aCoincidenceTrigger_h
+#define B2aCoincidenceTrigger_h 1
+
+#include "PixelHitsCollection.hh"
+#include "TrackerHit.hh"
+
+#include "globals.hh"
+
+#include <vector>
+
+namespace B2a
+{
+
+class Run;
+class TriggerMessenger;
+
+/// In-process event trigger, before the output stages.
+///
+/// The hits of an event are summed per layer (energy, time of the first
+/// deposit). A trigger condition looks for a scatter layer and an
+/// absorber layer, each in its own set and energy window, within a time
+/// window, with a total energy in a window; by default it also requires
+/// the Compton kinematics to be allowed:
+///   cos(theta) = 1 - m_e c^2 (1/E_absorber - 1/(E_scatter + E_absorber))
+/// in [-1, 1]. The scatter angle and incident energy of the first
+/// matching pair are accounted.
+///
+/// An event is accepted when any condition is fulfilled, or when no
+/// condition is defined. The accept counters of each condition, and the
+/// sum of the weights of the accepted events, are added to the Run of
+/// this thread (see RunAction).
+///
+/// A layer set is "all", a material name, or a list of layer numbers
+/// separated by commas; the sets are resolved at the beginning of each
+/// run. One trigger per thread, owned by the RunAction, configured by its
+/// TriggerMessenger.
+
+class CoincidenceTrigger
+{
+  public:
+    struct Condition {
+      G4String name;
+      G4String scatterSet;
+      G4String absorberSet;
+      G4double scatterMin = 0.;
+      G4double scatterMax = DBL_MAX;
+      G4double absorberMin = 0.;
+      G4double absorberMax = DBL_MAX;
+      G4double totalMin = 0.;
+      G4double totalMax = DBL_MAX;
+      G4double timeWindow = DBL_MAX;
+      G4bool compton = true;  // require allowed kinematics
+
+      std::vector<G4int> scatterLayers;  // resolved sets
+      std::vector<G4int> absorberLayers;
+    };
+
+    CoincidenceTrigger();
+    ~CoincidenceTrigger();
+
+    CoincidenceTrigger(const CoincidenceTrigger&) = delete;
+    CoincidenceTrigger& operator=(const CoincidenceTrigger&) = delete;
+
+    // Configuration; the conditions are found by name
+    void AddCondition(const G4String& name, const G4String& scatterSet,
+                      const G4String& absorberSet);
+    void ClearConditions() { fConditions.clear(); }
+    Condition* GetCondition(const G4String& name);
+    const std::vector<Condition>& GetConditions() const { return fConditions; }
+
+    void BeginOfRun();
+    G4bool Accept(const TrackerHitsCollection& hits, Run* run, G4double weight);
+    G4bool Accept(const PixelHitsCollection& pixels, Run* run, G4double weight);
+
+  private:
+    void Resolve(const G4String& set, std::vector<G4int>& layers) const;
+    void Clear();
+    void AddDeposit(G4int layer, G4double edep, G4double time);
+    G4bool Evaluate(Run* run, G4double weight);
+
+    std::vector<Condition> fConditions;
+
+    // Deposits of the event per layer
+    std::vector<G4double> fLayerEdep;
+    std::vector<G4double> fLayerTime;
+    std::vector<G4int> fTouched;
+
+    TriggerMessenger* fMessenger = nullptr;
+};
+
+}  // namespace B2a
+
+#endif
@@ -30,25 +30,49 @@
 #include "DetectorConstruction.hh"
 
 #include "DetectorMessenger.hh"
+#include "FieldSetup.hh"
+#include "LayerParameterisation.hh"
+#include "OverlapValidator.hh"
+#include "StartupProfiler.hh"
+#include "TargetShowerModel.hh"
 #include "TrackerSD.hh"
 
 #include "G4AutoDelete.hh"
 #include "G4Box.hh"
 #include "G4Colour.hh"
+#include "G4FieldManager.hh"
 #include "G4GeometryManager.hh"
 #include "G4GeometryTolerance.hh"
 #include "G4GlobalMagFieldMessenger.hh"
 #include "G4LogicalVolume.hh"
+#include "G4LogicalVolumeStore.hh"
 #include "G4Material.hh"
 #include "G4NistManager.hh"
+#include "G4PVParameterised.hh"
 #include "G4PVPlacement.hh"
+#include "G4PhysicalVolumeStore.hh"
+#include "G4ProductionCuts.hh"
+#include "G4ProductionCutsTable.hh"
+#include "G4Region.hh"
+#include "G4RegionStore.hh"
+#include "G4RunManager.hh"
 #include "G4SDManager.hh"
+#include "G4SolidStore.hh"
+#include "G4StateManager.hh"
 #include "G4SystemOfUnits.hh"
+#include "G4Threading.hh"
+#include "G4TransportationManager.hh"
 #include "G4Tubs.hh"
+#include "G4UnitsTable.hh"
 #include "G4UserLimits.hh"
 #include "G4VisAttributes.hh"
 
-using namespace B2;
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <map>
+#include <sstream>
 
 namespace B2a
 {
@@ -56,21 +80,25 @@ namespace B2a
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 G4ThreadLocal G4GlobalMagFieldMessenger* DetectorConstruction::fMagFieldMessenger = nullptr;
+G4ThreadLocal TargetShowerModel* DetectorConstruction::fShowerModel = nullptr;
+G4ThreadLocal FieldSetup* DetectorConstruction::fFieldSetup = nullptr;
 
 DetectorConstruction::DetectorConstruction()
 {
   fMessenger = new DetectorMessenger(this);
+  fOverlapValidator = new OverlapValidator;
 
-  fNbOfChambers = 5;
-  fLogicChamber = new G4LogicalVolume*[fNbOfChambers];
+  // Default stack: one Si scatterer followed by one CZT absorber
+  fLayers = {{"G4_Si", 20. * cm}, {"G4_CADMIUM_TELLURIDE", 20. * cm}};
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 DetectorConstruction::~DetectorConstruction()
 {
-  delete[] fLogicChamber;
-  delete fStepLimit;
+  for (auto param : fLayerParams) delete param;
+  for (const auto& entry : fRegionLimits) delete entry.second;
+  delete fOverlapValidator;
   delete fMessenger;
 }
 
@@ -78,11 +106,45 @@ DetectorConstruction::~DetectorConstruction()
 
 G4VPhysicalVolume* DetectorConstruction::Construct()
 {
+  // Clean old geometry, if any (the stack is rebuilt when its
+  // description changes between runs); the regions survive, so their old
+  // root volumes are removed first
+  G4GeometryManager::GetInstance()->OpenGeometry();
+  for (const auto& entry : fRegionLimits) {
+    auto region = G4RegionStore::GetInstance()->GetRegion(entry.first, false);
+    if (!region) continue;
+    std::vector<G4LogicalVolume*> rootLVs(region->GetRootLogicalVolumeIterator(),
+                                          region->GetRootLogicalVolumeIterator()
+                                            + region->GetNumberOfRootVolumes());
+    for (auto rootLV : rootLVs) {
+      region->RemoveRootLogicalVolume(rootLV, false);
+    }
+  }
+  G4PhysicalVolumeStore::GetInstance()->Clean();
+  G4LogicalVolumeStore::GetInstance()->Clean();
+  G4SolidStore::GetInstance()->Clean();
+
   // Define materials
-  DefineMaterials();
+  {
+    StartupProfiler::Scope scope("materials");
+    DefineMaterials();
+  }
 
   // Define volumes
-  return DefineVolumes();
+  G4VPhysicalVolume* world = nullptr;
+  {
+    StartupProfiler::Scope scope("geometry");
+    world = DefineVolumes();
+  }
+
+  // Check overlaps once the tree is complete, in parallel, and only if
+  // this geometry was not validated before
+  if (fCheckOverlaps) {
+    StartupProfiler::Scope scope("overlap check");
+    fOverlapValidator->Validate(world);
+  }
+
+  return world;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -97,19 +159,15 @@ void DetectorConstruction::DefineMaterials()
   nistManager->FindOrBuildMaterial("G4_AIR");
 
   // Lead defined using NIST Manager
-  fTargetMaterial = nistManager->FindOrBuildMaterial("G4_Pb");
-
-  // Xenon gas defined using NIST Manager
-  fChamberMaterial = nistManager->FindOrBuildMaterial("G4_Xe");
+  if (!fTargetMaterial) fTargetMaterial = nistManager->FindOrBuildMaterial("G4_Pb");
 
-  //Si
-  fChamberMaterial = nistManager->FindOrBuildMaterial("G4_Si");
-
-  //CZT
-  fChamberMaterial = nistManager->FindOrBuildMaterial("G4_CADMIUM_TELLURIDE");
+  // Layer materials (Si, CZT by default) defined using NIST Manager
+  for (const auto& layer : fLayers) {
+    nistManager->FindOrBuildMaterial(layer.material);
+  }
 
   // Print materials
-  G4cout << *(G4Material::GetMaterialTable()) << G4endl;
+  if (fVerboseLevel > 0) G4cout << *(G4Material::GetMaterialTable()) << G4endl;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -120,19 +178,32 @@ G4VPhysicalVolume* DetectorConstruction::DefineVolumes()
 
   // Sizes of the principal geometrical components (solids)
 
-  G4double chamberSpacing = 80 * cm;  // from chamber center to center!
+  auto nbOfLayers = (G4int)fLayers.size();
 
-  G4double chamberWidth = 20.0 * cm;  // width of the chambers
-  G4double targetLength = 5.0 * cm;  // full length of Target
+  G4double maxThickness = 0.;
+  for (const auto& layer : fLayers) {
+    maxThickness = std::max(maxThickness, layer.thickness);
+  }
 
-  G4double trackerLength = (fNbOfChambers + 1) * chamberSpacing;
+  G4double targetLength = 5.0 * cm;  // full length of Target
 
-  G4double worldLength = 1.2 * (2 * targetLength + trackerLength);
+  G4double trackerLength = (nbOfLayers + 1) * fLayerPitch;
 
   G4double targetRadius = 0.5 * targetLength;  // Radius of Target
   targetLength = 0.5 * targetLength;  // Half length of the Target
   G4double trackerSize = 0.5 * trackerLength;  // Half length of the Tracker
 
+  // The tracker must contain the corners of the (square) layers
+  G4double trackerRadius = std::max(trackerSize, 1.05 * std::sqrt(2.) * 0.5 * fLayerWidth);
+
+  G4double worldLength =
+    1.2 * std::max(2 * (2 * targetLength) + trackerLength, 2 * trackerRadius);
+
+  if (fLayerPitch < maxThickness) {
+    G4Exception("DetectorConstruction::DefineVolumes()", "InvalidSetup", FatalException,
+                "Width>Spacing");
+  }
+
   // Definitions of Solids, Logical Volumes, Physical Volumes
 
   // World
@@ -157,11 +228,12 @@ G4VPhysicalVolume* DetectorConstruction::DefineVolumes()
                                    nullptr,  // its mother  volume
                                    false,  // no boolean operations
                                    0,  // copy number
-                                   fCheckOverlaps);  // checking overlaps
+                                   false);  // overlaps: see Construct()
 
   // Target
 
   G4ThreeVector positionTarget = G4ThreeVector(0, 0, -(targetLength + trackerSize));
+  fTargetExtent = {positionTarget.z() - targetLength, positionTarget.z() + targetLength};
 
   auto targetS = new G4Tubs("target", 0., targetRadius, targetLength, 0. * deg, 360. * deg);
   fLogicTarget = new G4LogicalVolume(targetS, fTargetMaterial, "Target", nullptr, nullptr, nullptr);
@@ -172,7 +244,7 @@ G4VPhysicalVolume* DetectorConstruction::DefineVolumes()
                     worldLV,  // its mother volume
                     false,  // no boolean operations
                     0,  // copy number
-                    fCheckOverlaps);  // checking overlaps
+                    false);  // overlaps: see Construct()
 
   G4cout << "Target is " << 2 * targetLength / cm << " cm of " << fTargetMaterial->GetName()
          << G4endl;
@@ -181,8 +253,9 @@ G4VPhysicalVolume* DetectorConstruction::DefineVolumes()
 
   G4ThreeVector positionTracker = G4ThreeVector(0, 0, 0);
 
-  auto trackerS = new G4Tubs("tracker", 0, trackerSize, trackerSize, 0. * deg, 360. * deg);
+  auto trackerS = new G4Tubs("tracker", 0, trackerRadius, trackerSize, 0. * deg, 360. * deg);
   auto trackerLV = new G4LogicalVolume(trackerS, air, "Tracker", nullptr, nullptr, nullptr);
+  fLogicTracker = trackerLV;
   new G4PVPlacement(nullptr,  // no rotation
                     positionTracker,  // at (x,y,z)
                     trackerLV,  // its logical volume
@@ -190,7 +263,7 @@ G4VPhysicalVolume* DetectorConstruction::DefineVolumes()
                     worldLV,  // its mother  volume
                     false,  // no boolean operations
                     0,  // copy number
-                    fCheckOverlaps);  // checking overlaps
+                    false);  // overlaps: see Construct()
 
   // Visualization attributes
 
@@ -201,86 +274,117 @@ G4VPhysicalVolume* DetectorConstruction::DefineVolumes()
   fLogicTarget->SetVisAttributes(boxVisAtt);
   trackerLV->SetVisAttributes(boxVisAtt);
 
-  // Tracker segments
-
-  // Tính toán các thông số chung
-  G4double firstPosition = -trackerSize + chamberSpacing; // Vị trí z khối đầu tiên
-  G4double rmaxFirst = 0.5 * trackerLength / 10;         // Bán kính khối đầu tiên
-  G4double rmaxIncr = 0.5 * trackerLength / (fNbOfChambers - 1); // Tăng bán kính giữa các khối
-
-  if (chamberSpacing < chamberWidth) {
-      G4Exception("DetectorConstruction::DefineVolumes()", "InvalidSetup", FatalException,
-          "Width>Spacing");
-  }
-
-  // Tạo vật liệu cho khối 1 và khối 2
-  G4Material* materialSi = G4Material::GetMaterial("G4_Si");  // Vật liệu Silicon
-  G4Material* materialCZT = G4Material::GetMaterial("G4_CADMIUM_TELLURIDE"); // Vật liệu CZT
-
-  // Tạo khối đầu tiên (Si)
-  G4double Zposition1 = firstPosition; // Vị trí z của khối đầu tiên
-  G4double halfLength1 = rmaxFirst;   // Chiều dài (half) = bán kính
-  G4double halfWidth1 = rmaxFirst;    // Chiều rộng (half) = bán kính
-  G4double halfHeight1 = 0.5 * chamberWidth; // Chiều cao (half)
-
-  auto chamberS1 = new G4Box("Chamber1_solid", halfLength1, halfWidth1, halfHeight1);
-
-  fLogicChamber[0] =
-      new G4LogicalVolume(chamberS1, materialSi, "Chamber_LV", nullptr, nullptr, nullptr);
-
-  fLogicChamber[0]->SetVisAttributes(chamberVisAtt);
-
-  new G4PVPlacement(nullptr,
-      G4ThreeVector(0, 0, Zposition1),
-      fLogicChamber[0],
-      "Chamber1_PV",
-      trackerLV,
-      false,
-      0,
-      fCheckOverlaps);
-
-  // Tạo khối thứ hai (CZT)
-  G4double Zposition2 = firstPosition + chamberSpacing; // Vị trí z của khối thứ hai
-  G4double rmax2 = rmaxFirst + rmaxIncr;                // Bán kính khối thứ hai
-  G4double halfLength2 = rmax2;
-  G4double halfWidth2 = rmax2;
-  G4double halfHeight2 = 0.5 * chamberWidth;
+  // Tracker segments: the layer stack
+  //
+  // There is one "Chamber_LV" logical volume per material. Consecutive
+  // layers of the same material form a block: an air envelope holding a
+  // single G4PVParameterised along z, so that the navigation inside a block
+  // uses 1D smart voxels and does not depend on the number of layers.
+  // The envelope copy number is the index of its first layer, hence the
+  // layer index of a hit is copyNo(0) + copyNo(1).
+  //
+  // A stack alternating materials, Si/CZT say, thus has one block of one
+  // layer per layer: N envelopes in the tracker (still navigated with the
+  // smart voxels of the tracker) and twice the boundaries to cross. One
+  // G4PVParameterised computing the material per layer is not used: the
+  // sensor regions and the in-place material swaps (MaterialsModified())
+  // need one logical volume per material. layers.mac measures both stacks.
+
+  for (auto param : fLayerParams) delete param;
+  fLayerParams.clear();
+  fLogicChamber.clear();
+  fLayerLV.clear();
+  fLayerExtents.clear();
+  ++fReadoutVersion;
+
+  G4double halfWidth = 0.5 * fLayerWidth;
+
+  std::map<G4String, G4LogicalVolume*> chamberLVs;
+  std::vector<G4LogicalVolume*> airLVs = {trackerLV};
+  G4double firstPosition = -trackerSize + fLayerPitch;  // z of the first layer
+
+  G4int first = 0;
+  while (first < nbOfLayers) {
+    const auto& material = fLayers[first].material;
+    G4int last = first;
+    while (last + 1 < nbOfLayers && fLayers[last + 1].material == material) ++last;
+
+    auto& chamberLV = chamberLVs[material];
+    if (!chamberLV) {
+      // dimensions are set per copy by the parameterisation
+      auto layerS = new G4Box("Chamber_solid", halfWidth, halfWidth, 0.5 * maxThickness);
+      chamberLV = new G4LogicalVolume(layerS, G4Material::GetMaterial(material), "Chamber_LV",
+                                      nullptr, nullptr, nullptr);
+      chamberLV->SetVisAttributes(chamberVisAtt);
+      fLogicChamber.push_back(chamberLV);
+    }
+    fLayerLV.insert(fLayerLV.end(), last - first + 1, chamberLV);
 
-  auto chamberS2 = new G4Box("Chamber2_solid", halfLength2, halfWidth2, halfHeight2);
+    // block extent along z
+    G4double zmin = firstPosition + first * fLayerPitch - 0.5 * fLayers[first].thickness;
+    G4double zmax = firstPosition + last * fLayerPitch + 0.5 * fLayers[last].thickness;
+    G4double zcentre = 0.5 * (zmin + zmax);
 
-  fLogicChamber[1] =
-      new G4LogicalVolume(chamberS2, materialCZT, "Chamber_LV", nullptr, nullptr, nullptr);
+    std::vector<G4double> zPositions;
+    std::vector<G4double> halfThicknesses;
+    for (G4int i = first; i <= last; ++i) {
+      zPositions.push_back(firstPosition + i * fLayerPitch - zcentre);
+      halfThicknesses.push_back(0.5 * fLayers[i].thickness);
 
-  fLogicChamber[1]->SetVisAttributes(chamberVisAtt);
+      G4double z = positionTracker.z() + firstPosition + i * fLayerPitch;
+      fLayerExtents.push_back({z - halfThicknesses.back(), z + halfThicknesses.back()});
+    }
 
-  new G4PVPlacement(nullptr,
-      G4ThreeVector(0, 0, Zposition2),
-      fLogicChamber[1],
-      "Chamber2_PV",
-      trackerLV,
-      false,
-      1,
-      fCheckOverlaps);
+    auto blockS = new G4Box("Block_solid", halfWidth, halfWidth, 0.5 * (zmax - zmin));
+    auto blockLV = new G4LogicalVolume(blockS, air, "Block_LV", nullptr, nullptr, nullptr);
+    blockLV->SetVisAttributes(G4VisAttributes::GetInvisible());
+    airLVs.push_back(blockLV);
+    new G4PVPlacement(nullptr,  // no rotation
+                      G4ThreeVector(0, 0, zcentre),  // at (x,y,z)
+                      blockLV,  // its logical volume
+                      "Block_PV",  // its name
+                      trackerLV,  // its mother  volume
+                      false,  // no boolean operations
+                      first,  // copy number = index of the first layer
+                      false);  // overlaps: see Construct()
+
+    auto layerParam = new LayerParameterisation(halfWidth, zPositions, halfThicknesses);
+    fLayerParams.push_back(layerParam);
+    new G4PVParameterised("Chamber_PV",  // its name
+                          chamberLV,  // its logical volume
+                          blockLV,  // its mother volume
+                          kZAxis,  // layers are placed along z
+                          last - first + 1,  // number of layers in this block
+                          layerParam,  // the parameterisation
+                          false);  // overlaps: see Construct()
+
+    first = last + 1;
+  }
 
+  G4cout << "There are " << nbOfLayers << " layers in the tracker region, "
+         << fLogicChamber.size() << " materials" << G4endl << "The distance between layers is "
+         << fLayerPitch / cm << " cm" << G4endl;
 
-  // Example of User Limits
+  // Regions
   //
-  // Below is an example of how to set tracking constraints in a given
-  // logical volume
+  // "Target", "Air" (the Tracker and the block envelopes) and one
+  // "Sensor_<material>" region per layer material. Each region has its own
+  // production cuts and its own user limits: max step (G4StepLimiter),
+  // kinetic energy and track time kill thresholds (G4UserSpecialCuts).
+  // The World stays in the default region, whose cuts are set with
+  // /run/setCut, without user limits.
   //
-  // Sets a max step length in the tracker region, with G4StepLimiter
+  // The limits objects are shared read-only by all workers; they are only
+  // modified by the region setters on the master between runs.
 
-  G4double maxStep = 0.5 * chamberWidth;
-  fStepLimit = new G4UserLimits(maxStep);
-  trackerLV->SetUserLimits(fStepLimit);
+  // By default the tracker max step is half the chamber width
+  fDefaultAirStepMax = 0.5 * maxThickness;
 
-  /// Set additional contraints on the track, with G4UserSpecialCuts
-  ///
-  /// G4double maxLength = 2*trackerLength, maxTime = 0.1*ns, minEkin = 10*MeV;
-  /// trackerLV->SetUserLimits(new G4UserLimits(maxStep,
-  ///                                           maxLength,
-  ///                                           maxTime,
-  ///                                           minEkin));
+  SetupRegion("Target", fLogicTarget, {fLogicTarget});
+  SetupRegion("Air", trackerLV, airLVs);
+  for (auto chamberLV : fLogicChamber) {
+    SetupRegion(SensorRegionName(chamberLV), chamberLV, {chamberLV});
+  }
 
   // Always return the physical world
 
@@ -291,15 +395,40 @@ G4VPhysicalVolume* DetectorConstruction::DefineVolumes()
 
 void DetectorConstruction::ConstructSDandField()
 {
+  StartupProfiler::Scope scope("SD and field");
+
   // Sensitive detectors
+  // (called again on each worker when the geometry is rebuilt: the SD is
+  // kept and only re-attached to the new logical volumes)
 
   G4String trackerChamberSDname = "/TrackerChamberSD";
-  auto trackerSD = new TrackerSD(trackerChamberSDname, "TrackerHitsCollection");
-  G4SDManager::GetSDMpointer()->AddNewDetector(trackerSD);
+  auto trackerSD = G4SDManager::GetSDMpointer()->FindSensitiveDetector(trackerChamberSDname, false);
+  if (!trackerSD) {
+    trackerSD =
+      new TrackerSD(trackerChamberSDname, "TrackerHitsCollection", "PixelHitsCollection");
+    G4SDManager::GetSDMpointer()->AddNewDetector(trackerSD);
+  }
   // Setting trackerSD to all logical volumes with the same name
   // of "Chamber_LV".
   SetSensitiveDetector("Chamber_LV", trackerSD, true);
-  //SetSensitiveDetector("Chamber2_LV", trackerSD, true);
+
+  // Shower parameterisation in the "Target" region (the region, and so
+  // the model, survives the geometry rebuilds); off unless enabled
+  if (fFastSimAvailable && !fShowerModel) {
+    auto targetRegion = G4RegionStore::GetInstance()->GetRegion("Target", false);
+    fShowerModel = new TargetShowerModel("TargetShowerModel", targetRegion, &fShowerParameters);
+    G4AutoDelete::Register(fShowerModel);
+  }
+
+  // Field of the tracker, field map or uniform, rebuilt each time as its
+  // parameters may have changed
+  if (!fFieldSetup) {
+    fFieldSetup = new FieldSetup(&fFieldParameters, &fFieldMap);
+    G4AutoDelete::Register(fFieldSetup);
+  }
+  fFieldSetup->Configure(fLogicTracker);
+
+  if (fMagFieldMessenger) return;
 
   // Create global magnetic field messenger.
   // Uniform magnetic field is then created automatically if
@@ -316,6 +445,8 @@ void DetectorConstruction::ConstructSDandField()
 
 void DetectorConstruction::SetTargetMaterial(G4String materialName)
 {
+  if (!G4Threading::IsMasterThread()) return;
+
   G4NistManager* nistManager = G4NistManager::Instance();
 
   G4Material* pttoMaterial = nistManager->FindOrBuildMaterial(materialName);
@@ -337,41 +468,450 @@ void DetectorConstruction::SetTargetMaterial(G4String materialName)
 
 void DetectorConstruction::SetChamberMaterial(G4String materialName)
 {
+    if (!G4Threading::IsMasterThread()) return;
+
     G4NistManager* nistManager = G4NistManager::Instance();
 
     // Tìm và tạo vật liệu từ tên
     G4Material* pttoMaterial = nistManager->FindOrBuildMaterial(materialName);
 
-    if (fChamberMaterial != pttoMaterial) {
-        if (pttoMaterial) {
-            fChamberMaterial = pttoMaterial;  // Cập nhật vật liệu cho buồng mới
+    if (pttoMaterial) {
+        // Cập nhật vật liệu cho tất cả các lớp
+        for (auto& layer : fLayers) {
+            layer.material = materialName;
+        }
+        MaterialsModified();
 
-            // Cập nhật vật liệu cho từng buồng (nếu chỉ có 2 buồng)
-            if (fLogicChamber[0]) {
-                fLogicChamber[0]->SetMaterial(fChamberMaterial);  // Cập nhật vật liệu cho buồng 1
-            }
+        // Thông báo vật liệu mới
+        G4cout << G4endl << "----> The chambers are now made of " << materialName << G4endl;
+    }
+    else {
+        // Thông báo khi không tìm thấy vật liệu
+        G4cout << G4endl << "-->  WARNING from SetChamberMaterial : " << materialName << " not found"
+            << G4endl;
+    }
+}
 
-            if (fLogicChamber[1]) {
-                fLogicChamber[1]->SetMaterial(fChamberMaterial);  // Cập nhật vật liệu cho buồng 2
-            }
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-            // Thông báo vật liệu mới
-            G4cout << G4endl << "----> The chambers are now made of " << materialName << G4endl;
-        }
-        else {
-            // Thông báo khi không tìm thấy vật liệu
-            G4cout << G4endl << "-->  WARNING from SetChamberMaterial : " << materialName << " not found"
-                << G4endl;
-        }
+void DetectorConstruction::SetNbOfLayers(G4int nbOfLayers)
+{
+  if (!G4Threading::IsMasterThread()) return;
+
+  if (nbOfLayers < 1) {
+    G4cout << G4endl << "-->  WARNING from SetNbOfLayers : " << nbOfLayers
+           << " is not a valid number of layers" << G4endl;
+    return;
+  }
+
+  // New layers repeat the description of the last one
+  fLayers.resize(nbOfLayers, fLayers.back());
+  StackModified();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::SetLayerPitch(G4double pitch)
+{
+  if (!G4Threading::IsMasterThread()) return;
+
+  for (const auto& layer : fLayers) {
+    if (layer.thickness > pitch) {
+      G4cout << G4endl << "-->  WARNING from SetLayerPitch : " << G4BestUnit(pitch, "Length")
+             << " is smaller than a layer thickness" << G4endl;
+      return;
+    }
+  }
+
+  fLayerPitch = pitch;
+  StackModified();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::SetLayerWidth(G4double width)
+{
+  if (!G4Threading::IsMasterThread()) return;
+
+  if (width <= 0.) return;
+
+  fLayerWidth = width;
+  StackModified();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::SetNbOfPixels(G4int nofPixels)
+{
+  if (!G4Threading::IsMasterThread()) return;
+
+  if (nofPixels < 0) return;
+
+  fNbOfPixels = nofPixels;
+  ++fReadoutVersion;
+  if (fNbOfPixels == 0) {
+    G4cout << G4endl << "----> Tracker readout: one hit per step" << G4endl;
+    return;
+  }
+
+  // edep and time per cell, in each thread
+  G4double memory = 16. * fLayers.size() * fNbOfPixels * fNbOfPixels / 1048576.;
+  G4cout << G4endl << "----> Tracker readout: " << fNbOfPixels << " x " << fNbOfPixels
+         << " pixels of " << G4BestUnit(fLayerWidth / fNbOfPixels, "Length") << " per layer, "
+         << memory << " MB per thread" << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::SetLayerImportance(G4int index, G4double importance)
+{
+  if (!G4Threading::IsMasterThread()) return;
+
+  if (index < 0 || index >= (G4int)fLayers.size() || importance <= 0.) {
+    G4cout << G4endl << "-->  WARNING from SetLayerImportance : no layer " << index
+           << " or importance " << importance << " not positive" << G4endl;
+    return;
+  }
+  fLayers[index].importance = importance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::SetImportanceRatio(G4double ratio)
+{
+  if (!G4Threading::IsMasterThread()) return;
+
+  if (ratio <= 0.) return;
+
+  G4double importance = 1.;
+  for (auto& layer : fLayers) {
+    importance *= ratio;
+    layer.importance = importance;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::SetLayerThickness(G4double thickness)
+{
+  if (!G4Threading::IsMasterThread()) return;
+
+  if (thickness <= 0. || thickness > fLayerPitch) {
+    G4cout << G4endl << "-->  WARNING from SetLayerThickness : "
+           << G4BestUnit(thickness, "Length") << " does not fit the layer pitch" << G4endl;
+    return;
+  }
+
+  for (auto& layer : fLayers) {
+    layer.thickness = thickness;
+  }
+  StackModified();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::SetLayer(G4int index, G4String materialName, G4double thickness)
+{
+  if (!G4Threading::IsMasterThread()) return;
+
+  if (index < 0 || index >= (G4int)fLayers.size()) {
+    G4cout << G4endl << "-->  WARNING from SetLayer : no layer " << index << G4endl;
+    return;
+  }
+  if (!G4NistManager::Instance()->FindOrBuildMaterial(materialName)) {
+    G4cout << G4endl << "-->  WARNING from SetLayer : " << materialName << " not found"
+           << G4endl;
+    return;
+  }
+  if (thickness <= 0. || thickness > fLayerPitch) {
+    G4cout << G4endl << "-->  WARNING from SetLayer : " << G4BestUnit(thickness, "Length")
+           << " does not fit the layer pitch" << G4endl;
+    return;
+  }
+
+  G4bool sameThickness = (fLayers[index].thickness == thickness);
+  fLayers[index].material = materialName;
+  fLayers[index].thickness = thickness;
+  if (sameThickness) {
+    MaterialsModified();
+  }
+  else {
+    StackModified();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::vector<G4int> DetectorConstruction::GetLayerSet(const G4String& set) const
+{
+  auto nofLayers = (G4int)fLayers.size();
+  std::vector<G4int> layers;
+  if (set == "all") {
+    for (G4int i = 0; i < nofLayers; ++i) layers.push_back(i);
+    return layers;
+  }
+
+  if (set.find_first_not_of("0123456789,") == std::string::npos) {
+    std::istringstream is(set);
+    std::string token;
+    while (std::getline(is, token, ',')) {
+      if (token.empty()) continue;
+      errno = 0;
+      long layer = std::strtol(token.c_str(), nullptr, 10);
+      if (errno == 0 && layer < nofLayers) {
+        layers.push_back(G4int(layer));
+        continue;
+      }
+      G4ExceptionDescription msg;
+      msg << "Layer set \"" << set << "\": no layer " << token << " in a stack of " << nofLayers
+          << " layers, ignored";
+      G4Exception("DetectorConstruction::GetLayerSet()", "B2aLayer001", JustWarning, msg);
     }
+    return layers;
+  }
+
+  for (G4int i = 0; i < nofLayers; ++i) {
+    if (fLayers[i].material == set) layers.push_back(i);
+  }
+  return layers;
 }
 
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool DetectorConstruction::HasField() const
+{
+  auto fieldManager = G4TransportationManager::GetTransportationManager()->GetFieldManager();
+  if (fieldManager && fieldManager->GetDetectorField()) return true;
+
+  // the field manager of the tracker is thread-local
+  fieldManager = fLogicTracker ? fLogicTracker->GetFieldManager() : nullptr;
+  return fieldManager && fieldManager->GetDetectorField();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::StackModified()
+{
+  // Before initialisation the new description is simply picked up by
+  // Construct(); afterwards the geometry is rebuilt at the next run.
+  if (G4StateManager::GetStateManager()->GetCurrentState() == G4State_Idle) {
+    G4RunManager::GetRunManager()->ReinitializeGeometry();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::MaterialsModified()
+{
+  if (G4StateManager::GetStateManager()->GetCurrentState() != G4State_Idle) return;
+
+  // The materials can be swapped in place, without rebuilding the geometry,
+  // as long as all the layers of each chamber logical volume still share
+  // one material. The material-cuts couples, and the physics tables of the
+  // new couples only, are then updated by the kernel at the next run.
+  std::map<G4LogicalVolume*, G4String> newMaterials;
+  G4bool inPlace = (fLayerLV.size() == fLayers.size());
+  for (std::size_t i = 0; inPlace && i < fLayers.size(); ++i) {
+    auto entry = newMaterials.emplace(fLayerLV[i], fLayers[i].material);
+    inPlace = (entry.first->second == fLayers[i].material);
+  }
+
+  if (!inPlace) {
+    StackModified();
+    return;
+  }
+
+  for (const auto& entry : newMaterials) {
+    auto chamberLV = entry.first;
+    chamberLV->SetMaterial(G4Material::GetMaterial(entry.second));
+
+    // move the volume to the region of its new material
+    auto region = chamberLV->GetRegion();
+    if (region && region->GetName() != SensorRegionName(chamberLV)) {
+      region->RemoveRootLogicalVolume(chamberLV);
+      SetupRegion(SensorRegionName(chamberLV), chamberLV, {chamberLV});
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4String DetectorConstruction::SensorRegionName(const G4LogicalVolume* chamberLV) const
+{
+  return "Sensor_" + chamberLV->GetMaterial()->GetName();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::SetupRegion(const G4String& name, G4LogicalVolume* rootLV,
+                                       const std::vector<G4LogicalVolume*>& limitedLVs)
+{
+  auto region = G4RegionStore::GetInstance()->FindOrCreateRegion(name);
+  region->AddRootLogicalVolume(rootLV);
+
+  auto& limits = fRegionLimits[name];
+  if (!limits) limits = new G4UserLimits();
+  for (auto lv : limitedLVs) {
+    lv->SetUserLimits(limits);
+  }
+
+  ApplyRegionSettings(name);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::ApplyRegionSettings(const G4String& name)
+{
+  const auto& settings = fRegionSettings[name];
+
+  auto region = G4RegionStore::GetInstance()->GetRegion(name, false);
+  if (region && settings.cut > 0.) {
+    auto cuts = region->GetProductionCuts();
+    auto defaultCuts = G4ProductionCutsTable::GetProductionCutsTable()->GetDefaultProductionCuts();
+    if (!cuts || cuts == defaultCuts) {
+      cuts = new G4ProductionCuts();
+      region->SetProductionCuts(cuts);
+    }
+    cuts->SetProductionCut(settings.cut);
+  }
+
+  auto limits = fRegionLimits.find(name);
+  if (limits != fRegionLimits.end()) {
+    G4double stepMax = settings.stepMax;
+    if (stepMax <= 0.) stepMax = (name == "Air") ? fDefaultAirStepMax : DBL_MAX;
+    limits->second->SetMaxAllowedStep(stepMax);
+    limits->second->SetUserMinEkine(settings.minEkin);
+    limits->second->SetUserMaxTime(settings.maxTime);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::SetRegionCut(const G4String& name, G4double cut)
+{
+  if (!G4Threading::IsMasterThread() || cut <= 0.) return;
+
+  fRegionSettings[name].cut = cut;
+  ApplyRegionSettings(name);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::SetRegionStepMax(const G4String& name, G4double stepMax)
+{
+  if (!G4Threading::IsMasterThread() || stepMax <= 0.) return;
+
+  fRegionSettings[name].stepMax = stepMax;
+  ApplyRegionSettings(name);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::SetRegionMinEkin(const G4String& name, G4double minEkin)
+{
+  if (!G4Threading::IsMasterThread() || minEkin < 0.) return;
+
+  fRegionSettings[name].minEkin = minEkin;
+  ApplyRegionSettings(name);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::SetRegionMaxTime(const G4String& name, G4double maxTime)
+{
+  if (!G4Threading::IsMasterThread() || maxTime <= 0.) return;
+
+  fRegionSettings[name].maxTime = maxTime;
+  ApplyRegionSettings(name);
+}
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 void DetectorConstruction::SetMaxStep(G4double maxStep)
 {
-  if ((fStepLimit) && (maxStep > 0.)) fStepLimit->SetMaxAllowedStep(maxStep);
+  // step max in the tracker, i.e. the "Air" region
+  SetRegionStepMax("Air", maxStep);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool DetectorConstruction::ShowerModifiable() const
+{
+  // The shower parameters are read by the models of all threads during
+  // the runs: they only change on the master, before or between runs
+  if (!G4Threading::IsMasterThread()) return false;
+
+  auto state = G4StateManager::GetStateManager()->GetCurrentState();
+  return state == G4State_PreInit || state == G4State_Idle;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::SetFastSim(G4bool enabled)
+{
+  if (!ShowerModifiable()) return;
+
+  if (enabled && !fFastSimAvailable) {
+    G4Exception("DetectorConstruction::SetFastSim()", "B2aFastSim001", JustWarning,
+                "The fast simulation physics is not registered: start the job with --fast-sim");
+    return;
+  }
+
+  fShowerParameters.enabled = enabled;
+  G4cout << G4endl << "----> Target shower parameterisation " << (enabled ? "on" : "off")
+         << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::SetFastSimThreshold(G4double threshold)
+{
+  if (!ShowerModifiable()) return;
+
+  fShowerParameters.threshold = threshold;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::SetFastSimLeakageScale(G4double scale)
+{
+  if (!ShowerModifiable()) return;
+
+  fShowerParameters.leakageScale = scale;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::SetFastSimSpectrumSlope(G4double slope)
+{
+  if (!ShowerModifiable()) return;
+
+  fShowerParameters.spectrumSlope = slope;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::SetFieldMap(const G4String& fileName)
+{
+  if (!G4Threading::IsMasterThread()) return;
+
+  if (fileName == "none") {
+    fFieldMap = FieldMap();
+  }
+  else if (!fFieldMap.Load(fileName)) {
+    return;  // the previous map, if any, is kept
+  }
+  StackModified();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::SetFieldParameters(const FieldParameters& parameters)
+{
+  if (!G4Threading::IsMasterThread()) return;
+
+  fFieldParameters = parameters;
+  StackModified();
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -383,4 +923,32 @@ void DetectorConstruction::SetCheckOverlaps(G4bool checkOverlaps)
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-}  // namespace B2a
\ No newline at end of file
+void DetectorConstruction::SetOverlapResolution(G4int resolution)
+{
+  fOverlapValidator->SetResolution(resolution);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::SetOverlapThreads(G4int nofThreads)
+{
+  fOverlapValidator->SetNbOfThreads(nofThreads);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::SetOverlapCacheFile(const G4String& fileName)
+{
+  fOverlapValidator->SetCacheFile(fileName);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::SetVerboseLevel(G4int verboseLevel)
+{
+  fVerboseLevel = verboseLevel;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}  // namespace B2a
@@ -1,39 +1,191 @@
 ﻿#ifndef DETECTOR_CONSTRUCTION_HH
 #define DETECTOR_CONSTRUCTION_HH
 
+#include "CLHEP/Units/SystemOfUnits.h"
+#include "FieldMap.hh"
+#include "FieldSetup.hh"
 #include "G4VUserDetectorConstruction.hh"
-#include "G4LogicalVolume.hh"
-#include "G4Material.hh"
+#include "TargetShowerModel.hh"
 #include "globals.hh"
 
+#include <map>
+#include <vector>
+
+class G4GlobalMagFieldMessenger;
+class G4LogicalVolume;
+class G4Material;
+class G4UserLimits;
+class G4VPhysicalVolume;
+class G4VPVParameterisation;
+
 namespace B2a { // Bao namespace nếu cần
 
+    class DetectorMessenger;
+    class OverlapValidator;
+
     // Lớp DetectorConstruction kế thừa từ G4VUserDetectorConstruction
+    //
+    // In MT/tasking mode a single instance is shared by all threads:
+    // Construct() and the setters run on the master only (the /B2/det/
+    // commands are not broadcast), while ConstructSDandField() runs once
+    // per worker and must only touch thread-local state.
     class DetectorConstruction : public G4VUserDetectorConstruction {
     public:
+        // z extent of a layer or of the target in the world frame
+        struct LayerExtent {
+            G4double zMin;
+            G4double zMax;
+        };
+
         DetectorConstruction();  // Constructor
-        virtual ~DetectorConstruction(); // Destructor
+        ~DetectorConstruction() override; // Destructor
+
+        G4VPhysicalVolume* Construct() override; // Hàm xây dựng hình học
+        void ConstructSDandField() override;
+
+        // Setters, master thread only, PreInit or Idle state
+        void SetTargetMaterial(G4String);
+        void SetChamberMaterial(G4String);  // all layers
+        void SetMaxStep(G4double);  // in the "Air" region
+        void SetCheckOverlaps(G4bool);  // validate the geometry after construction
+        void SetOverlapResolution(G4int);  // points per surface
+        void SetOverlapThreads(G4int);  // 0: all the cores
+        void SetOverlapCacheFile(const G4String&);  // empty: no cache
+        void SetVerboseLevel(G4int);  // > 0: print the material table
+
+        // Per-region production cuts and user limits, applied immediately
+        // if the region exists, else when it is created
+        void SetRegionCut(const G4String& region, G4double cut);
+        void SetRegionStepMax(const G4String& region, G4double stepMax);
+        void SetRegionMinEkin(const G4String& region, G4double minEkin);
+        void SetRegionMaxTime(const G4String& region, G4double maxTime);
+
+        // Layer stack description; changes in Idle state rebuild the
+        // geometry at the next run
+        void SetNbOfLayers(G4int);
+        void SetLayerPitch(G4double);  // centre to centre distance
+        void SetLayerWidth(G4double);  // transverse full size
+        void SetLayerThickness(G4double);  // all layers
+        void SetLayer(G4int index, G4String material, G4double thickness);
+
+        G4int GetNbOfLayers() const { return (G4int)fLayers.size(); }
+        const G4String& GetLayerMaterial(G4int index) const { return fLayers[index].material; }
+
+        // Layers of a set: "all", a material name, or layer numbers
+        // separated by commas (used by the trigger and the histograms)
+        std::vector<G4int> GetLayerSet(const G4String& set) const;
+
+        // Pixelated readout: n x n pixels per layer, 0 for one hit per
+        // step (see TrackerSD); read by the SD of all threads
+        void SetNbOfPixels(G4int);
+        G4int GetNbOfPixels() const { return fNbOfPixels; }
+
+        // Incremented when the readout grid changes: the stack is rebuilt
+        // or the number of pixels set (the SD then rebuilds its grid)
+        G4int GetReadoutVersion() const { return fReadoutVersion; }
+
+        // Geometry importance of each layer (see ImportanceSampler), 1 by
+        // default; read by the stepping of all threads, applied at the
+        // next run without rebuilding the geometry
+        void SetLayerImportance(G4int index, G4double importance);
+        void SetImportanceRatio(G4double ratio);  // layer i: ratio^(i+1)
+        G4double GetLayerImportance(G4int index) const { return fLayers[index].importance; }
 
-        virtual G4VPhysicalVolume* Construct(); // Hàm xây dựng hình học
+        // Layer geometry of the current stack, ordered along z. It is cached
+        // by Construct() on the master, and the setters only change it
+        // before or between runs: during a run the layer layout (extents,
+        // sets, importances, readout) is read without a lock by the
+        // sensitive detector, the scorers and the filters of all threads.
+        const std::vector<LayerExtent>& GetLayerExtents() const { return fLayerExtents; }
+        G4double GetLayerHalfWidth() const { return 0.5 * fLayerWidth; }
+        const LayerExtent& GetTargetExtent() const { return fTargetExtent; }
 
-        // Thêm các hàm getter để truy cập các thuộc tính private (nếu cần)
-        G4LogicalVolume* GetLogicSi() const { return fLogicSi; }
-        G4LogicalVolume* GetLogicCZT() const { return fLogicCZT; }
+        // A magnetic field bends the tracks on this thread: the global
+        // field or that of the tracker (see FieldSetup)
+        G4bool HasField() const;
 
-        // Setter (nếu cần thêm logic thiết lập)
-        void SetCheckOverlaps(G4bool value) { fCheckOverlaps = value; }
-        void SetMaxStep(G4double maxStep); // Chỉ khai báo, không định nghĩa
+        // Shower parameterisation in the target (see TargetShowerModel);
+        // only available when the fast simulation physics is registered
+        // (exampleB2a --fast-sim)
+        void SetFastSimAvailable(G4bool available) { fFastSimAvailable = available; }
+        G4bool IsFastSimAvailable() const { return fFastSimAvailable; }
+        void SetFastSim(G4bool);
+        void SetFastSimThreshold(G4double);
+        void SetFastSimLeakageScale(G4double);
+        void SetFastSimSpectrumSlope(G4double);
+        G4bool IsFastSim() const { return fShowerParameters.enabled; }
+
+        // Magnetic field of the tracker (see FieldSetup): a field map,
+        // loaded here once and read by the fields of all threads, or a
+        // uniform field; "none" unloads the map. The field is rebuilt
+        // with the geometry, so changes in Idle state apply at the next run.
+        void SetFieldMap(const G4String& fileName);
+        void SetFieldParameters(const FieldParameters&);
+        const FieldParameters& GetFieldParameters() const { return fFieldParameters; }
+        const FieldMap& GetFieldMap() const { return fFieldMap; }
 
     private:
+        struct Layer {
+            G4String material;
+            G4double thickness;
+            G4double importance = 1.;
+        };
+
+        struct RegionSettings {
+            G4double cut = -1.;  // production cut, <= 0: default cuts
+            G4double stepMax = -1.;  // <= 0: no limit (Air: half a layer)
+            G4double minEkin = 0.;
+            G4double maxTime = DBL_MAX;
+        };
+
         void DefineMaterials(); // Hàm định nghĩa vật liệu
+        G4VPhysicalVolume* DefineVolumes();
+        void StackModified();
+        void MaterialsModified();
+        G4bool ShowerModifiable() const;  // master, between runs
 
-        G4Material* fSiMaterial;  // Vật liệu Silicon
-        G4Material* fCZTMaterial; // Vật liệu Cadmium Zinc Telluride
-        G4LogicalVolume* fLogicSi; // Logical Volume của Si
-        G4LogicalVolume* fLogicCZT; // Logical Volume của CZT
-        G4bool fCheckOverlaps = true; // Cờ kiểm tra chồng lấn, mặc định là true
+        G4String SensorRegionName(const G4LogicalVolume* chamberLV) const;
+        void SetupRegion(const G4String& name, G4LogicalVolume* rootLV,
+                         const std::vector<G4LogicalVolume*>& limitedLVs);
+        void ApplyRegionSettings(const G4String& name);
+
+        // Per-thread: each worker owns its fields, field messenger and
+        // fast simulation model
+        static G4ThreadLocal G4GlobalMagFieldMessenger* fMagFieldMessenger;
+        static G4ThreadLocal TargetShowerModel* fShowerModel;
+        static G4ThreadLocal FieldSetup* fFieldSetup;
+
+        // Shared (master-owned) geometry description
+        std::vector<Layer> fLayers;  // index = layer (copy) number
+        G4double fLayerPitch = 80. * CLHEP::cm;
+        G4double fLayerWidth = 48. * CLHEP::cm;
+        G4int fNbOfPixels = 0;
+        G4int fReadoutVersion = 0;
 
-        G4double fMaxStep;  // Biến lưu trữ giá trị bước tối đa
+        G4LogicalVolume* fLogicTarget = nullptr;  // logical Target
+        G4LogicalVolume* fLogicTracker = nullptr;  // logical Tracker
+        std::vector<G4LogicalVolume*> fLogicChamber;  // one per layer material
+        std::vector<G4LogicalVolume*> fLayerLV;  // logical volume of each layer
+        std::vector<G4VPVParameterisation*> fLayerParams;  // one per block
+        std::vector<LayerExtent> fLayerExtents;  // one per layer
+        LayerExtent fTargetExtent{0., 0.};
+
+        G4Material* fTargetMaterial = nullptr;  // target material
+
+        ShowerParameters fShowerParameters;  // read by the models of all threads
+        G4bool fFastSimAvailable = false;
+        FieldParameters fFieldParameters;  // read by the field setups of all threads
+        FieldMap fFieldMap;  // shared read-only by the fields of all threads
+
+        std::map<G4String, RegionSettings> fRegionSettings;
+        std::map<G4String, G4UserLimits*> fRegionLimits;  // one per region
+        G4double fDefaultAirStepMax = DBL_MAX;
+
+        DetectorMessenger* fMessenger = nullptr;
+        OverlapValidator* fOverlapValidator = nullptr;
+
+        G4bool fCheckOverlaps = true; // Cờ kiểm tra chồng lấn, mặc định là true
+        G4int fVerboseLevel = 1;
     };
 
 } // namespace B2a
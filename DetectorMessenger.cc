@@ -1,10 +1,18 @@
 #include "DetectorMessenger.hh"
 
 #include "DetectorConstruction.hh"
+#include "FieldSetup.hh"
 
+#include "G4UIcmdWith3VectorAndUnit.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithADouble.hh"
 #include "G4UIcmdWithADoubleAndUnit.hh"
 #include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithAnInteger.hh"
 #include "G4UIdirectory.hh"
+#include "G4UIparameter.hh"
+
+#include <sstream>
 
 namespace B2a
 {
@@ -25,12 +33,14 @@ namespace B2a
         fTargMatCmd->SetGuidance("Select Material of the Target.");
         fTargMatCmd->SetParameterName("choice", false);
         fTargMatCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+        fTargMatCmd->SetToBeBroadcasted(false);
 
         // L?nh thay ??i v?t li?u phng th nghi?m
         fChamMatCmd = new G4UIcmdWithAString("/B2/det/setChamberMaterial", this);
         fChamMatCmd->SetGuidance("Select Material of the Chamber.");
         fChamMatCmd->SetParameterName("choice", false);
         fChamMatCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+        fChamMatCmd->SetToBeBroadcasted(false);
 
         // L?nh thay ??i b??c t?i ?a
         fStepMaxCmd = new G4UIcmdWithADoubleAndUnit("/B2/det/stepMax", this);
@@ -38,6 +48,268 @@ namespace B2a
         fStepMaxCmd->SetParameterName("stepMax", false);
         fStepMaxCmd->SetUnitCategory("Length");
         fStepMaxCmd->AvailableForStates(G4State_Idle);
+        fStepMaxCmd->SetToBeBroadcasted(false);
+
+        // Layer stack commands
+        fNbLayersCmd = new G4UIcmdWithAnInteger("/B2/det/setNbOfLayers", this);
+        fNbLayersCmd->SetGuidance("Set the number of layers of the stack.");
+        fNbLayersCmd->SetGuidance("New layers repeat the last layer description.");
+        fNbLayersCmd->SetParameterName("nbOfLayers", false);
+        fNbLayersCmd->SetRange("nbOfLayers>0");
+        fNbLayersCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+        fNbLayersCmd->SetToBeBroadcasted(false);
+
+        fLayerPitchCmd = new G4UIcmdWithADoubleAndUnit("/B2/det/setLayerPitch", this);
+        fLayerPitchCmd->SetGuidance("Set the distance between layer centres.");
+        fLayerPitchCmd->SetParameterName("pitch", false);
+        fLayerPitchCmd->SetUnitCategory("Length");
+        fLayerPitchCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+        fLayerPitchCmd->SetToBeBroadcasted(false);
+
+        fLayerWidthCmd = new G4UIcmdWithADoubleAndUnit("/B2/det/setLayerWidth", this);
+        fLayerWidthCmd->SetGuidance("Set the transverse (full) size of the layers.");
+        fLayerWidthCmd->SetParameterName("width", false);
+        fLayerWidthCmd->SetUnitCategory("Length");
+        fLayerWidthCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+        fLayerWidthCmd->SetToBeBroadcasted(false);
+
+        fLayerThickCmd = new G4UIcmdWithADoubleAndUnit("/B2/det/setLayerThickness", this);
+        fLayerThickCmd->SetGuidance("Set the thickness of all layers.");
+        fLayerThickCmd->SetParameterName("thickness", false);
+        fLayerThickCmd->SetUnitCategory("Length");
+        fLayerThickCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+        fLayerThickCmd->SetToBeBroadcasted(false);
+
+        fLayerCmd = new G4UIcommand("/B2/det/setLayer", this);
+        fLayerCmd->SetGuidance("Set material and thickness of one layer.");
+        auto indexPrm = new G4UIparameter("index", 'i', false);
+        indexPrm->SetParameterRange("index>=0");
+        fLayerCmd->SetParameter(indexPrm);
+        fLayerCmd->SetParameter(new G4UIparameter("material", 's', false));
+        auto thickPrm = new G4UIparameter("thickness", 'd', false);
+        thickPrm->SetParameterRange("thickness>0.");
+        fLayerCmd->SetParameter(thickPrm);
+        auto unitPrm = new G4UIparameter("unit", 's', true);
+        unitPrm->SetDefaultUnit("mm");
+        fLayerCmd->SetParameter(unitPrm);
+        fLayerCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+        fLayerCmd->SetToBeBroadcasted(false);
+
+        fPixelsCmd = new G4UIcmdWithAnInteger("/B2/det/setPixels", this);
+        fPixelsCmd->SetGuidance("Pixelated readout: n x n pixels per layer.");
+        fPixelsCmd->SetGuidance("The deposits are summed per pixel and event, one hit");
+        fPixelsCmd->SetGuidance("per non-empty pixel. 0 (default): one hit per step.");
+        fPixelsCmd->SetParameterName("n", false);
+        fPixelsCmd->SetRange("n>=0");
+        fPixelsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+        fPixelsCmd->SetToBeBroadcasted(false);
+
+        // Importance sampling along the stack (see ImportanceSampler)
+        fImportanceDirectory = new G4UIdirectory("/B2/det/importance/");
+        fImportanceDirectory->SetGuidance("Geometry importance of the layers: tracks are");
+        fImportanceDirectory->SetGuidance("split or played Russian roulette when they cross");
+        fImportanceDirectory->SetGuidance("into a layer of different importance. A layer cell");
+        fImportanceDirectory->SetGuidance("extends to the next layer; upstream of the first");
+        fImportanceDirectory->SetGuidance("one the importance is 1.");
+
+        fImportanceCmd = new G4UIcommand("/B2/det/importance/set", this);
+        fImportanceCmd->SetGuidance("Set the importance of one layer.");
+        auto layerPrm = new G4UIparameter("index", 'i', false);
+        layerPrm->SetParameterRange("index>=0");
+        fImportanceCmd->SetParameter(layerPrm);
+        auto importancePrm = new G4UIparameter("value", 'd', false);
+        importancePrm->SetParameterRange("value>0.");
+        fImportanceCmd->SetParameter(importancePrm);
+        fImportanceCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+        fImportanceCmd->SetToBeBroadcasted(false);
+
+        fImportanceRatioCmd = new G4UIcmdWithADouble("/B2/det/importance/ratio", this);
+        fImportanceRatioCmd->SetGuidance("Set the importance of layer i to ratio^(i+1), 1 for no");
+        fImportanceRatioCmd->SetGuidance("importance sampling.");
+        fImportanceRatioCmd->SetParameterName("ratio", false);
+        fImportanceRatioCmd->SetRange("ratio>0.");
+        fImportanceRatioCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+        fImportanceRatioCmd->SetToBeBroadcasted(false);
+
+        // Region commands: region name, value and unit
+        fRegionDirectory = new G4UIdirectory("/B2/det/region/");
+        fRegionDirectory->SetGuidance("Production cuts and user limits per region.");
+        fRegionDirectory->SetGuidance("Regions: Target, Air, Sensor_<material>");
+
+        auto makeRegionCmd = [this](const char* name, const char* guidance,
+                                    const char* defaultUnit) {
+            auto cmd = new G4UIcommand(name, this);
+            cmd->SetGuidance(guidance);
+            cmd->SetParameter(new G4UIparameter("region", 's', false));
+            auto valuePrm = new G4UIparameter("value", 'd', false);
+            valuePrm->SetParameterRange("value>=0.");
+            cmd->SetParameter(valuePrm);
+            auto unitPrm = new G4UIparameter("unit", 's', true);
+            unitPrm->SetDefaultUnit(defaultUnit);
+            cmd->SetParameter(unitPrm);
+            cmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+            cmd->SetToBeBroadcasted(false);
+            return cmd;
+        };
+        fRegionCutCmd = makeRegionCmd("/B2/det/region/setCut",
+            "Set the production cut (all particles) of a region.", "mm");
+        fRegionStepMaxCmd = makeRegionCmd("/B2/det/region/setStepMax",
+            "Set the max step of a region.", "mm");
+        fRegionMinEkinCmd = makeRegionCmd("/B2/det/region/setMinEkin",
+            "Kill tracks below this kinetic energy in a region.", "MeV");
+        fRegionMaxTimeCmd = makeRegionCmd("/B2/det/region/setMaxTime",
+            "Kill tracks beyond this global time in a region.", "ns");
+
+        // Geometry validation, see OverlapValidator
+        fCheckOverlapsCmd = new G4UIcmdWithABool("/B2/det/checkOverlaps", this);
+        fCheckOverlapsCmd->SetGuidance("Check the overlaps of the geometry after its construction.");
+        fCheckOverlapsCmd->SetGuidance("Takes effect at the next geometry construction.");
+        fCheckOverlapsCmd->SetParameterName("check", true);
+        fCheckOverlapsCmd->SetDefaultValue(true);
+        fCheckOverlapsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+        fCheckOverlapsCmd->SetToBeBroadcasted(false);
+
+        fOverlapResCmd = new G4UIcmdWithAnInteger("/B2/det/overlapResolution", this);
+        fOverlapResCmd->SetGuidance("Number of surface points checked per volume.");
+        fOverlapResCmd->SetParameterName("nofPoints", false);
+        fOverlapResCmd->SetRange("nofPoints>0");
+        fOverlapResCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+        fOverlapResCmd->SetToBeBroadcasted(false);
+
+        fOverlapThreadsCmd = new G4UIcmdWithAnInteger("/B2/det/overlapThreads", this);
+        fOverlapThreadsCmd->SetGuidance("Number of threads checking the overlaps (0: all cores).");
+        fOverlapThreadsCmd->SetParameterName("nofThreads", false);
+        fOverlapThreadsCmd->SetRange("nofThreads>=0");
+        fOverlapThreadsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+        fOverlapThreadsCmd->SetToBeBroadcasted(false);
+
+        fOverlapCacheCmd = new G4UIcmdWithAString("/B2/det/overlapCache", this);
+        fOverlapCacheCmd->SetGuidance("File caching the overlap verdicts per geometry.");
+        fOverlapCacheCmd->SetGuidance("An empty name disables the cache.");
+        fOverlapCacheCmd->SetParameterName("name", true);
+        fOverlapCacheCmd->SetDefaultValue("");
+        fOverlapCacheCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+        fOverlapCacheCmd->SetToBeBroadcasted(false);
+
+        // Shower parameterisation in the target
+        fFastSimDirectory = new G4UIdirectory("/B2/det/fastSim/");
+        fFastSimDirectory->SetGuidance("Shower parameterisation in the target.");
+
+        fFastSimCmd = new G4UIcmdWithABool("/B2/det/fastSim/enable", this);
+        fFastSimCmd->SetGuidance("Replace the e-, e+, gamma showers in the target by their leakage.");
+        fFastSimCmd->SetParameterName("enabled", true);
+        fFastSimCmd->SetDefaultValue(true);
+        fFastSimCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+        fFastSimCmd->SetToBeBroadcasted(false);
+
+        fFastSimThresholdCmd = new G4UIcmdWithADoubleAndUnit("/B2/det/fastSim/threshold", this);
+        fFastSimThresholdCmd->SetGuidance("Minimum kinetic energy of the parameterised particles.");
+        fFastSimThresholdCmd->SetParameterName("energy", false);
+        fFastSimThresholdCmd->SetRange("energy>0.");
+        fFastSimThresholdCmd->SetUnitCategory("Energy");
+        fFastSimThresholdCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+        fFastSimThresholdCmd->SetToBeBroadcasted(false);
+
+        fFastSimScaleCmd = new G4UIcmdWithADouble("/B2/det/fastSim/leakageScale", this);
+        fFastSimScaleCmd->SetGuidance("Scale factor of the leaked energy (tuning).");
+        fFastSimScaleCmd->SetParameterName("scale", false);
+        fFastSimScaleCmd->SetRange("scale>=0.");
+        fFastSimScaleCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+        fFastSimScaleCmd->SetToBeBroadcasted(false);
+
+        fFastSimSlopeCmd = new G4UIcmdWithADouble("/B2/det/fastSim/spectrumSlope", this);
+        fFastSimSlopeCmd->SetGuidance("Slope of the leaked spectrum, dN/dE ~ E^-slope (tuning).");
+        fFastSimSlopeCmd->SetParameterName("slope", false);
+        fFastSimSlopeCmd->SetRange("slope>1.");
+        fFastSimSlopeCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+        fFastSimSlopeCmd->SetToBeBroadcasted(false);
+
+        // Magnetic field of the tracker
+        fFieldDirectory = new G4UIdirectory("/B2/det/field/");
+        fFieldDirectory->SetGuidance("Magnetic field of the tracker (field map or uniform).");
+        fFieldDirectory->SetGuidance("Changes in Idle state apply at the next run.");
+
+        fFieldMapCmd = new G4UIcmdWithAString("/B2/det/field/map", this);
+        fFieldMapCmd->SetGuidance("Load a field map, shared by all the threads (none: unload).");
+        fFieldMapCmd->SetGuidance("Text file: nx ny nz, xmin xmax ymin ymax zmin zmax [mm],");
+        fFieldMapCmd->SetGuidance("then Bx By Bz [tesla] per node, x fastest, then y, then z.");
+        fFieldMapCmd->SetParameterName("fileName", false);
+        fFieldMapCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+        fFieldMapCmd->SetToBeBroadcasted(false);
+
+        fFieldUniformCmd = new G4UIcmdWith3VectorAndUnit("/B2/det/field/setUniform", this);
+        fFieldUniformCmd->SetGuidance("Uniform field in the tracker, used when no map is loaded.");
+        fFieldUniformCmd->SetParameterName("Bx", "By", "Bz", false);
+        fFieldUniformCmd->SetUnitCategory("Magnetic flux density");
+        fFieldUniformCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+        fFieldUniformCmd->SetToBeBroadcasted(false);
+
+        fFieldStepperCmd = new G4UIcmdWithAString("/B2/det/field/stepper", this);
+        fFieldStepperCmd->SetGuidance("Integration stepper of the tracker field.");
+        fFieldStepperCmd->SetParameterName("stepper", false);
+        fFieldStepperCmd->SetCandidates(FieldSetup::GetStepperNames());
+        fFieldStepperCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+        fFieldStepperCmd->SetToBeBroadcasted(false);
+
+        fFieldMinStepCmd = new G4UIcmdWithADoubleAndUnit("/B2/det/field/minStep", this);
+        fFieldMinStepCmd->SetGuidance("Minimum step of the chord finder.");
+        fFieldMinStepCmd->SetParameterName("step", false);
+        fFieldMinStepCmd->SetRange("step>0.");
+        fFieldMinStepCmd->SetUnitCategory("Length");
+        fFieldMinStepCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+        fFieldMinStepCmd->SetToBeBroadcasted(false);
+
+        fFieldDeltaChordCmd = new G4UIcmdWithADoubleAndUnit("/B2/det/field/deltaChord", this);
+        fFieldDeltaChordCmd->SetGuidance("Maximum miss distance of the chords.");
+        fFieldDeltaChordCmd->SetParameterName("delta", false);
+        fFieldDeltaChordCmd->SetRange("delta>0.");
+        fFieldDeltaChordCmd->SetUnitCategory("Length");
+        fFieldDeltaChordCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+        fFieldDeltaChordCmd->SetToBeBroadcasted(false);
+
+        fFieldDeltaIntersectionCmd =
+            new G4UIcmdWithADoubleAndUnit("/B2/det/field/deltaIntersection", this);
+        fFieldDeltaIntersectionCmd->SetGuidance("Accuracy of the boundary intersections.");
+        fFieldDeltaIntersectionCmd->SetParameterName("delta", false);
+        fFieldDeltaIntersectionCmd->SetRange("delta>0.");
+        fFieldDeltaIntersectionCmd->SetUnitCategory("Length");
+        fFieldDeltaIntersectionCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+        fFieldDeltaIntersectionCmd->SetToBeBroadcasted(false);
+
+        fFieldDeltaOneStepCmd = new G4UIcmdWithADoubleAndUnit("/B2/det/field/deltaOneStep", this);
+        fFieldDeltaOneStepCmd->SetGuidance("Accuracy of the end point of a step.");
+        fFieldDeltaOneStepCmd->SetParameterName("delta", false);
+        fFieldDeltaOneStepCmd->SetRange("delta>0.");
+        fFieldDeltaOneStepCmd->SetUnitCategory("Length");
+        fFieldDeltaOneStepCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+        fFieldDeltaOneStepCmd->SetToBeBroadcasted(false);
+
+        fFieldEpsilonCmd = new G4UIcommand("/B2/det/field/epsilonStep", this);
+        fFieldEpsilonCmd->SetGuidance("Minimum and maximum relative accuracy of a step.");
+        auto minEpsilonPrm = new G4UIparameter("min", 'd', false);
+        minEpsilonPrm->SetParameterRange("min>0.");
+        fFieldEpsilonCmd->SetParameter(minEpsilonPrm);
+        auto maxEpsilonPrm = new G4UIparameter("max", 'd', false);
+        maxEpsilonPrm->SetParameterRange("max>0.");
+        fFieldEpsilonCmd->SetParameter(maxEpsilonPrm);
+        fFieldEpsilonCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+        fFieldEpsilonCmd->SetToBeBroadcasted(false);
+
+        fFieldLargestStepCmd = new G4UIcmdWithADoubleAndUnit("/B2/det/field/largestStep", this);
+        fFieldLargestStepCmd->SetGuidance("Largest step of the propagator in field.");
+        fFieldLargestStepCmd->SetParameterName("step", false);
+        fFieldLargestStepCmd->SetRange("step>0.");
+        fFieldLargestStepCmd->SetUnitCategory("Length");
+        fFieldLargestStepCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+        fFieldLargestStepCmd->SetToBeBroadcasted(false);
+
+        fVerboseCmd = new G4UIcmdWithAnInteger("/B2/det/verbose", this);
+        fVerboseCmd->SetGuidance("Set the verbose level of the detector construction.");
+        fVerboseCmd->SetGuidance(" 0: quiet, 1: print the material table");
+        fVerboseCmd->SetParameterName("level", false);
+        fVerboseCmd->SetRange("level>=0");
+        fVerboseCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+        fVerboseCmd->SetToBeBroadcasted(false);
     }
 
     //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -48,6 +320,40 @@ namespace B2a
         delete fTargMatCmd;
         delete fChamMatCmd;
         delete fStepMaxCmd;
+        delete fNbLayersCmd;
+        delete fLayerPitchCmd;
+        delete fLayerWidthCmd;
+        delete fLayerThickCmd;
+        delete fLayerCmd;
+        delete fPixelsCmd;
+        delete fImportanceCmd;
+        delete fImportanceRatioCmd;
+        delete fImportanceDirectory;
+        delete fRegionCutCmd;
+        delete fRegionStepMaxCmd;
+        delete fRegionMinEkinCmd;
+        delete fRegionMaxTimeCmd;
+        delete fCheckOverlapsCmd;
+        delete fOverlapResCmd;
+        delete fOverlapThreadsCmd;
+        delete fOverlapCacheCmd;
+        delete fFastSimCmd;
+        delete fFastSimThresholdCmd;
+        delete fFastSimScaleCmd;
+        delete fFastSimSlopeCmd;
+        delete fFastSimDirectory;
+        delete fFieldMapCmd;
+        delete fFieldUniformCmd;
+        delete fFieldStepperCmd;
+        delete fFieldMinStepCmd;
+        delete fFieldDeltaChordCmd;
+        delete fFieldDeltaIntersectionCmd;
+        delete fFieldDeltaOneStepCmd;
+        delete fFieldEpsilonCmd;
+        delete fFieldLargestStepCmd;
+        delete fFieldDirectory;
+        delete fVerboseCmd;
+        delete fRegionDirectory;
         delete fDirectory;
         delete fDetDirectory;
     }
@@ -70,6 +376,146 @@ namespace B2a
         if (command == fStepMaxCmd) {
             fDetectorConstruction->SetMaxStep(fStepMaxCmd->GetNewDoubleValue(newValue));
         }
+
+        if (command == fNbLayersCmd) {
+            fDetectorConstruction->SetNbOfLayers(fNbLayersCmd->GetNewIntValue(newValue));
+        }
+
+        if (command == fLayerPitchCmd) {
+            fDetectorConstruction->SetLayerPitch(fLayerPitchCmd->GetNewDoubleValue(newValue));
+        }
+
+        if (command == fLayerWidthCmd) {
+            fDetectorConstruction->SetLayerWidth(fLayerWidthCmd->GetNewDoubleValue(newValue));
+        }
+
+        if (command == fLayerThickCmd) {
+            fDetectorConstruction->SetLayerThickness(fLayerThickCmd->GetNewDoubleValue(newValue));
+        }
+
+        if (command == fLayerCmd) {
+            G4int index = 0;
+            G4String material, unit;
+            G4double thickness = 0.;
+            std::istringstream is(newValue);
+            is >> index >> material >> thickness >> unit;
+            thickness *= G4UIcommand::ValueOf(unit);
+            fDetectorConstruction->SetLayer(index, material, thickness);
+        }
+
+        if (command == fPixelsCmd) {
+            fDetectorConstruction->SetNbOfPixels(fPixelsCmd->GetNewIntValue(newValue));
+        }
+
+        if (command == fImportanceCmd) {
+            G4int index = 0;
+            G4double importance = 1.;
+            std::istringstream is(newValue);
+            is >> index >> importance;
+            fDetectorConstruction->SetLayerImportance(index, importance);
+        }
+
+        if (command == fImportanceRatioCmd) {
+            fDetectorConstruction->SetImportanceRatio(
+                fImportanceRatioCmd->GetNewDoubleValue(newValue));
+        }
+
+        if (command == fRegionCutCmd || command == fRegionStepMaxCmd
+            || command == fRegionMinEkinCmd || command == fRegionMaxTimeCmd) {
+            G4String region, unit;
+            G4double value = 0.;
+            std::istringstream is(newValue);
+            is >> region >> value >> unit;
+            value *= G4UIcommand::ValueOf(unit);
+            if (command == fRegionCutCmd) {
+                fDetectorConstruction->SetRegionCut(region, value);
+            }
+            else if (command == fRegionStepMaxCmd) {
+                fDetectorConstruction->SetRegionStepMax(region, value);
+            }
+            else if (command == fRegionMinEkinCmd) {
+                fDetectorConstruction->SetRegionMinEkin(region, value);
+            }
+            else {
+                fDetectorConstruction->SetRegionMaxTime(region, value);
+            }
+        }
+
+        if (command == fCheckOverlapsCmd) {
+            fDetectorConstruction->SetCheckOverlaps(fCheckOverlapsCmd->GetNewBoolValue(newValue));
+        }
+
+        if (command == fOverlapResCmd) {
+            fDetectorConstruction->SetOverlapResolution(fOverlapResCmd->GetNewIntValue(newValue));
+        }
+
+        if (command == fOverlapThreadsCmd) {
+            fDetectorConstruction->SetOverlapThreads(fOverlapThreadsCmd->GetNewIntValue(newValue));
+        }
+
+        if (command == fOverlapCacheCmd) {
+            fDetectorConstruction->SetOverlapCacheFile(newValue);
+        }
+
+        if (command == fFastSimCmd) {
+            fDetectorConstruction->SetFastSim(fFastSimCmd->GetNewBoolValue(newValue));
+        }
+
+        if (command == fFastSimThresholdCmd) {
+            fDetectorConstruction->SetFastSimThreshold(
+                fFastSimThresholdCmd->GetNewDoubleValue(newValue));
+        }
+
+        if (command == fFastSimScaleCmd) {
+            fDetectorConstruction->SetFastSimLeakageScale(fFastSimScaleCmd->GetNewDoubleValue(newValue));
+        }
+
+        if (command == fFastSimSlopeCmd) {
+            fDetectorConstruction->SetFastSimSpectrumSlope(fFastSimSlopeCmd->GetNewDoubleValue(newValue));
+        }
+
+        if (command == fVerboseCmd) {
+            fDetectorConstruction->SetVerboseLevel(fVerboseCmd->GetNewIntValue(newValue));
+        }
+
+        if (command == fFieldMapCmd) {
+            fDetectorConstruction->SetFieldMap(newValue);
+        }
+
+        // The other field settings are changed on a copy, set at once
+        auto field = fDetectorConstruction->GetFieldParameters();
+        G4bool fieldModified = true;
+        if (command == fFieldUniformCmd) {
+            field.uniform = fFieldUniformCmd->GetNew3VectorValue(newValue);
+        }
+        else if (command == fFieldStepperCmd) {
+            field.stepper = newValue;
+        }
+        else if (command == fFieldMinStepCmd) {
+            field.minStep = fFieldMinStepCmd->GetNewDoubleValue(newValue);
+        }
+        else if (command == fFieldDeltaChordCmd) {
+            field.deltaChord = fFieldDeltaChordCmd->GetNewDoubleValue(newValue);
+        }
+        else if (command == fFieldDeltaIntersectionCmd) {
+            field.deltaIntersection = fFieldDeltaIntersectionCmd->GetNewDoubleValue(newValue);
+        }
+        else if (command == fFieldDeltaOneStepCmd) {
+            field.deltaOneStep = fFieldDeltaOneStepCmd->GetNewDoubleValue(newValue);
+        }
+        else if (command == fFieldEpsilonCmd) {
+            std::istringstream is(newValue);
+            is >> field.minEpsilonStep >> field.maxEpsilonStep;
+        }
+        else if (command == fFieldLargestStepCmd) {
+            field.largestStep = fFieldLargestStepCmd->GetNewDoubleValue(newValue);
+        }
+        else {
+            fieldModified = false;
+        }
+        if (fieldModified) {
+            fDetectorConstruction->SetFieldParameters(field);
+        }
     }
 
     //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -5,7 +5,11 @@
 
 class G4UIdirectory;
 class G4UIcmdWithAString;
+class G4UIcmdWithADouble;
 class G4UIcmdWithADoubleAndUnit;
+class G4UIcmdWithAnInteger;
+class G4UIcmdWithABool;
+class G4UIcmdWith3VectorAndUnit;
 class G4UIcommand;
 
 namespace B2a
@@ -19,6 +23,39 @@ namespace B2a
     /// - /B2/det/setTargetMaterial name
     /// - /B2/det/setChamberMaterial name
     /// - /B2/det/stepMax value unit
+    /// - /B2/det/setNbOfLayers n
+    /// - /B2/det/setLayerPitch value unit
+    /// - /B2/det/setLayerWidth value unit
+    /// - /B2/det/setLayerThickness value unit
+    /// - /B2/det/setLayer index material thickness unit
+    /// - /B2/det/setPixels n
+    /// - /B2/det/importance/set index value
+    /// - /B2/det/importance/ratio value
+    /// - /B2/det/region/setCut region value unit
+    /// - /B2/det/region/setStepMax region value unit
+    /// - /B2/det/region/setMinEkin region value unit
+    /// - /B2/det/region/setMaxTime region value unit
+    /// - /B2/det/checkOverlaps true|false
+    /// - /B2/det/overlapResolution n
+    /// - /B2/det/overlapThreads n
+    /// - /B2/det/overlapCache name
+    /// - /B2/det/fastSim/enable true|false
+    /// - /B2/det/fastSim/threshold value unit
+    /// - /B2/det/fastSim/leakageScale value
+    /// - /B2/det/fastSim/spectrumSlope value
+    /// - /B2/det/field/map name|none
+    /// - /B2/det/field/setUniform Bx By Bz unit
+    /// - /B2/det/field/stepper name
+    /// - /B2/det/field/minStep value unit
+    /// - /B2/det/field/deltaChord value unit
+    /// - /B2/det/field/deltaIntersection value unit
+    /// - /B2/det/field/deltaOneStep value unit
+    /// - /B2/det/field/epsilonStep min max
+    /// - /B2/det/field/largestStep value unit
+    /// - /B2/det/verbose level
+    ///
+    /// The detector construction lives on the master thread only, so none
+    /// of these commands is broadcast to the workers.
 
     class DetectorMessenger : public G4UImessenger
     {
@@ -38,6 +75,46 @@ namespace B2a
         G4UIcmdWithAString* fChamMatCmd = nullptr;  // Command to set chamber material
         G4UIcmdWithADoubleAndUnit* fStepMaxCmd = nullptr; // Command to set step max
 
+        G4UIcmdWithAnInteger* fNbLayersCmd = nullptr;
+        G4UIcmdWithADoubleAndUnit* fLayerPitchCmd = nullptr;
+        G4UIcmdWithADoubleAndUnit* fLayerWidthCmd = nullptr;
+        G4UIcmdWithADoubleAndUnit* fLayerThickCmd = nullptr;
+        G4UIcommand* fLayerCmd = nullptr;
+        G4UIcmdWithAnInteger* fPixelsCmd = nullptr;
+
+        G4UIdirectory* fImportanceDirectory = nullptr;
+        G4UIcommand* fImportanceCmd = nullptr;
+        G4UIcmdWithADouble* fImportanceRatioCmd = nullptr;
+
+        G4UIdirectory* fRegionDirectory = nullptr;
+        G4UIcommand* fRegionCutCmd = nullptr;
+        G4UIcommand* fRegionStepMaxCmd = nullptr;
+        G4UIcommand* fRegionMinEkinCmd = nullptr;
+        G4UIcommand* fRegionMaxTimeCmd = nullptr;
+
+        G4UIcmdWithABool* fCheckOverlapsCmd = nullptr;
+        G4UIcmdWithAnInteger* fOverlapResCmd = nullptr;
+        G4UIcmdWithAnInteger* fOverlapThreadsCmd = nullptr;
+        G4UIcmdWithAString* fOverlapCacheCmd = nullptr;
+
+        G4UIdirectory* fFastSimDirectory = nullptr;
+        G4UIcmdWithABool* fFastSimCmd = nullptr;
+        G4UIcmdWithADoubleAndUnit* fFastSimThresholdCmd = nullptr;
+        G4UIcmdWithADouble* fFastSimScaleCmd = nullptr;
+        G4UIcmdWithADouble* fFastSimSlopeCmd = nullptr;
+
+        G4UIdirectory* fFieldDirectory = nullptr;
+        G4UIcmdWithAString* fFieldMapCmd = nullptr;
+        G4UIcmdWith3VectorAndUnit* fFieldUniformCmd = nullptr;
+        G4UIcmdWithAString* fFieldStepperCmd = nullptr;
+        G4UIcmdWithADoubleAndUnit* fFieldMinStepCmd = nullptr;
+        G4UIcmdWithADoubleAndUnit* fFieldDeltaChordCmd = nullptr;
+        G4UIcmdWithADoubleAndUnit* fFieldDeltaIntersectionCmd = nullptr;
+        G4UIcmdWithADoubleAndUnit* fFieldDeltaOneStepCmd = nullptr;
+        G4UIcommand* fFieldEpsilonCmd = nullptr;
+        G4UIcmdWithADoubleAndUnit* fFieldLargestStepCmd = nullptr;
+        G4UIcmdWithAnInteger* fVerboseCmd = nullptr;
+
         // Cc hm setter b? sung (n?u c?n) trong ny c?ng c th? ???c khai bo
     };
 
@@ -0,0 +1,218 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file DigiMessenger.cc
+/// \brief Implementation of the B2a::DigiMessenger class
+
+#include "DigiMessenger.hh"
+
+#include "Digitizer.hh"
+
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcommand.hh"
+#include "G4UIdirectory.hh"
+#include "G4UIparameter.hh"
+
+#include <sstream>
+
+namespace B2a
+{
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+DigiMessenger::DigiMessenger(Digitizer* digitizer) : fDigitizer(digitizer)
+{
+  fDirectory = new G4UIdirectory("/B2/digi/");
+  fDirectory->SetGuidance("Digitization of the tracker hits");
+
+  fEnableCmd = new G4UIcmdWithABool("/B2/digi/enable", this);
+  fEnableCmd->SetGuidance("Digitize the hits, in a pipeline stage of each worker.");
+  fEnableCmd->SetParameterName("enabled", true);
+  fEnableCmd->SetDefaultValue(true);
+  fEnableCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fBatchSizeCmd = new G4UIcmdWithAnInteger("/B2/digi/batchSize", this);
+  fBatchSizeCmd->SetGuidance("Number of events digitized together.");
+  fBatchSizeCmd->SetParameterName("nofEvents", false);
+  fBatchSizeCmd->SetRange("nofEvents>0");
+  fBatchSizeCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  // Material commands: material name, then the values
+  auto makeMaterialCmd = [this](const char* name, const char* guidance) {
+    auto cmd = new G4UIcommand(name, this);
+    cmd->SetGuidance(guidance);
+    cmd->SetGuidance("Materials without settings take those of G4_Si.");
+    cmd->SetParameter(new G4UIparameter("material", 's', false));
+    cmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    return cmd;
+  };
+  auto addValue = [](G4UIcommand* cmd, const char* name, char type, const char* range) {
+    auto prm = new G4UIparameter(name, type, false);
+    prm->SetParameterRange(range);
+    cmd->SetParameter(prm);
+  };
+  auto addUnit = [](G4UIcommand* cmd, const char* defaultUnit) {
+    auto prm = new G4UIparameter("unit", 's', true);
+    prm->SetDefaultUnit(defaultUnit);
+    cmd->SetParameter(prm);
+  };
+
+  fPairEnergyCmd =
+    makeMaterialCmd("/B2/digi/setPairEnergy", "Set the mean energy per electron-hole pair.");
+  addValue(fPairEnergyCmd, "value", 'd', "value>0.");
+  addUnit(fPairEnergyCmd, "eV");
+
+  fFanoCmd = makeMaterialCmd("/B2/digi/setFano", "Set the Fano factor.");
+  addValue(fFanoCmd, "value", 'd', "value>=0.");
+
+  fNoiseCmd = makeMaterialCmd("/B2/digi/setNoise", "Set the electronic noise (ENC, electrons).");
+  addValue(fNoiseCmd, "electrons", 'd', "electrons>=0.");
+
+  fTrappingCmd = makeMaterialCmd("/B2/digi/setTrapping",
+                                 "Set the electron and hole trapping lengths (mu tau E).");
+  fTrappingCmd->SetGuidance("0 for no trapping.");
+  addValue(fTrappingCmd, "electronLength", 'd', "electronLength>=0.");
+  addValue(fTrappingCmd, "holeLength", 'd', "holeLength>=0.");
+  addUnit(fTrappingCmd, "mm");
+
+  fDepthCorrectionCmd = makeMaterialCmd("/B2/digi/setDepthCorrection",
+                                        "Correct the trapping from the depth of interaction,");
+  fDepthCorrectionCmd->SetGuidance("known to the resolution (0: exact).");
+  fDepthCorrectionCmd->SetParameter(new G4UIparameter("enabled", 'b', false));
+  addValue(fDepthCorrectionCmd, "resolution", 'd', "resolution>=0.");
+  addUnit(fDepthCorrectionCmd, "mm");
+
+  fThresholdCmd = makeMaterialCmd("/B2/digi/setThreshold", "Set the digitization threshold.");
+  addValue(fThresholdCmd, "value", 'd', "value>=0.");
+  addUnit(fThresholdCmd, "keV");
+
+  fAdcCmd = makeMaterialCmd("/B2/digi/setAdc", "Set the ADC range (bits) and gain per channel.");
+  addValue(fAdcCmd, "bits", 'i', "bits>0 && bits<=24");
+  addValue(fAdcCmd, "gain", 'd', "gain>0.");
+  addUnit(fAdcCmd, "keV");
+
+  fBenchmarkCmd = new G4UIcmdWithAnInteger("/B2/digi/benchmark", this);
+  fBenchmarkCmd->SetGuidance("Measure the digitization throughput on synthetic hits,");
+  fBenchmarkCmd->SetGuidance("with the current layers and parameters.");
+  fBenchmarkCmd->SetParameterName("nofHits", true);
+  fBenchmarkCmd->SetDefaultValue(1000000);
+  fBenchmarkCmd->SetRange("nofHits>0");
+  fBenchmarkCmd->AvailableForStates(G4State_Idle);
+  fBenchmarkCmd->SetToBeBroadcasted(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+DigiMessenger::~DigiMessenger()
+{
+  delete fEnableCmd;
+  delete fBatchSizeCmd;
+  delete fPairEnergyCmd;
+  delete fFanoCmd;
+  delete fNoiseCmd;
+  delete fTrappingCmd;
+  delete fDepthCorrectionCmd;
+  delete fThresholdCmd;
+  delete fAdcCmd;
+  delete fBenchmarkCmd;
+  delete fDirectory;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DigiMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+  if (command == fEnableCmd) {
+    fDigitizer->SetEnabled(fEnableCmd->GetNewBoolValue(newValue));
+    return;
+  }
+
+  if (command == fBatchSizeCmd) {
+    fDigitizer->SetBatchSize(fBatchSizeCmd->GetNewIntValue(newValue));
+    return;
+  }
+
+  if (command == fBenchmarkCmd) {
+    fDigitizer->Benchmark(fBenchmarkCmd->GetNewIntValue(newValue));
+    return;
+  }
+
+  // material commands
+  std::istringstream is(newValue);
+  G4String material;
+  is >> material;
+  auto& parameters = fDigitizer->GetParameters(material);
+
+  if (command == fPairEnergyCmd) {
+    G4double value = 0.;
+    G4String unit;
+    is >> value >> unit;
+    parameters.pairEnergy = value * G4UIcommand::ValueOf(unit);
+  }
+
+  if (command == fFanoCmd) {
+    is >> parameters.fano;
+  }
+
+  if (command == fNoiseCmd) {
+    is >> parameters.noise;
+  }
+
+  if (command == fTrappingCmd) {
+    G4double electronLength = 0., holeLength = 0.;
+    G4String unit;
+    is >> electronLength >> holeLength >> unit;
+    parameters.electronLength = electronLength * G4UIcommand::ValueOf(unit);
+    parameters.holeLength = holeLength * G4UIcommand::ValueOf(unit);
+  }
+
+  if (command == fDepthCorrectionCmd) {
+    G4String enabled, unit;
+    G4double resolution = 0.;
+    is >> enabled >> resolution >> unit;
+    parameters.depthCorrection = G4UIcommand::ConvertToBool(enabled);
+    parameters.depthResolution = resolution * G4UIcommand::ValueOf(unit);
+  }
+
+  if (command == fThresholdCmd) {
+    G4double value = 0.;
+    G4String unit;
+    is >> value >> unit;
+    parameters.threshold = value * G4UIcommand::ValueOf(unit);
+  }
+
+  if (command == fAdcCmd) {
+    G4double gain = 0.;
+    G4String unit;
+    is >> parameters.adcBits >> gain >> unit;
+    parameters.adcGain = gain * G4UIcommand::ValueOf(unit);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}  // namespace B2a
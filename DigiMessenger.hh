@@ -0,0 +1,90 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file DigiMessenger.hh
+/// \brief Definition of the B2a::DigiMessenger class
+
+#ifndef B2aDigiMessenger_h
+#define B2aDigiMessenger_h 1
+
+#include "G4UImessenger.hh"
+
+class G4UIdirectory;
+class G4UIcmdWithABool;
+class G4UIcmdWithAnInteger;
+class G4UIcommand;
+
+namespace B2a
+{
+
+class Digitizer;
+
+/// Messenger class that defines commands for the Digitizer.
+///
+/// It implements commands:
+/// - /B2/digi/enable true|false
+/// - /B2/digi/batchSize n
+/// - /B2/digi/setPairEnergy material value unit
+/// - /B2/digi/setFano material value
+/// - /B2/digi/setNoise material electrons
+/// - /B2/digi/setTrapping material electronLength holeLength unit
+/// - /B2/digi/setDepthCorrection material true|false resolution unit
+/// - /B2/digi/setThreshold material value unit
+/// - /B2/digi/setAdc material bits gain unit
+/// - /B2/digi/benchmark nofHits
+///
+/// A messenger exists on the master and on each worker (the commands are
+/// broadcast), each one configuring the digitizer of its own thread; the
+/// benchmark only runs on the master.
+
+class DigiMessenger : public G4UImessenger
+{
+  public:
+    DigiMessenger(Digitizer*);
+    ~DigiMessenger() override;
+
+    void SetNewValue(G4UIcommand*, G4String) override;
+
+  private:
+    Digitizer* fDigitizer = nullptr;
+
+    G4UIdirectory* fDirectory = nullptr;
+
+    G4UIcmdWithABool* fEnableCmd = nullptr;
+    G4UIcmdWithAnInteger* fBatchSizeCmd = nullptr;
+    G4UIcommand* fPairEnergyCmd = nullptr;
+    G4UIcommand* fFanoCmd = nullptr;
+    G4UIcommand* fNoiseCmd = nullptr;
+    G4UIcommand* fTrappingCmd = nullptr;
+    G4UIcommand* fDepthCorrectionCmd = nullptr;
+    G4UIcommand* fThresholdCmd = nullptr;
+    G4UIcommand* fAdcCmd = nullptr;
+    G4UIcmdWithAnInteger* fBenchmarkCmd = nullptr;
+};
+
+}  // namespace B2a
+
+#endif
@@ -0,0 +1,448 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file Digitizer.cc
+/// \brief Implementation of the B2a::Digitizer class
+
+#include "Digitizer.hh"
+
+#include "DetectorConstruction.hh"
+#include "DigiMessenger.hh"
+
+#include "CLHEP/Random/RandExponential.h"
+#include "CLHEP/Random/RandFlat.h"
+#include "CLHEP/Random/RandGauss.h"
+#include "G4AutoLock.hh"
+#include "G4RunManager.hh"
+#include "G4SystemOfUnits.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace B2a
+{
+
+Digitizer::Summary Digitizer::fTotal;
+G4Mutex Digitizer::fTotalMutex = G4MUTEX_INITIALIZER;
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+G4double Seconds(Clock::time_point start)
+{
+  return std::chrono::duration<G4double>(Clock::now() - start).count();
+}
+}  // namespace
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+Digitizer::Digitizer()
+{
+  // Silicon: the defaults
+  fParameters["G4_Si"] = DigiParameters();
+
+  // CdTe: hole trapping, corrected from the depth of interaction
+  DigiParameters cdTe;
+  cdTe.pairEnergy = 4.43 * eV;
+  cdTe.fano = 0.1;
+  cdTe.noise = 200.;
+  cdTe.electronLength = 3. * cm;
+  cdTe.holeLength = 2. * mm;
+  cdTe.depthCorrection = true;
+  cdTe.depthResolution = 0.5 * mm;
+  cdTe.threshold = 20. * keV;
+  fParameters["G4_CADMIUM_TELLURIDE"] = cdTe;
+
+  fMessenger = new DigiMessenger(this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+Digitizer::~Digitizer()
+{
+  if (fStage.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(fMutex);
+      fStop = true;
+    }
+    fCondition.notify_all();
+    fStage.join();
+  }
+  delete fMessenger;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+DigiParameters& Digitizer::GetParameters(const G4String& material)
+{
+  // other materials start from the silicon parameters
+  auto entry = fParameters.find(material);
+  if (entry == fParameters.end()) {
+    entry = fParameters.emplace(material, fParameters["G4_Si"]).first;
+  }
+  return entry->second;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Digitizer::Summary::Add(const Summary& other)
+{
+  for (const auto& entry : other.materials) {
+    auto& total = materials[entry.first];
+    total.hits += entry.second.hits;
+    total.digits += entry.second.digits;
+    total.weight += entry.second.weight;
+    total.energy += entry.second.energy;
+    total.adc.resize(std::max(total.adc.size(), entry.second.adc.size()), 0.);
+    for (std::size_t i = 0; i < entry.second.adc.size(); ++i) {
+      total.adc[i] += entry.second.adc[i];
+    }
+  }
+  batches += other.batches;
+  stageTime += other.stageTime;
+  waitTime += other.waitTime;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Digitizer::Batch::Clear()
+{
+  layer.clear();
+  edep.clear();
+  depth.clear();
+  weight.clear();
+  eventID.clear();
+  eventStart.clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::size_t Digitizer::Batch::GetMemorySize() const
+{
+  return (layer.capacity() + eventID.capacity()) * sizeof(G4int)
+         + (edep.capacity() + depth.capacity() + weight.capacity()) * sizeof(G4double)
+         + eventStart.capacity() * sizeof(std::size_t);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double Digitizer::LayerResponse::ChargeCollection(G4double depth) const
+{
+  // Hecht relation: electrons drift to the anode (downstream face), holes
+  // to the cathode, each one inducing its drift length over the thickness
+  auto induced = [this](G4double length, G4double drift) {
+    return (length > 0.) ? -length * std::expm1(-drift / length) / thickness : drift / thickness;
+  };
+  return induced(electronLength, thickness - depth) + induced(holeLength, depth);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Digitizer::BuildResponse()
+{
+  // the layer layout is constant during a run (see DetectorConstruction)
+  auto detector = static_cast<const DetectorConstruction*>(
+    G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+  const auto& extents = detector->GetLayerExtents();
+  auto nofLayers = std::min<std::size_t>(extents.size(), detector->GetNbOfLayers());
+
+  fMaterials.clear();
+  fResponse.clear();
+  fLayerZMin.clear();
+  for (std::size_t i = 0; i < nofLayers; ++i) {
+    const auto& material = detector->GetLayerMaterial(G4int(i));
+    const auto& parameters = GetParameters(material);
+
+    auto index = std::find(fMaterials.begin(), fMaterials.end(), material) - fMaterials.begin();
+    if (index == G4int(fMaterials.size())) fMaterials.push_back(material);
+
+    LayerResponse response;
+    response.material = G4int(index);
+    response.thickness = extents[i].zMax - extents[i].zMin;
+    response.pairEnergy = parameters.pairEnergy;
+    response.fano = parameters.fano;
+    response.noise2 = parameters.noise * parameters.noise;
+    response.electronLength = parameters.electronLength;
+    response.holeLength = parameters.holeLength;
+    response.depthCorrection = parameters.depthCorrection;
+    response.depthResolution = parameters.depthResolution;
+    response.threshold = parameters.threshold;
+    response.adcGain = parameters.adcGain;
+    response.maxChannel = (1 << parameters.adcBits) - 1;
+    fResponse.push_back(response);
+    fLayerZMin.push_back(extents[i].zMin);
+  }
+
+  fStageSums.assign(fMaterials.size(), MaterialSummary());
+  for (const auto& response : fResponse) {
+    fStageSums[response.material].adc.assign(response.maxChannel + 1, 0.);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Digitizer::BeginOfRun(G4int runID)
+{
+  if (!fEnabled) return;
+
+  fRunID = runID;
+  BuildResponse();
+  fSummary = Summary();
+  fWaitTime = 0.;
+
+  fFilling.Clear();
+  fHasPending = false;
+  fStop = false;
+  fStage = std::thread(&Digitizer::StageLoop, this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Digitizer::AddEvent(G4int eventID, const TrackerHitsCollection& hits)
+{
+  if (!fStage.joinable()) return;
+
+  fFilling.eventID.push_back(eventID);
+  fFilling.eventStart.push_back(fFilling.layer.size());
+  for (std::size_t i = 0; i < hits.entries(); ++i) {
+    G4int layer = hits[i]->GetChamberNb();
+    fFilling.layer.push_back(layer);
+    fFilling.edep.push_back(hits[i]->GetEdep());
+    fFilling.depth.push_back(hits[i]->GetPos().z() - fLayerZMin[layer]);
+    fFilling.weight.push_back(hits[i]->GetWeight());
+  }
+
+  if (G4int(fFilling.GetNbOfEvents()) >= fBatchSize) Submit();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Digitizer::AddEvent(G4int eventID, const PixelHitsCollection& pixels)
+{
+  if (!fStage.joinable()) return;
+
+  // the pixel position is in the middle plane of the layer
+  fFilling.eventID.push_back(eventID);
+  fFilling.eventStart.push_back(fFilling.layer.size());
+  for (std::size_t i = 0; i < pixels.entries(); ++i) {
+    G4int layer = pixels.GetLayer(i);
+    fFilling.layer.push_back(layer);
+    fFilling.edep.push_back(pixels.GetEdep(i));
+    fFilling.depth.push_back(pixels.GetPosition(i).z() - fLayerZMin[layer]);
+    fFilling.weight.push_back(pixels.GetWeight(i));
+  }
+
+  if (G4int(fFilling.GetNbOfEvents()) >= fBatchSize) Submit();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Digitizer::Submit()
+{
+  if (fFilling.GetNbOfEvents() == 0) return;
+
+  auto start = Clock::now();
+  std::unique_lock<std::mutex> lock(fMutex);
+  fCondition.wait(lock, [this] { return !fHasPending; });
+  fWaitTime += Seconds(start);
+
+  std::swap(fFilling, fPending);
+  fHasPending = true;
+  lock.unlock();
+  fCondition.notify_all();
+
+  fFilling.Clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Digitizer::StageLoop()
+{
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(fMutex);
+      fCondition.wait(lock, [this] { return fHasPending || fStop; });
+      if (!fHasPending) return;
+      std::swap(fPending, fProcessing);
+      fHasPending = false;
+    }
+    fCondition.notify_all();
+
+    auto start = Clock::now();
+    Process(fProcessing);
+    fSummary.stageTime += Seconds(start);
+    ++fSummary.batches;
+    fProcessing.Clear();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Digitizer::EndOfRun()
+{
+  if (!fStage.joinable()) return;
+
+  Submit();
+  {
+    std::lock_guard<std::mutex> lock(fMutex);
+    fStop = true;
+  }
+  fCondition.notify_all();
+  fStage.join();
+
+  for (std::size_t i = 0; i < fMaterials.size(); ++i) {
+    fSummary.materials[fMaterials[i]] = fStageSums[i];
+  }
+  fSummary.waitTime = fWaitTime;
+
+  G4AutoLock lock(&fTotalMutex);
+  fTotal.Add(fSummary);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+Digitizer::Summary Digitizer::TakeTotal()
+{
+  G4AutoLock lock(&fTotalMutex);
+  Summary total = std::move(fTotal);
+  fTotal = Summary();
+  return total;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Digitizer::Process(const Batch& batch)
+{
+  std::size_t nofHits = batch.layer.size();
+  for (auto column : {&fMean, &fSigma, &fScale, &fGauss, &fEnergy}) column->resize(nofHits);
+
+  // Pass 1: response of the layer of each hit
+  for (std::size_t i = 0; i < nofHits; ++i) {
+    const auto& response = fResponse[batch.layer[i]];
+    G4double depth = std::clamp(batch.depth[i], 0., response.thickness);
+    G4double collection = response.ChargeCollection(depth);
+    G4double pairs = batch.edep[i] / response.pairEnergy;
+    fMean[i] = pairs * collection;
+    fSigma[i] = std::sqrt(response.fano * pairs * collection * collection + response.noise2);
+
+    // calibration: energy per collected charge, at the measured depth
+    G4double calibration = 1.;
+    if (response.depthCorrection) {
+      G4double resolution = response.depthResolution;
+      G4double measured =
+        (resolution > 0.) ? (std::floor(depth / resolution) + 0.5) * resolution : depth;
+      calibration = response.ChargeCollection(std::min(measured, response.thickness));
+    }
+    fScale[i] = response.pairEnergy / calibration;
+  }
+
+  // Normal deviates, seeded per event
+  for (std::size_t e = 0; e < batch.GetNbOfEvents(); ++e) {
+    std::size_t first = batch.eventStart[e];
+    std::size_t last = (e + 1 < batch.GetNbOfEvents()) ? batch.eventStart[e + 1] : nofHits;
+    if (first == last) continue;
+    auto seed = (std::uint64_t(fRunID) << 32) + std::uint32_t(batch.eventID[e]) + 1;
+    fEngine.setSeed(G4long(seed), 0);
+    CLHEP::RandGauss::shootArray(&fEngine, G4int(last - first), &fGauss[first], 0., 1.);
+  }
+
+  // Pass 2: smearing and calibration (vectorised)
+  const G4double* mean = fMean.data();
+  const G4double* sigma = fSigma.data();
+  const G4double* scale = fScale.data();
+  const G4double* gauss = fGauss.data();
+  G4double* energy = fEnergy.data();
+  for (std::size_t i = 0; i < nofHits; ++i) {
+    energy[i] = (mean[i] + sigma[i] * gauss[i]) * scale[i];
+  }
+
+  // Pass 3: threshold, ADC and accounting
+  for (std::size_t i = 0; i < nofHits; ++i) {
+    const auto& response = fResponse[batch.layer[i]];
+    auto& sums = fStageSums[response.material];
+    ++sums.hits;
+    if (energy[i] < response.threshold) continue;
+    ++sums.digits;
+    sums.weight += batch.weight[i];
+    sums.energy += batch.weight[i] * energy[i];
+    sums.adc[std::min(G4int(energy[i] / response.adcGain), response.maxChannel)] +=
+      batch.weight[i];
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Digitizer::Benchmark(G4int nofHits)
+{
+  if (fStage.joinable()) return;
+
+  BuildResponse();
+  if (fResponse.empty() || nofHits <= 0) return;
+
+  // Synthetic batch: 100 hits per event, uniform in the layers and in
+  // depth, exponential deposits
+  Batch batch;
+  fEngine.setSeed(12345, 0);
+  for (G4int i = 0; i < nofHits; ++i) {
+    if (i % 100 == 0) {
+      batch.eventID.push_back(i / 100);
+      batch.eventStart.push_back(i);
+    }
+    G4int layer = G4int(CLHEP::RandFlat::shoot(&fEngine) * fResponse.size());
+    batch.layer.push_back(layer);
+    batch.edep.push_back(CLHEP::RandExponential::shoot(&fEngine, 100. * keV));
+    batch.depth.push_back(CLHEP::RandFlat::shoot(&fEngine) * fResponse[layer].thickness);
+    batch.weight.push_back(1.);
+  }
+
+  // at least 3 passes, and 1 s
+  G4int nofPasses = 0;
+  G4double time = 0.;
+  while (nofPasses < 3 || time < 1.) {
+    auto start = Clock::now();
+    Process(batch);
+    time += Seconds(start);
+    ++nofPasses;
+  }
+
+  std::uint64_t nofDigits = 0;
+  for (const auto& sums : fStageSums) nofDigits += sums.digits;
+  G4double total = G4double(nofHits) * nofPasses;
+  G4double rate = total / time;
+
+  G4cout << G4endl << "----> Digitization benchmark: " << total << " hits in " << time << " s, "
+         << rate / 1.e6 << " Mhits/s, " << nofDigits / total << " digits per hit" << G4endl
+         << "B2a-digi-benchmark hits=" << total << " s=" << time << " hits_per_s=" << rate
+         << G4endl;
+
+  fStageSums.assign(fStageSums.size(), MaterialSummary());
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}  // namespace B2a
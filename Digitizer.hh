@@ -0,0 +1,216 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file Digitizer.hh
+/// \brief Definition of the B2a::Digitizer class
+
+#ifndef B2aDigitizer_h
+#define B2aDigitizer_h 1
+
+#include "PixelHitsCollection.hh"
+#include "TrackerHit.hh"
+
+#include "CLHEP/Random/MixMaxRng.h"
+#include "CLHEP/Units/SystemOfUnits.h"
+#include "G4Threading.hh"
+#include "globals.hh"
+
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace B2a
+{
+
+class DigiMessenger;
+
+/// Response parameters of the sensors of one material
+struct DigiParameters {
+  G4double pairEnergy = 3.62 * CLHEP::eV;  // mean energy per electron-hole pair
+  G4double fano = 0.115;
+  G4double noise = 100.;  // equivalent noise charge, electrons
+  G4double electronLength = 0.;  // trapping length (mu tau E), 0: no trapping
+  G4double holeLength = 0.;
+  G4bool depthCorrection = false;  // correct the trapping from the depth
+  G4double depthResolution = 0.;  // of the depth correction, 0: exact
+  G4double threshold = 10. * CLHEP::keV;
+  G4double adcGain = 1. * CLHEP::keV;  // per channel
+  G4int adcBits = 12;
+};
+
+/// Digitization of the tracker hits, on batches of events.
+///
+/// The hits of each event are appended, as columns (layer, energy
+/// deposit, depth in the layer), to a batch; a full batch is handed over
+/// to the digitization stage, a thread of its own, while the worker
+/// tracks the next events. A worker only waits when the stage is still
+/// busy with the previous batch.
+///
+/// The stage runs three passes over the batch:
+/// - per hit, the response of its layer: mean collected charge, with the
+///   Hecht charge collection efficiency of a planar sensor irradiated on
+///   the cathode side, its spread (Fano and electronic noise), and the
+///   calibration, including the depth correction of the trapping;
+/// - the smearing, a branch-free loop over contiguous arrays which the
+///   compiler vectorises;
+/// - the threshold, the ADC quantisation, and the accounting per material.
+/// The noise of an event is seeded from the run and event numbers, so the
+/// digits do not depend on the batching nor on the threads, and the
+/// random sequence of the tracking is untouched.
+///
+/// One digitizer per thread, owned by the RunAction, configured by its
+/// DigiMessenger; the parameters are set per material. The workers add
+/// their summaries to a total, which the master prints (see RunAction).
+
+class Digitizer
+{
+  public:
+    // Accounting of one material; the energy and the spectrum are
+    // weighted by the hit weights
+    struct MaterialSummary {
+      std::uint64_t hits = 0;
+      std::uint64_t digits = 0;  // above threshold
+      G4double weight = 0.;  // of the digits
+      G4double energy = 0.;  // of the digits, calibrated
+      std::vector<G4double> adc;  // spectrum of the digits
+    };
+    struct Summary {
+      std::map<G4String, MaterialSummary> materials;
+      std::uint64_t batches = 0;
+      G4double stageTime = 0.;  // s, in the digitization stage
+      G4double waitTime = 0.;  // s, of the workers waiting for the stage
+
+      void Add(const Summary&);
+    };
+
+    Digitizer();
+    ~Digitizer();
+
+    Digitizer(const Digitizer&) = delete;
+    Digitizer& operator=(const Digitizer&) = delete;
+
+    void SetEnabled(G4bool enabled) { fEnabled = enabled; }
+    void SetBatchSize(G4int nofEvents) { fBatchSize = nofEvents; }
+    DigiParameters& GetParameters(const G4String& material);
+    G4bool IsEnabled() const { return fEnabled; }
+
+    // Bytes of the batches (see MemoryMonitor), estimated from the one
+    // being filled: the batches are swapped, and have similar capacities
+    std::size_t GetMemorySize() const { return 3 * fFilling.GetMemorySize(); }
+
+    // Thread processing events
+    void BeginOfRun(G4int runID);
+    void AddEvent(G4int eventID, const TrackerHitsCollection& hits);
+    void AddEvent(G4int eventID, const PixelHitsCollection& pixels);
+    void EndOfRun();  // digitizes the last batch, adds the summary to the total
+
+    // Master: summary of all threads since the last call
+    static Summary TakeTotal();
+
+    // Throughput of the stage alone, on synthetic hits, in this thread
+    void Benchmark(G4int nofHits);
+
+  private:
+    // Columns of a batch of events
+    struct Batch {
+      std::vector<G4int> layer;
+      std::vector<G4double> edep;
+      std::vector<G4double> depth;  // from the upstream (cathode) face
+      std::vector<G4double> weight;
+      std::vector<G4int> eventID;
+      std::vector<std::size_t> eventStart;  // first hit of each event
+
+      std::size_t GetNbOfEvents() const { return eventID.size(); }
+      std::size_t GetMemorySize() const;
+      void Clear();
+    };
+
+    // Parameters of a layer, derived from those of its material
+    struct LayerResponse {
+      G4int material;  // index in fMaterials
+      G4double thickness;
+      G4double pairEnergy;
+      G4double fano;
+      G4double noise2;
+      G4double electronLength;
+      G4double holeLength;
+      G4bool depthCorrection;
+      G4double depthResolution;
+      G4double threshold;
+      G4double adcGain;
+      G4int maxChannel;
+
+      G4double ChargeCollection(G4double depth) const;
+    };
+
+    void BuildResponse();
+    void Submit();
+    void StageLoop();
+    void Process(const Batch& batch);  // into fStageSums
+
+    G4bool fEnabled = false;
+    G4int fBatchSize = 256;  // events
+    std::map<G4String, DigiParameters> fParameters;
+
+    G4int fRunID = 0;
+    std::vector<G4String> fMaterials;
+    std::vector<LayerResponse> fResponse;  // per layer
+    std::vector<G4double> fLayerZMin;  // upstream face of each layer
+
+    // Batches: filled by the worker, pending, processed by the stage
+    Batch fFilling;
+    Batch fPending;
+    Batch fProcessing;
+    G4bool fHasPending = false;
+    G4bool fStop = false;
+    std::thread fStage;
+    std::mutex fMutex;
+    std::condition_variable fCondition;
+
+    // Stage scratch arrays and random engine
+    std::vector<G4double> fMean;
+    std::vector<G4double> fSigma;
+    std::vector<G4double> fScale;
+    std::vector<G4double> fGauss;
+    std::vector<G4double> fEnergy;
+    CLHEP::MixMaxRng fEngine;
+
+    std::vector<MaterialSummary> fStageSums;  // per material index
+    Summary fSummary;  // of the current run
+    G4double fWaitTime = 0.;
+
+    static Summary fTotal;
+    static G4Mutex fTotalMutex;
+
+    DigiMessenger* fMessenger = nullptr;
+};
+
+}  // namespace B2a
+
+#endif
@@ -0,0 +1,219 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EventAction.cc
+/// \brief Implementation of the B2a::EventAction class
+
+#include "EventAction.hh"
+
+#include "PixelHitsCollection.hh"
+#include "Run.hh"
+#include "RunAction.hh"
+#include "ShardDriver.hh"
+#include "TrackerHit.hh"
+
+#include "G4Event.hh"
+#include "G4PrimaryParticle.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4RunManager.hh"
+#include "G4SDManager.hh"
+#include "G4ios.hh"
+
+#include <algorithm>
+
+namespace
+{
+// Mean weight of the primaries of all the vertices of the event
+G4double GetPrimaryWeight(const G4Event* event)
+{
+  G4double sum = 0.;
+  G4int nofPrimaries = 0;
+  for (G4int i = 0; i < event->GetNumberOfPrimaryVertex(); ++i) {
+    auto vertex = event->GetPrimaryVertex(i);
+    for (auto primary = vertex->GetPrimary(); primary; primary = primary->GetNext()) {
+      sum += vertex->GetWeight() * primary->GetWeight();
+      ++nofPrimaries;
+    }
+  }
+  return (nofPrimaries > 0) ? sum / nofPrimaries : 1.;
+}
+}  // namespace
+
+namespace B2a
+{
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EventAction::EventAction(RunAction* runAction) : fRunAction(runAction) {}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EventAction::BeginOfEventAction(const G4Event* event)
+{
+  // events are numbered in the logical run in a sharded job
+  auto shard = ShardDriver::GetInstance();
+  G4int firstEvent = shard ? shard->GetFirstEvent() : 0;
+  fFirstEvent = event->GetEventID() == firstEvent
+                && G4RunManager::GetRunManager()->GetCurrentRun()->GetRunID() == 0;
+  fEventStart = StartupProfiler::Clock::now();
+
+  auto subEvent = SubEventDriver::GetInstance();
+  if (subEvent && !G4Threading::IsWorkerThread()) subEvent->BeginOfEvent(fEventStart);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EventAction::EndOfEventAction(const G4Event* event)
+{
+  // restored from a checkpoint, see GeneratorAction; or a sub-event
+  if (event->GetNumberOfPrimaryVertex() == 0) return;
+
+  // in sub-event mode, once the sub-events are merged
+  if (SubEventDriver::GetInstance()) return;
+
+  CompleteEvent(event, fEventStart);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifdef B2A_SUBEVENT_PARALLEL
+void EventAction::MergeSubEvent(G4Event* masterEvent, const G4Event* subEvent)
+{
+  if (auto driver = SubEventDriver::GetInstance()) driver->MergeSubEvent(masterEvent, subEvent);
+}
+#endif
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EventAction::CompleteEvent(const G4Event* event, StartupProfiler::Clock::time_point start)
+{
+  AccountEvent(event, start);
+  if (auto voxels = fRunAction->GetVoxels()) voxels->EndOfEvent();
+  fRunAction->GetMemoryMonitor()->EndOfEvent(event);
+
+  // once the event is accounted, it is part of the next checkpoint
+  fRunAction->EndOfEvent(event->GetEventID());
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EventAction::AccountEvent(const G4Event* event, StartupProfiler::Clock::time_point start)
+{
+  auto run = static_cast<Run*>(G4RunManager::GetRunManager()->GetNonConstCurrentRun());
+
+  std::chrono::duration<G4double> elapsed = StartupProfiler::Clock::now() - start;
+  run->AddEventTime(elapsed.count());
+  if (fFirstEvent) {
+    auto profiler = StartupProfiler::Instance();
+    profiler->Record("first event", elapsed.count());
+    profiler->Record("job to first event", profiler->Elapsed());
+  }
+
+  if (fHCID < 0) {
+    fHCID = G4SDManager::GetSDMpointer()->GetCollectionID("TrackerHitsCollection");
+    fPixelsHCID = G4SDManager::GetSDMpointer()->GetCollectionID("PixelHitsCollection");
+    if (fHCID < 0 || fPixelsHCID < 0) return;
+  }
+
+  auto hce = event->GetHCofThisEvent();
+  if (!hce) return;
+
+  // one of the two collections, depending on the readout
+  auto hits = static_cast<TrackerHitsCollection*>(hce->GetHC(fHCID));
+  auto pixels = static_cast<PixelHitsCollection*>(hce->GetHC(fPixelsHCID));
+  if (!hits && !pixels) return;
+
+  G4int eventID = event->GetEventID();
+  auto hitWriter = fRunAction->GetHitWriter();
+  std::uint64_t nofLostHits = hitWriter ? hitWriter->GetNbOfLostHits() : 0;
+
+  auto trigger = fRunAction->GetTrigger();
+  auto digitizer = fRunAction->GetDigitizer();
+  auto histograms = fRunAction->GetHistograms();
+
+  // the run accounting sees all events, the output stages only those
+  // accepted by the trigger
+  std::size_t nofHits = 0;
+  G4double edep = 0.;  // weighted
+  G4double rawEdep = 0.;
+  G4bool accepted = false;
+  std::fill(fLayerEdep.begin(), fLayerEdep.end(), 0.);
+  auto addDeposit = [&](G4int layer, G4double hitEdep, G4double hitWeight) {
+    if (layer >= G4int(fLayerEdep.size())) fLayerEdep.resize(layer + 1, 0.);
+    fLayerEdep[layer] += hitWeight * hitEdep;
+    edep += hitWeight * hitEdep;
+    rawEdep += hitEdep;
+    run->AddHitEdep(hitEdep, hitWeight);
+  };
+  if (hits) {
+    nofHits = hits->entries();
+    for (std::size_t i = 0; i < nofHits; ++i) {
+      const auto hit = (*hits)[i];
+      addDeposit(hit->GetChamberNb(), hit->GetEdep(), hit->GetWeight());
+    }
+  }
+  else {
+    nofHits = pixels->entries();
+    for (std::size_t i = 0; i < nofHits; ++i) {
+      addDeposit(pixels->GetLayer(i), pixels->GetEdep(i), pixels->GetWeight(i));
+    }
+  }
+
+  // event weight: the mean hit weight, weighted by the deposits, so that
+  // the weighted event deposit is the sum of the weighted hit deposits;
+  // that of the primaries for an event without deposit
+  G4double weight = (rawEdep > 0.) ? edep / rawEdep : GetPrimaryWeight(event);
+
+  if (hits) {
+    if (histograms) histograms->FillEvent(*hits, weight);
+    accepted = trigger->Accept(*hits, run, weight);
+    if (accepted && hitWriter) hitWriter->Fill(eventID, *hits);
+    if (accepted) digitizer->AddEvent(eventID, *hits);
+  }
+  else {
+    if (histograms) histograms->FillEvent(*pixels, weight);
+    accepted = trigger->Accept(*pixels, run, weight);
+    if (accepted && hitWriter) hitWriter->Fill(eventID, *pixels);
+    if (accepted) digitizer->AddEvent(eventID, *pixels);
+  }
+  run->AddEventHits(nofHits, edep);
+  run->AddEventScore(weight, fLayerEdep);
+  if (accepted) run->AddAcceptedEvent(nofHits);
+  // less the hits of a block lost by a failed write (see HitWriter)
+  if (accepted && hitWriter) {
+    run->AddWrittenHits(nofHits, hitWriter->GetNbOfLostHits() - nofLostHits);
+  }
+
+  G4int printModulo = G4RunManager::GetRunManager()->GetPrintProgress();
+  if (printModulo > 0 && eventID % printModulo == 0) {
+    G4cout << ">>> Event: " << eventID << ", " << nofHits
+           << (hits ? " hits" : " pixel hits") << " stored in this event" << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}  // namespace B2a
@@ -0,0 +1,102 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EventAction.hh
+/// \brief Definition of the B2a::EventAction class
+
+#ifndef B2aEventAction_h
+#define B2aEventAction_h 1
+
+#include "StartupProfiler.hh"
+#include "SubEventDriver.hh"
+
+#include "G4UserEventAction.hh"
+#include "globals.hh"
+
+#include <vector>
+
+namespace B2a
+{
+
+class RunAction;
+
+/// Event action class
+///
+/// At the end of each event the hits of the "TrackerHitsCollection", or
+/// the pixels of the "PixelHitsCollection" with a pixelated readout, are
+/// passed to the output stages of this thread, the hit writer and the
+/// digitizer, if the trigger accepts the event. The per-event printout is
+/// only done every /run/printProgress events.
+/// Each event is timed for the latency report of the run; the first event
+/// of the job also for the start-up profile.
+///
+/// The run accounting is weighted: the energy deposits by the hit
+/// weights, the trigger rates by the event weight, and the weighted
+/// deposit of each layer is scored for the figure of merit of the run.
+/// The event weight is the mean of the hit weights weighted by their
+/// deposits, or, for an event without deposit, the mean weight of all
+/// its primaries (see GeneratorAction): with one primary and no
+/// splitting it is the weight of the primary.
+/// The histograms of the thread (see OnlineHistograms) are filled with
+/// all the events, before the trigger; the voxels (see VoxelScorer) are
+/// told the end of each event, their errors being per event, and so is
+/// the memory monitor of the thread (see MemoryMonitor).
+/// The events restored from a checkpoint (see CheckpointManager) have
+/// no primaries, and are not accounted again.
+///
+/// In sub-event mode (see SubEventDriver) the master accounts an event
+/// once the hits of its sub-events are merged, from Run::RecordEvent; the
+/// sub-events, processed by the workers, have no primaries either.
+
+class EventAction : public G4UserEventAction
+{
+  public:
+    EventAction(RunAction* runAction);
+    ~EventAction() override = default;
+
+    void BeginOfEventAction(const G4Event*) override;
+    void EndOfEventAction(const G4Event*) override;
+#ifdef B2A_SUBEVENT_PARALLEL
+    void MergeSubEvent(G4Event* masterEvent, const G4Event* subEvent) override;
+#endif
+
+    // The event and the hits of its sub-events, started at the given time
+    void CompleteEvent(const G4Event*, StartupProfiler::Clock::time_point start);
+
+  private:
+    void AccountEvent(const G4Event*, StartupProfiler::Clock::time_point start);
+
+    RunAction* fRunAction = nullptr;
+    G4int fHCID = -1;
+    G4int fPixelsHCID = -1;
+    G4bool fFirstEvent = false;
+    StartupProfiler::Clock::time_point fEventStart;
+    std::vector<G4double> fLayerEdep;  // weighted, of the current event
+};
+
+}  // namespace B2a
+
+#endif
@@ -0,0 +1,75 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file FastSimMessenger.cc
+/// \brief Implementation of the B2a::FastSimMessenger class
+
+#include "FastSimMessenger.hh"
+
+#include "FastSimValidator.hh"
+
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIdirectory.hh"
+
+namespace B2a
+{
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+FastSimMessenger::FastSimMessenger(FastSimValidator* validator) : fValidator(validator)
+{
+  fDirectory = new G4UIdirectory("/B2/fastSim/");
+  fDirectory->SetGuidance("Validation of the target shower model (see /B2/det/fastSim/).");
+
+  fValidateCmd = new G4UIcmdWithAnInteger("/B2/fastSim/validate", this);
+  fValidateCmd->SetGuidance("Compare the target shower model with the full simulation.");
+  fValidateCmd->SetGuidance("Runs the same events twice and compares the hit spectra.");
+  fValidateCmd->SetParameterName("nofEvents", false);
+  fValidateCmd->SetRange("nofEvents>0");
+  fValidateCmd->AvailableForStates(G4State_Idle);
+  fValidateCmd->SetToBeBroadcasted(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+FastSimMessenger::~FastSimMessenger()
+{
+  delete fValidateCmd;
+  delete fDirectory;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void FastSimMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+  if (command == fValidateCmd) {
+    fValidator->Validate(fValidateCmd->GetNewIntValue(newValue));
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}  // namespace B2a
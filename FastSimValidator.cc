@@ -0,0 +1,139 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file FastSimValidator.cc
+/// \brief Implementation of the B2a::FastSimValidator class
+
+#include "FastSimValidator.hh"
+
+#include "DetectorConstruction.hh"
+#include "FastSimMessenger.hh"
+#include "Run.hh"
+#include "RunAction.hh"
+
+#include "G4RunManager.hh"
+#include "G4SystemOfUnits.hh"
+#include "Randomize.hh"
+
+#include <array>
+#include <cmath>
+#include <iomanip>
+
+namespace B2a
+{
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+FastSimValidator::FastSimValidator(DetectorConstruction* det) : fDetectorConstruction(det)
+{
+  fMessenger = new FastSimMessenger(this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+FastSimValidator::~FastSimValidator()
+{
+  delete fMessenger;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void FastSimValidator::Validate(G4int nofEvents)
+{
+  if (!fDetectorConstruction->IsFastSimAvailable()) {
+    G4Exception("FastSimValidator::Validate()", "B2aFastSim002", JustWarning,
+                "The fast simulation physics is not registered: start the job with --fast-sim");
+    return;
+  }
+
+  auto runManager = G4RunManager::GetRunManager();
+  G4bool fastSim = fDetectorConstruction->IsFastSim();
+
+  struct Result {
+    std::array<G4double, Run::kNbOfHitBins> spectrum{};
+    std::array<G4double, Run::kNbOfHitBins> spectrum2{};
+    G4int nofEvents = 0;
+    G4double edep = 0.;
+    G4double loopTime = 0.;
+  };
+  std::array<Result, 2> results;  // full, fast
+
+  for (G4int fast = 0; fast < 2; ++fast) {
+    fDetectorConstruction->SetFastSim(fast == 1);
+
+    // same primaries in both runs
+    long seeds[2] = {12345, 67890};
+    G4Random::setTheSeeds(seeds, 2);
+    runManager->BeamOn(nofEvents);
+
+    auto run = static_cast<const Run*>(runManager->GetCurrentRun());
+    auto runAction = static_cast<const RunAction*>(runManager->GetUserRunAction());
+    if (!run || !runAction || run->GetNumberOfEvent() == 0) {
+      G4Exception("FastSimValidator::Validate()", "B2aFastSim003", JustWarning, "No events");
+      fDetectorConstruction->SetFastSim(fastSim);
+      return;
+    }
+    results[fast].spectrum = run->GetHitSpectrum();
+    results[fast].spectrum2 = run->GetHitSpectrum2();
+    results[fast].nofEvents = run->GetNumberOfEvent();
+    results[fast].edep = run->GetEdep();
+    results[fast].loopTime = runAction->GetEventLoopTime();
+  }
+  fDetectorConstruction->SetFastSim(fastSim);
+
+  // Weighted hits per event and bin; chi2 of the difference, bins with
+  // hits only
+  const auto& full = results[0];
+  const auto& fast = results[1];
+  G4cout << G4endl << " Fast simulation validation, " << nofEvents << " events" << G4endl
+         << std::setw(14) << "edep [MeV]" << std::setw(14) << "full/event" << std::setw(14)
+         << "fast/event" << std::setw(10) << "pull" << G4endl;
+  G4double chi2 = 0.;
+  G4int ndf = 0;
+  for (G4int bin = 0; bin < Run::kNbOfHitBins; ++bin) {
+    G4double variance = full.spectrum2[bin] / (G4double(full.nofEvents) * full.nofEvents)
+                        + fast.spectrum2[bin] / (G4double(fast.nofEvents) * fast.nofEvents);
+    if (variance <= 0.) continue;
+    G4double rFull = full.spectrum[bin] / full.nofEvents;
+    G4double rFast = fast.spectrum[bin] / fast.nofEvents;
+    G4double pull = (rFast - rFull) / std::sqrt(variance);
+    chi2 += pull * pull;
+    ++ndf;
+    G4cout << std::setw(14) << Run::GetHitBinLowEdge(bin) / MeV << std::setw(14) << rFull
+           << std::setw(14) << rFast << std::setw(10) << pull << G4endl;
+  }
+
+  G4double speedup = (fast.loopTime > 0.) ? full.loopTime / fast.loopTime : 0.;
+  G4cout << " edep/event: full " << full.edep / full.nofEvents / MeV << " MeV, fast "
+         << fast.edep / fast.nofEvents / MeV << " MeV; chi2/ndf " << chi2 << "/" << ndf
+         << ", speed-up " << speedup << G4endl
+         << "B2a-fastsim events=" << nofEvents << " chi2=" << chi2 << " ndf=" << ndf
+         << " speedup=" << speedup << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}  // namespace B2a
@@ -0,0 +1,66 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file FastSimValidator.hh
+/// \brief Definition of the B2a::FastSimValidator class
+
+#ifndef B2aFastSimValidator_h
+#define B2aFastSimValidator_h 1
+
+#include "globals.hh"
+
+namespace B2a
+{
+
+class DetectorConstruction;
+class FastSimMessenger;
+
+/// Validation of the target shower model (see TargetShowerModel).
+///
+/// Validate() runs the same events (same seeds) with the full simulation
+/// and with the model, and compares the hit energy spectra per event bin
+/// by bin and the event loop times. The hits are weighted: the variance
+/// of a bin is the sum of the squared weights of its hits.
+///
+/// Master thread only; it is driven by FastSimMessenger, and needs the
+/// fast simulation physics (exampleB2a --fast-sim).
+
+class FastSimValidator
+{
+  public:
+    FastSimValidator(DetectorConstruction*);
+    ~FastSimValidator();
+
+    void Validate(G4int nofEvents);
+
+  private:
+    DetectorConstruction* fDetectorConstruction = nullptr;
+    FastSimMessenger* fMessenger = nullptr;
+};
+
+}  // namespace B2a
+
+#endif
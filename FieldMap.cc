@@ -0,0 +1,101 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file FieldMap.cc
+/// \brief Implementation of the B2a::FieldMap class
+
+#include "FieldMap.hh"
+
+#include "G4SystemOfUnits.hh"
+
+#include <fstream>
+#include <sstream>
+
+namespace B2a
+{
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool FieldMap::Load(const G4String& fileName)
+{
+  std::ifstream file(fileName);
+  if (!file) {
+    G4ExceptionDescription msg;
+    msg << "Cannot open field map " << fileName;
+    G4Exception("FieldMap::Load()", "B2aField001", JustWarning, msg);
+    return false;
+  }
+
+  // the header and the values, without the comments
+  std::stringstream values;
+  std::string line;
+  while (std::getline(file, line)) {
+    if (line.empty() || line[0] == '#') continue;
+    values << line << '\n';
+  }
+
+  G4int n[3] = {0, 0, 0};
+  G4double range[6] = {0., 0., 0., 0., 0., 0.};
+  values >> n[0] >> n[1] >> n[2];
+  for (auto& value : range) values >> value;
+  if (!values || n[0] < 2 || n[1] < 2 || n[2] < 2) {
+    G4ExceptionDescription msg;
+    msg << "Bad header in field map " << fileName << " (at least 2 nodes per axis)";
+    G4Exception("FieldMap::Load()", "B2aField002", JustWarning, msg);
+    return false;
+  }
+
+  std::size_t nofNodes = std::size_t(n[0]) * n[1] * n[2];
+  std::vector<float> field(3 * nofNodes);
+  for (auto& component : field) {
+    G4double value = 0.;
+    values >> value;
+    component = float(value * tesla);
+  }
+  if (!values) {
+    G4ExceptionDescription msg;
+    msg << "Field map " << fileName << " has less than " << nofNodes << " nodes";
+    G4Exception("FieldMap::Load()", "B2aField003", JustWarning, msg);
+    return false;
+  }
+
+  fNx = n[0];
+  fNy = n[1];
+  fNz = n[2];
+  for (G4int axis = 0; axis < 3; ++axis) {
+    fMin[axis] = range[2 * axis] * mm;
+    fInverseStep[axis] = (n[axis] - 1) / ((range[2 * axis + 1] - range[2 * axis]) * mm);
+  }
+  fField.swap(field);
+
+  G4cout << G4endl << "----> Field map " << fileName << ": " << fNx << " x " << fNy << " x "
+         << fNz << " nodes, " << GetMemorySize() / 1048576. << " MB" << G4endl;
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}  // namespace B2a
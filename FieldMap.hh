@@ -0,0 +1,87 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file FieldMap.hh
+/// \brief Definition of the B2a::FieldMap class
+
+#ifndef B2aFieldMap_h
+#define B2aFieldMap_h 1
+
+#include "globals.hh"
+
+#include <vector>
+
+namespace B2a
+{
+
+/// Magnetic field map on a regular 3D grid, read from a text file.
+///
+/// File layout (lines starting with '#' are comments):
+///
+///   nx ny nz
+///   xmin xmax ymin ymax zmin zmax      mm, global frame
+///   Bx By Bz                           tesla, nx * ny * nz lines,
+///   ...                                x fastest, then y, then z
+///
+/// The three components of a node are stored next to each other, as
+/// floats, and the nodes in the file order: the two x neighbours of a
+/// cell corner are contiguous. The map is loaded once, on the master, and
+/// shared read-only by the fields of all threads (see TabulatedField).
+
+class FieldMap
+{
+  public:
+    FieldMap() = default;
+    ~FieldMap() = default;
+
+    G4bool Load(const G4String& fileName);
+    G4bool IsLoaded() const { return !fField.empty(); }
+
+    G4int GetNx() const { return fNx; }
+    G4int GetNy() const { return fNy; }
+    G4int GetNz() const { return fNz; }
+    G4double GetMin(G4int axis) const { return fMin[axis]; }
+    G4double GetInverseStep(G4int axis) const { return fInverseStep[axis]; }
+    std::size_t GetMemorySize() const { return fField.size() * sizeof(float); }
+
+    // Field of a node, Geant4 units
+    const float* GetNode(G4int ix, G4int iy, G4int iz) const
+    {
+      return &fField[3 * ((std::size_t(iz) * fNy + iy) * fNx + ix)];
+    }
+
+  private:
+    G4int fNx = 0;
+    G4int fNy = 0;
+    G4int fNz = 0;
+    G4double fMin[3] = {0., 0., 0.};
+    G4double fInverseStep[3] = {0., 0., 0.};
+    std::vector<float> fField;
+};
+
+}  // namespace B2a
+
+#endif
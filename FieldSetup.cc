@@ -0,0 +1,165 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file FieldSetup.cc
+/// \brief Implementation of the B2a::FieldSetup class
+
+#include "FieldSetup.hh"
+
+#include "FieldMap.hh"
+#include "TabulatedField.hh"
+
+#include "G4BogackiShampine23.hh"
+#include "G4BogackiShampine45.hh"
+#include "G4CashKarpRKF45.hh"
+#include "G4ChordFinder.hh"
+#include "G4ClassicalRK4.hh"
+#include "G4DormandPrince745.hh"
+#include "G4FieldManager.hh"
+#include "G4HelixExplicitEuler.hh"
+#include "G4HelixImplicitEuler.hh"
+#include "G4LogicalVolume.hh"
+#include "G4Mag_UsualEqRhs.hh"
+#include "G4PropagatorInField.hh"
+#include "G4SimpleHeum.hh"
+#include "G4Threading.hh"
+#include "G4TransportationManager.hh"
+#include "G4TsitourasRK45.hh"
+#include "G4UniformMagField.hh"
+#include "G4UnitsTable.hh"
+
+namespace B2a
+{
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+FieldSetup::FieldSetup(const FieldParameters* parameters, const FieldMap* map)
+  : fParameters(parameters), fMap(map)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+FieldSetup::~FieldSetup()
+{
+  Clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const char* FieldSetup::GetStepperNames()
+{
+  return "ClassicalRK4 SimpleHeum CashKarpRKF45 BogackiShampine23 BogackiShampine45 "
+         "DormandPrince745 TsitourasRK45 HelixExplicitEuler HelixImplicitEuler";
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void FieldSetup::Configure(G4LogicalVolume* trackerLV)
+{
+  // the previous objects belong to the logical volume of the previous
+  // geometry, deleted by the rebuild
+  Clear();
+
+  if (fParameters->largestStep > 0.) {
+    G4TransportationManager::GetTransportationManager()
+      ->GetPropagatorInField()
+      ->SetLargestAcceptableStep(fParameters->largestStep);
+  }
+
+  if (fMap->IsLoaded()) {
+    fField = new TabulatedField(fMap);
+  }
+  else if (fParameters->uniform.mag2() > 0.) {
+    fField = new G4UniformMagField(fParameters->uniform);
+  }
+  else {
+    return;
+  }
+
+  fEquation = new G4Mag_UsualEqRhs(fField);
+  fStepper = CreateStepper();
+  fChordFinder = new G4ChordFinder(fField, fParameters->minStep, fStepper);
+  fChordFinder->SetDeltaChord(fParameters->deltaChord);
+
+  fFieldManager = new G4FieldManager(fField, fChordFinder);
+  fFieldManager->SetDeltaIntersection(fParameters->deltaIntersection);
+  fFieldManager->SetDeltaOneStep(fParameters->deltaOneStep);
+  fFieldManager->SetMinimumEpsilonStep(fParameters->minEpsilonStep);
+  fFieldManager->SetMaximumEpsilonStep(fParameters->maxEpsilonStep);
+
+  // the field manager of a logical volume is thread-local
+  trackerLV->SetFieldManager(fFieldManager, true);
+
+  if (G4Threading::IsMasterThread()) {
+    G4cout << G4endl << "----> Tracker field: "
+           << (fMap->IsLoaded() ? G4String("field map") : G4String("uniform"))
+           << ", stepper " << fParameters->stepper << ", delta chord "
+           << G4BestUnit(fParameters->deltaChord, "Length") << ", delta intersection "
+           << G4BestUnit(fParameters->deltaIntersection, "Length") << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4MagIntegratorStepper* FieldSetup::CreateStepper() const
+{
+  const auto& name = fParameters->stepper;
+  if (name == "ClassicalRK4") return new G4ClassicalRK4(fEquation);
+  if (name == "SimpleHeum") return new G4SimpleHeum(fEquation);
+  if (name == "CashKarpRKF45") return new G4CashKarpRKF45(fEquation);
+  if (name == "BogackiShampine23") return new G4BogackiShampine23(fEquation);
+  if (name == "BogackiShampine45") return new G4BogackiShampine45(fEquation);
+  if (name == "TsitourasRK45") return new G4TsitourasRK45(fEquation);
+  if (name == "HelixExplicitEuler") return new G4HelixExplicitEuler(fEquation);
+  if (name == "HelixImplicitEuler") return new G4HelixImplicitEuler(fEquation);
+  if (name != "DormandPrince745") {
+    G4ExceptionDescription msg;
+    msg << "Unknown stepper " << name << ", DormandPrince745 is used";
+    G4Exception("FieldSetup::CreateStepper()", "B2aField004", JustWarning, msg);
+  }
+  return new G4DormandPrince745(fEquation);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void FieldSetup::Clear()
+{
+  // the chord finder does not own a stepper given to it
+  delete fFieldManager;
+  delete fChordFinder;
+  delete fStepper;
+  delete fEquation;
+  delete fField;
+  fFieldManager = nullptr;
+  fChordFinder = nullptr;
+  fStepper = nullptr;
+  fEquation = nullptr;
+  fField = nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}  // namespace B2a
@@ -0,0 +1,100 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file FieldSetup.hh
+/// \brief Definition of the B2a::FieldSetup class
+
+#ifndef B2aFieldSetup_h
+#define B2aFieldSetup_h 1
+
+#include "CLHEP/Units/SystemOfUnits.h"
+#include "G4ThreeVector.hh"
+#include "globals.hh"
+
+class G4ChordFinder;
+class G4FieldManager;
+class G4LogicalVolume;
+class G4MagIntegratorStepper;
+class G4Mag_UsualEqRhs;
+class G4MagneticField;
+
+namespace B2a
+{
+
+class FieldMap;
+
+/// Settings of the tracker field, shared by the setups of all threads;
+/// they are only changed in Idle state, from the master, and applied at
+/// the next geometry construction. The defaults are the ones of Geant4.
+struct FieldParameters {
+  G4ThreeVector uniform;  // used when no map is loaded; zero: no field
+  G4String stepper = "DormandPrince745";
+  G4double minStep = 0.01 * CLHEP::mm;  // of the chord finder
+  G4double deltaChord = 0.25 * CLHEP::mm;
+  G4double deltaIntersection = 0.001 * CLHEP::mm;
+  G4double deltaOneStep = 0.01 * CLHEP::mm;
+  G4double minEpsilonStep = 5.0e-5;
+  G4double maxEpsilonStep = 1.0e-3;
+  G4double largestStep = 0.;  // of the propagator; <= 0: Geant4 default
+};
+
+/// Magnetic field of the tracker volume, one instance per thread.
+///
+/// The field is the FieldMap when it is loaded (a TabulatedField of this
+/// thread on the shared map), else the uniform field of the parameters.
+/// Configure() (re)builds the field, equation, stepper and chord finder
+/// from the current parameters and attaches the field manager to the
+/// tracker volume and its daughters. Without any field, nothing is
+/// attached and the global field (/globalField/) applies.
+
+class FieldSetup
+{
+  public:
+    FieldSetup(const FieldParameters* parameters, const FieldMap* map);
+    ~FieldSetup();
+
+    void Configure(G4LogicalVolume* trackerLV);
+
+    // stepper names accepted by the parameters
+    static const char* GetStepperNames();
+
+  private:
+    G4MagIntegratorStepper* CreateStepper() const;
+    void Clear();
+
+    const FieldParameters* fParameters = nullptr;
+    const FieldMap* fMap = nullptr;
+
+    G4MagneticField* fField = nullptr;
+    G4Mag_UsualEqRhs* fEquation = nullptr;
+    G4MagIntegratorStepper* fStepper = nullptr;
+    G4ChordFinder* fChordFinder = nullptr;
+    G4FieldManager* fFieldManager = nullptr;
+};
+
+}  // namespace B2a
+
+#endif
@@ -0,0 +1,127 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file FilterMessenger.cc
+/// \brief Implementation of the B2a::FilterMessenger class
+
+#include "FilterMessenger.hh"
+
+#include "AcceptanceFilter.hh"
+
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UIdirectory.hh"
+
+namespace B2a
+{
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+FilterMessenger::FilterMessenger(AcceptanceFilter* filter) : fFilter(filter)
+{
+  fDirectory = new G4UIdirectory("/B2/filter/");
+  fDirectory->SetGuidance("Acceptance filter: kill the tracks which cannot reach a layer");
+
+  fEnableCmd = new G4UIcmdWithABool("/B2/filter/enable", this);
+  fEnableCmd->SetGuidance("Kill the new tracks, and the tracks entering a volume,");
+  fEnableCmd->SetGuidance("which cannot reach any layer; defer those which can only");
+  fEnableCmd->SetGuidance("reach it by scattering to the end of the event.");
+  fEnableCmd->SetParameterName("enabled", true);
+  fEnableCmd->SetDefaultValue(true);
+  fEnableCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fAbortEventsCmd = new G4UIcmdWithABool("/B2/filter/abortEvents", this);
+  fAbortEventsCmd->SetGuidance("End the event when only deferred tracks are left,");
+  fAbortEventsCmd->SetGuidance("instead of tracking them (approximation: their");
+  fAbortEventsCmd->SetGuidance("scattered secondaries are lost).");
+  fAbortEventsCmd->SetParameterName("abort", true);
+  fAbortEventsCmd->SetDefaultValue(true);
+  fAbortEventsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fChargedEnergyCmd = new G4UIcmdWithADoubleAndUnit("/B2/filter/chargedEnergy", this);
+  fChargedEnergyCmd->SetGuidance("Kinetic energy above which charged particles are assumed");
+  fChargedEnergyCmd->SetGuidance("to go straight (ignored with a magnetic field).");
+  fChargedEnergyCmd->SetParameterName("energy", false);
+  fChargedEnergyCmd->SetRange("energy>=0.");
+  fChargedEnergyCmd->SetUnitCategory("Energy");
+  fChargedEnergyCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fRangeEnergyCmd = new G4UIcmdWithADoubleAndUnit("/B2/filter/rangeEnergy", this);
+  fRangeEnergyCmd->SetGuidance("Kinetic energy below which charged particles stopping");
+  fRangeEnergyCmd->SetGuidance("in a passive volume are killed.");
+  fRangeEnergyCmd->SetParameterName("energy", false);
+  fRangeEnergyCmd->SetRange("energy>=0.");
+  fRangeEnergyCmd->SetUnitCategory("Energy");
+  fRangeEnergyCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fMarginCmd = new G4UIcmdWithADoubleAndUnit("/B2/filter/margin", this);
+  fMarginCmd->SetGuidance("Safety margin around the layers for the straight line test.");
+  fMarginCmd->SetParameterName("margin", false);
+  fMarginCmd->SetRange("margin>=0.");
+  fMarginCmd->SetUnitCategory("Length");
+  fMarginCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+FilterMessenger::~FilterMessenger()
+{
+  delete fEnableCmd;
+  delete fAbortEventsCmd;
+  delete fChargedEnergyCmd;
+  delete fRangeEnergyCmd;
+  delete fMarginCmd;
+  delete fDirectory;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void FilterMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+  if (command == fEnableCmd) {
+    fFilter->SetEnabled(fEnableCmd->GetNewBoolValue(newValue));
+  }
+
+  if (command == fAbortEventsCmd) {
+    fFilter->SetAbortEvents(fAbortEventsCmd->GetNewBoolValue(newValue));
+  }
+
+  if (command == fChargedEnergyCmd) {
+    fFilter->SetChargedEnergy(fChargedEnergyCmd->GetNewDoubleValue(newValue));
+  }
+
+  if (command == fRangeEnergyCmd) {
+    fFilter->SetRangeEnergy(fRangeEnergyCmd->GetNewDoubleValue(newValue));
+  }
+
+  if (command == fMarginCmd) {
+    fFilter->SetMargin(fMarginCmd->GetNewDoubleValue(newValue));
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}  // namespace B2a
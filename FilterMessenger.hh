@@ -0,0 +1,80 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file FilterMessenger.hh
+/// \brief Definition of the B2a::FilterMessenger class
+
+#ifndef B2aFilterMessenger_h
+#define B2aFilterMessenger_h 1
+
+#include "G4UImessenger.hh"
+
+class G4UIdirectory;
+class G4UIcmdWithABool;
+class G4UIcmdWithADoubleAndUnit;
+class G4UIcommand;
+
+namespace B2a
+{
+
+class AcceptanceFilter;
+
+/// Messenger class that defines commands for the AcceptanceFilter.
+///
+/// It implements commands:
+/// - /B2/filter/enable true|false
+/// - /B2/filter/abortEvents true|false
+/// - /B2/filter/chargedEnergy value unit
+/// - /B2/filter/rangeEnergy value unit
+/// - /B2/filter/margin value unit
+///
+/// A messenger exists on each thread processing events (the commands are
+/// broadcast), each one configuring the filter of its own thread; the
+/// commands are so only defined after /run/initialize.
+
+class FilterMessenger : public G4UImessenger
+{
+  public:
+    FilterMessenger(AcceptanceFilter*);
+    ~FilterMessenger() override;
+
+    void SetNewValue(G4UIcommand*, G4String) override;
+
+  private:
+    AcceptanceFilter* fFilter = nullptr;
+
+    G4UIdirectory* fDirectory = nullptr;
+
+    G4UIcmdWithABool* fEnableCmd = nullptr;
+    G4UIcmdWithABool* fAbortEventsCmd = nullptr;
+    G4UIcmdWithADoubleAndUnit* fChargedEnergyCmd = nullptr;
+    G4UIcmdWithADoubleAndUnit* fRangeEnergyCmd = nullptr;
+    G4UIcmdWithADoubleAndUnit* fMarginCmd = nullptr;
+};
+
+}  // namespace B2a
+
+#endif
@@ -0,0 +1,60 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file FnvHash.hh
+/// \brief Definition of the B2a::FnvHash function
+
+#ifndef B2aFnvHash_h
+#define B2aFnvHash_h 1
+
+#include "globals.hh"
+
+#include <cstdint>
+#include <sstream>
+
+namespace B2a
+{
+
+/// 64 bit FNV-1a hash of a text, in hexadecimal.
+///
+/// Used to name cache entries: unlike std::hash it is the same for all
+/// compilers, platforms and runs.
+
+inline G4String FnvHash(const G4String& text)
+{
+  std::uint64_t hash = 14695981039346656037ULL;
+  for (unsigned char c : text) {
+    hash ^= c;
+    hash *= 1099511628211ULL;
+  }
+  std::ostringstream os;
+  os << std::hex << hash;
+  return os.str();
+}
+
+}  // namespace B2a
+
+#endif
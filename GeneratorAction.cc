@@ -0,0 +1,232 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file GeneratorAction.cc
+/// \brief Implementation of the B2a::GeneratorAction class
+
+#include "GeneratorAction.hh"
+
+#include "CheckpointManager.hh"
+#include "DetectorConstruction.hh"
+#include "PhaseSpaceReader.hh"
+#include "PrimaryGeneratorAction.hh"
+#include "ShardDriver.hh"
+
+#include "G4Box.hh"
+#include "G4Event.hh"
+#include "G4LogicalVolume.hh"
+#include "G4LogicalVolumeStore.hh"
+#include "G4ParticleGun.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4PrimaryParticle.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4RunManager.hh"
+#include "Randomize.hh"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+
+// integral of E^-slope over [eMin, eMax]
+G4double PowerLawIntegral(G4double slope, G4double eMin, G4double eMax)
+{
+  if (std::abs(slope - 1.) < 1.e-9) return std::log(eMax / eMin);
+  G4double a = 1. - slope;
+  return (std::pow(eMax, a) - std::pow(eMin, a)) / a;
+}
+
+// E^-slope over [eMin, eMax], by inversion of its cumulative
+G4double SamplePowerLaw(G4double slope, G4double eMin, G4double eMax)
+{
+  G4double u = G4UniformRand();
+  if (std::abs(slope - 1.) < 1.e-9) return eMin * std::pow(eMax / eMin, u);
+  G4double a = 1. - slope;
+  G4double low = std::pow(eMin, a);
+  return std::pow(low + u * (std::pow(eMax, a) - low), 1. / a);
+}
+
+// uniform in solid angle within the cone cos(theta) > cosAlpha around +z
+G4ThreeVector SampleCone(G4double cosAlpha)
+{
+  G4double cosTheta = 1. - G4UniformRand() * (1. - cosAlpha);
+  G4double sinTheta = std::sqrt(std::max(0., 1. - cosTheta * cosTheta));
+  G4double phi = twopi * G4UniformRand();
+  return {sinTheta * std::cos(phi), sinTheta * std::sin(phi), cosTheta};
+}
+
+}  // namespace
+
+namespace B2a
+{
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+GeneratorAction::GeneratorAction(const PhaseSpaceReader* phaseSpace,
+                                 const SourceParameters* source)
+  : fPhaseSpace(phaseSpace), fSource(source)
+{
+  fGun = new B2::PrimaryGeneratorAction;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+GeneratorAction::~GeneratorAction()
+{
+  delete fGun;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void GeneratorAction::GeneratePrimaries(G4Event* event)
+{
+  // sharded job: the event takes its number in the logical run, and its
+  // seeds do not depend on the thread or shard processing it
+  auto shard = ShardDriver::GetInstance();
+  if (shard) event->SetEventID(shard->GetFirstEvent() + event->GetEventID());
+
+  // resumed run: the events of the checkpoint are left empty; the
+  // events of a checkpointed run are seeded as those of a sharded job
+  auto checkpoint = CheckpointManager::GetInstance();
+  if (checkpoint && checkpoint->IsRestored(event->GetEventID())) return;
+
+  G4int runID = G4RunManager::GetRunManager()->GetCurrentRun()->GetRunID();
+  if (shard) {
+    shard->SeedEvent(runID, event->GetEventID());
+  }
+  else if (checkpoint && checkpoint->IsEnabled()) {
+    checkpoint->SeedEvent(runID, event->GetEventID());
+  }
+
+  if (!fPhaseSpace->IsOpen()) {
+    // the gun keeps the beam of the /gun/ commands between events
+    auto gun = fGun->GetParticleGun();
+    G4ThreeVector beamDirection = gun->GetParticleMomentumDirection();
+    G4double beamEnergy = gun->GetParticleEnergy();
+
+    G4ThreeVector direction = beamDirection;
+    G4double energy = beamEnergy;
+    G4double weight = SampleDirection(direction) * SampleEnergy(energy);
+
+    gun->SetParticleMomentumDirection(direction);
+    gun->SetParticleEnergy(energy);
+    fGun->GeneratePrimaries(event);
+    gun->SetParticleMomentumDirection(beamDirection);
+    gun->SetParticleEnergy(beamEnergy);
+
+    if (weight != 1.) {
+      auto vertex = event->GetPrimaryVertex();
+      for (G4int i = 0; i < vertex->GetNumberOfParticle(); ++i) {
+        vertex->GetPrimary(i)->SetWeight(weight);
+      }
+    }
+    return;
+  }
+
+  auto runManager = G4RunManager::GetRunManager();
+  auto detector =
+    static_cast<const DetectorConstruction*>(runManager->GetUserDetectorConstruction());
+  G4double planeZ = detector->GetTargetExtent().zMax + PhaseSpace::kPlaneOffset;
+
+  if (!fPhaseSpace->GeneratePrimaries(event, planeZ)) {
+    G4ExceptionDescription msg;
+    msg << "The " << fPhaseSpace->GetNbOfEvents()
+        << " recorded events were all replayed, the run is stopped (see /B2/source/recycle)";
+    G4Exception("GeneratorAction::GeneratePrimaries()", "B2aPhsp006", JustWarning, msg);
+    runManager->AbortRun(true);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double GeneratorAction::SampleDirection(G4ThreeVector& direction) const
+{
+  G4double coneAngle = fSource->coneAngle;
+  if (coneAngle <= 0.) return 1.;  // the direction of the gun
+
+  G4double cosCone = std::cos(coneAngle);
+  G4double biasAngle = fSource->biased ? std::min(GetBiasConeAngle(), coneAngle) : 0.;
+  if (biasAngle <= 0. || biasAngle >= coneAngle) {
+    direction = SampleCone(cosCone);
+    return 1.;
+  }
+
+  // mixture of the bias cone and of the whole cone
+  G4double cosBias = std::cos(biasAngle);
+  G4double fraction = fSource->biasConeFraction;
+  direction = SampleCone(G4UniformRand() < fraction ? cosBias : cosCone);
+
+  // densities per unit solid angle, up to the common factor 1/2pi
+  G4double p = 1. / (1. - cosCone);
+  G4double q = (1. - fraction) * p;
+  if (direction.z() >= cosBias) q += fraction / (1. - cosBias);
+  return p / q;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double GeneratorAction::SampleEnergy(G4double& energy) const
+{
+  G4double eMin = fSource->minEnergy;
+  G4double eMax = fSource->maxEnergy;
+  if (eMin <= 0. || eMax <= eMin) return 1.;  // the energy of the gun
+
+  G4double slope = fSource->spectrumSlope;
+  if (!fSource->biased) {
+    energy = SamplePowerLaw(slope, eMin, eMax);
+    return 1.;
+  }
+
+  G4double biasSlope = fSource->biasSpectrumSlope;
+  energy = SamplePowerLaw(biasSlope, eMin, eMax);
+  G4double p = std::pow(energy, -slope) / PowerLawIntegral(slope, eMin, eMax);
+  G4double q = std::pow(energy, -biasSlope) / PowerLawIntegral(biasSlope, eMin, eMax);
+  return p / q;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double GeneratorAction::GetBiasConeAngle() const
+{
+  if (fSource->biasConeAngle > 0.) return fSource->biasConeAngle;
+
+  // the beam starts at the upstream face of the world (see B2)
+  auto detector = static_cast<const DetectorConstruction*>(
+    G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+  const auto& layers = detector->GetLayerExtents();
+  auto worldLV = G4LogicalVolumeStore::GetInstance()->GetVolume("World", false);
+  auto worldBox = worldLV ? dynamic_cast<G4Box*>(worldLV->GetSolid()) : nullptr;
+  if (layers.empty() || worldBox == nullptr) return 0.;
+
+  // cone through the corners of the first layer
+  G4double distance = layers.front().zMin + worldBox->GetZHalfLength();
+  return std::atan(std::sqrt(2.) * detector->GetLayerHalfWidth() / distance);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}  // namespace B2a
@@ -0,0 +1,104 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file GeneratorAction.hh
+/// \brief Definition of the B2a::GeneratorAction class
+
+#ifndef B2aGeneratorAction_h
+#define B2aGeneratorAction_h 1
+
+#include "G4VUserPrimaryGeneratorAction.hh"
+#include "G4ThreeVector.hh"
+#include "globals.hh"
+
+namespace B2
+{
+class PrimaryGeneratorAction;
+}
+
+namespace B2a
+{
+
+class PhaseSpaceReader;
+
+// Physical source around the beam of the example and its biased sampling
+// (/B2/source/ commands), shared by the generators of all threads
+struct SourceParameters
+{
+    G4double coneAngle = 0.;  // half angle around +z, 0: pencil beam
+    G4double spectrumSlope = 2.;  // dN/dE ~ E^-slope
+    G4double minEnergy = 0.;  // 0: the energy of the gun
+    G4double maxEnergy = 0.;
+
+    G4bool biased = false;
+    G4double biasConeAngle = 0.;  // 0: acceptance of the first layer
+    G4double biasConeFraction = 0.9;  // of the primaries shot in the bias cone
+    G4double biasSpectrumSlope = 1.;
+};
+
+/// Primary generator action, one per thread.
+///
+/// When a phase space is replayed (/B2/source/replay), the particles of
+/// the recorded event start just downstream of the target, which is then
+/// not tracked at all (see PhaseSpaceReader); otherwise the beam of the
+/// example (B2::PrimaryGeneratorAction, /gun/ commands) is shot.
+///
+/// The beam direction can be spread uniformly in solid angle within a cone
+/// and its energy sampled from a power law. With /B2/source/bias/enable the
+/// same source is sampled from a biased density q instead of the physical
+/// one p: a fraction of the primaries is shot within a narrow cone (by
+/// default the acceptance of the first layer) and the energy follows a
+/// harder power law. The primaries then carry the weight p/q, which the
+/// hits, the trigger counters and the scores of the Run inherit, so that
+/// the weighted estimates stay unbiased.
+///
+/// In a sharded job (see ShardDriver) each event is renumbered in the
+/// logical run and reseeded before its primaries are generated; in a
+/// checkpointed run (see CheckpointManager) it is reseeded as well, and
+/// left without primaries if it is restored from the checkpoint.
+
+class GeneratorAction : public G4VUserPrimaryGeneratorAction
+{
+  public:
+    GeneratorAction(const PhaseSpaceReader* phaseSpace, const SourceParameters* source);
+    ~GeneratorAction() override;
+
+    void GeneratePrimaries(G4Event*) override;
+
+  private:
+    // sample a direction or an energy, return the density ratio p/q
+    G4double SampleDirection(G4ThreeVector& direction) const;
+    G4double SampleEnergy(G4double& energy) const;
+    G4double GetBiasConeAngle() const;
+
+    B2::PrimaryGeneratorAction* fGun = nullptr;
+    const PhaseSpaceReader* fPhaseSpace = nullptr;  // shared
+    const SourceParameters* fSource = nullptr;  // shared
+};
+
+}  // namespace B2a
+
+#endif
@@ -0,0 +1,162 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file HistoMessenger.cc
+/// \brief Implementation of the B2a::HistoMessenger class
+
+#include "HistoMessenger.hh"
+
+#include "OnlineHistograms.hh"
+
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithoutParameter.hh"
+#include "G4UIcommand.hh"
+#include "G4UIdirectory.hh"
+#include "G4UIparameter.hh"
+
+#include <sstream>
+
+namespace B2a
+{
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+HistoMessenger::HistoMessenger(OnlineHistograms* histograms) : fHistograms(histograms)
+{
+  fDirectory = new G4UIdirectory("/B2/histo/");
+  fDirectory->SetGuidance("Histograms of the tracker accumulated during the run");
+
+  fEnableCmd = new G4UIcmdWithABool("/B2/histo/enable", this);
+  fEnableCmd->SetGuidance("Fill the histograms of each layer (default false):");
+  fEnableCmd->SetGuidance("deposit per event, depth profile and hit multiplicity.");
+  fEnableCmd->SetParameterName("enabled", true);
+  fEnableCmd->SetDefaultValue(true);
+  fEnableCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fFileCmd = new G4UIcmdWithAString("/B2/histo/file", this);
+  fFileCmd->SetGuidance("Binary file receiving the histograms of each run:");
+  fFileCmd->SetGuidance("  <name>_r<run>.b2hist (default name: histos)");
+  fFileCmd->SetGuidance("An empty name disables the file, the table is printed.");
+  fFileCmd->SetParameterName("name", true);
+  fFileCmd->SetDefaultValue("");
+  fFileCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  // Binning commands: layer set and number of bins, 0 removing the
+  // histograms of the set. A layer set is "all", a material name or
+  // layer numbers separated by commas.
+  auto makeBinningCmd = [this](const char* name, const char* guidance) {
+    auto cmd = new G4UIcommand(name, this);
+    cmd->SetGuidance(guidance);
+    cmd->SetGuidance("The layer set is \"all\", a material name or layer numbers");
+    cmd->SetGuidance("separated by commas; 0 bins removes the histograms.");
+    cmd->SetParameter(new G4UIparameter("layerSet", 's', false));
+    auto binsPrm = new G4UIparameter("nofBins", 'i', false);
+    binsPrm->SetParameterRange("nofBins>=0");
+    cmd->SetParameter(binsPrm);
+    cmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    return cmd;
+  };
+
+  fSpectrumCmd = makeBinningCmd("/B2/histo/setSpectrum",
+                                "Set the binning of the deposit per event in the layers.");
+  auto minPrm = new G4UIparameter("min", 'd', false);
+  minPrm->SetParameterRange("min>=0.");
+  fSpectrumCmd->SetParameter(minPrm);
+  auto maxPrm = new G4UIparameter("max", 'd', false);
+  maxPrm->SetParameterRange("max>0.");
+  fSpectrumCmd->SetParameter(maxPrm);
+  auto unitPrm = new G4UIparameter("unit", 's', true);
+  unitPrm->SetDefaultUnit("MeV");
+  fSpectrumCmd->SetParameter(unitPrm);
+
+  fDepthCmd = makeBinningCmd("/B2/histo/setDepth",
+                             "Set the bins of the depth profiles, over the layer thickness.");
+  fMultiplicityCmd = makeBinningCmd("/B2/histo/setMultiplicity",
+                                    "Set the bins, one hit wide, of the hit multiplicities.");
+
+  fClearBinningCmd = new G4UIcmdWithoutParameter("/B2/histo/clearBinning", this);
+  fClearBinningCmd->SetGuidance("Remove all the binning rules, the default ones included:");
+  fClearBinningCmd->SetGuidance("only the layers set afterwards are histogrammed.");
+  fClearBinningCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+HistoMessenger::~HistoMessenger()
+{
+  delete fEnableCmd;
+  delete fFileCmd;
+  delete fSpectrumCmd;
+  delete fDepthCmd;
+  delete fMultiplicityCmd;
+  delete fClearBinningCmd;
+  delete fDirectory;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void HistoMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+  if (command == fEnableCmd) {
+    fHistograms->SetEnabled(fEnableCmd->GetNewBoolValue(newValue));
+  }
+
+  if (command == fFileCmd) {
+    fHistograms->SetFileName(newValue);
+  }
+
+  if (command == fClearBinningCmd) {
+    fHistograms->ClearBinning();
+  }
+
+  if (command == fSpectrumCmd || command == fDepthCmd || command == fMultiplicityCmd) {
+    OnlineHistograms::Binning binning;
+    std::istringstream is(newValue);
+    is >> binning.layerSet >> binning.nofBins;
+    if (command == fSpectrumCmd) {
+      G4String unit;
+      is >> binning.min >> binning.max >> unit;
+      if (binning.max <= binning.min) {
+        G4cout << G4endl << "-->  WARNING from HistoMessenger : empty range " << newValue
+               << ", command ignored" << G4endl;
+        return;
+      }
+      binning.kind = OnlineHistograms::kSpectrum;
+      binning.min *= G4UIcommand::ValueOf(unit);
+      binning.max *= G4UIcommand::ValueOf(unit);
+    }
+    else {
+      binning.kind = (command == fDepthCmd) ? OnlineHistograms::kDepth
+                                            : OnlineHistograms::kMultiplicity;
+    }
+    fHistograms->AddBinning(binning);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}  // namespace B2a
@@ -0,0 +1,82 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file HistoMessenger.hh
+/// \brief Definition of the B2a::HistoMessenger class
+
+#ifndef B2aHistoMessenger_h
+#define B2aHistoMessenger_h 1
+
+#include "G4UImessenger.hh"
+
+class G4UIdirectory;
+class G4UIcmdWithABool;
+class G4UIcmdWithAString;
+class G4UIcmdWithoutParameter;
+class G4UIcommand;
+
+namespace B2a
+{
+
+class OnlineHistograms;
+
+/// Messenger class that defines commands for the OnlineHistograms.
+///
+/// It implements commands:
+/// - /B2/histo/enable true|false
+/// - /B2/histo/file name
+/// - /B2/histo/setSpectrum layerSet nofBins min max unit
+/// - /B2/histo/setDepth layerSet nofBins
+/// - /B2/histo/setMultiplicity layerSet nofBins
+/// - /B2/histo/clearBinning
+///
+/// A messenger exists on the master and on each worker (the commands are
+/// broadcast), each one configuring the histograms of its own thread.
+
+class HistoMessenger : public G4UImessenger
+{
+  public:
+    HistoMessenger(OnlineHistograms*);
+    ~HistoMessenger() override;
+
+    void SetNewValue(G4UIcommand*, G4String) override;
+
+  private:
+    OnlineHistograms* fHistograms = nullptr;
+
+    G4UIdirectory* fDirectory = nullptr;
+
+    G4UIcmdWithABool* fEnableCmd = nullptr;
+    G4UIcmdWithAString* fFileCmd = nullptr;
+    G4UIcommand* fSpectrumCmd = nullptr;
+    G4UIcommand* fDepthCmd = nullptr;
+    G4UIcommand* fMultiplicityCmd = nullptr;
+    G4UIcmdWithoutParameter* fClearBinningCmd = nullptr;
+};
+
+}  // namespace B2a
+
+#endif
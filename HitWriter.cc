@@ -0,0 +1,251 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file HitWriter.cc
+/// \brief Implementation of the B2a::HitWriter class
+
+#include "HitWriter.hh"
+
+#include "G4SystemOfUnits.hh"
+
+#include <algorithm>
+#include <cstring>
+
+namespace B2a
+{
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+HitWriter::~HitWriter()
+{
+  Close();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool HitWriter::Open(const G4String& fileName, G4int runID, G4int threadID,
+                       std::size_t chunkSize)
+{
+  Close();
+
+  fFile.open(fileName, std::ios::binary | std::ios::trunc);
+  if (!fFile) {
+    G4ExceptionDescription msg;
+    msg << "Cannot open hit file " << fileName;
+    G4Exception("HitWriter::Open()", "B2aOutput001", JustWarning, msg);
+    return false;
+  }
+
+  fFileName = fileName;
+  fChunkSize = std::max<std::size_t>(chunkSize, 1);
+  for (auto column : {&fEventID, &fLayer}) column->reserve(fChunkSize);
+  for (auto column : {&fEdep, &fX, &fY, &fZ, &fTime, &fWeight}) column->reserve(fChunkSize);
+  fNbOfHits = 0;
+  fNbOfBytes = 0;
+  fNbOfLostHits = 0;
+
+  char header[32] = {};
+  std::memcpy(header, "B2AHITS", 8);
+  std::uint32_t version = kVersion;
+  std::uint32_t headerSize = sizeof(header);
+  std::int32_t run = runID;
+  std::int32_t thread = threadID;
+  std::memcpy(header + 8, &version, 4);
+  std::memcpy(header + 12, &headerSize, 4);
+  std::memcpy(header + 16, &run, 4);
+  std::memcpy(header + 20, &thread, 4);
+  fFile.write(header, sizeof(header));
+  if (!fFile.good()) {
+    Fail("HitWriter::Open()");
+    return false;
+  }
+  fNbOfPendingHits = 0;
+  fNbOfPendingBytes = sizeof(header);
+
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void HitWriter::Close()
+{
+  if (!fFile.is_open()) return;
+
+  Flush();
+  if (!fFile.is_open()) return;
+  fFile.close();
+  if (fFile.fail()) {
+    Fail("HitWriter::Close()");
+    return;
+  }
+  Commit();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::size_t HitWriter::GetMemorySize() const
+{
+  return (fEventID.capacity() + fLayer.capacity()) * sizeof(std::int32_t)
+         + (fEdep.capacity() + fX.capacity() + fY.capacity() + fZ.capacity() + fTime.capacity()
+            + fWeight.capacity())
+             * sizeof(float);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::uint64_t HitWriter::Sync()
+{
+  if (!fFile.is_open()) return fNbOfBytes;
+
+  Flush();
+  if (!fFile.is_open()) return fNbOfBytes;
+  fFile.flush();
+  if (fFile.good()) {
+    Commit();
+  }
+  else {
+    Fail("HitWriter::Sync()");
+  }
+  return fNbOfBytes;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void HitWriter::Append(G4int eventID, G4int layer, G4double edep, const G4ThreeVector& pos,
+                       G4double time, G4double weight)
+{
+  // the rest of the event after a failed write
+  if (!fFile.is_open()) {
+    ++fNbOfLostHits;
+    return;
+  }
+
+  fEventID.push_back(eventID);
+  fLayer.push_back(layer);
+  fEdep.push_back(float(edep / MeV));
+  fX.push_back(float(pos.x() / mm));
+  fY.push_back(float(pos.y() / mm));
+  fZ.push_back(float(pos.z() / mm));
+  fTime.push_back(float(time / ns));
+  fWeight.push_back(float(weight));
+
+  if (fEventID.size() == fChunkSize) Flush();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void HitWriter::Fill(G4int eventID, const TrackerHitsCollection& hits)
+{
+  std::size_t nofHits = hits.entries();
+  for (std::size_t i = 0; i < nofHits; ++i) {
+    const auto hit = hits[i];
+    Append(eventID, hit->GetChamberNb(), hit->GetEdep(), hit->GetPos(), hit->GetTime(),
+           hit->GetWeight());
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void HitWriter::Fill(G4int eventID, const PixelHitsCollection& pixels)
+{
+  std::size_t nofHits = pixels.entries();
+  for (std::size_t i = 0; i < nofHits; ++i) {
+    Append(eventID, pixels.GetLayer(i), pixels.GetEdep(i), pixels.GetPosition(i),
+           pixels.GetTime(i), pixels.GetWeight(i));
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+template <typename T>
+void HitWriter::WriteColumn(const std::vector<T>& column)
+{
+  static_assert(sizeof(T) == 4, "columns are 4-byte wide");
+  fFile.write(reinterpret_cast<const char*>(column.data()), column.size() * sizeof(T));
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void HitWriter::Flush()
+{
+  if (fEventID.empty() || !fFile.is_open()) return;
+
+  std::uint32_t blockHeader[2] = {kBlockMagic, std::uint32_t(fEventID.size())};
+  fFile.write(reinterpret_cast<const char*>(blockHeader), sizeof(blockHeader));
+
+  WriteColumn(fEventID);
+  WriteColumn(fLayer);
+  WriteColumn(fEdep);
+  WriteColumn(fX);
+  WriteColumn(fY);
+  WriteColumn(fZ);
+  WriteColumn(fTime);
+  WriteColumn(fWeight);
+
+  if (fFile.good()) {
+    fNbOfPendingHits += fEventID.size();
+    fNbOfPendingBytes += sizeof(blockHeader) + fEventID.size() * kHitSize;
+  }
+  else {
+    Fail("HitWriter::Flush()", fEventID.size());
+  }
+
+  for (auto column : {&fEventID, &fLayer}) column->clear();
+  for (auto column : {&fEdep, &fX, &fY, &fZ, &fTime, &fWeight}) column->clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void HitWriter::Commit()
+{
+  fNbOfHits += fNbOfPendingHits;
+  fNbOfBytes += fNbOfPendingBytes;
+  fNbOfPendingHits = 0;
+  fNbOfPendingBytes = 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void HitWriter::Fail(const char* where, std::size_t nofBufferedHits)
+{
+  // the blocks written since the last flush may not have reached the file
+  std::uint64_t nofLostHits = fNbOfPendingHits + nofBufferedHits;
+  fNbOfLostHits += nofLostHits;
+  fNbOfPendingHits = 0;
+  fNbOfPendingBytes = 0;
+
+  G4ExceptionDescription msg;
+  msg << "Cannot write hit file " << fFileName << ": " << nofLostHits
+      << " hits lost, the file is closed; its first " << fNbOfBytes << " bytes hold "
+      << fNbOfHits << " hits";
+  G4Exception(where, "B2aOutput002", JustWarning, msg);
+
+  fFile.close();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}  // namespace B2a
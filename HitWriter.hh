@@ -0,0 +1,150 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file HitWriter.hh
+/// \brief Definition of the B2a::HitWriter class
+
+#ifndef B2aHitWriter_h
+#define B2aHitWriter_h 1
+
+#include "PixelHitsCollection.hh"
+#include "TrackerHit.hh"
+
+#include "globals.hh"
+
+#include <cstdint>
+#include <fstream>
+#include <vector>
+
+namespace B2a
+{
+
+/// Streaming writer of tracker hits in a columnar binary format.
+///
+/// Each thread owns its own writer and its own file, so no lock is taken
+/// on the event loop: hits are appended to per-column buffers and written
+/// as one block when the buffer holds chunkSize hits (and at Close()).
+///
+/// File layout (little endian, every field 4-byte aligned so that the
+/// file can be memory-mapped and the columns used in place):
+///
+///   file header, 32 bytes
+///     char     magic[8]      "B2AHITS\0"
+///     uint32   version       2
+///     uint32   headerSize    32
+///     int32    runID
+///     int32    threadID      -1 for the master/sequential thread
+///     uint64   reserved
+///   blocks, until end of file
+///     uint32   magic         0x4B4C4248 ("HBLK")
+///     uint32   nofHits       n
+///     int32    eventID[n]
+///     int32    layer[n]      layer (chamber copy) number
+///     float32  edep[n]       MeV
+///     float32  x[n], y[n], z[n]   mm
+///     float32  time[n]       ns
+///     float32  weight[n]     statistical weight (1 without biasing)
+///
+/// With a pixelated readout a hit is a non-empty pixel: the position is
+/// the pixel centre, in the middle plane of the layer, and the time that
+/// of its first deposit.
+///
+/// The stream is checked after each block and flush: a failed write
+/// (e.g. a full disk) is reported as a warning, the hits not yet flushed
+/// are lost and the file is closed. The counts are those of the blocks
+/// flushed to the file, which stays readable up to GetNbOfBytes().
+
+class HitWriter
+{
+  public:
+    static constexpr std::uint32_t kVersion = 2;
+    static constexpr std::uint32_t kBlockMagic = 0x4B4C4248;
+
+    HitWriter() = default;
+    ~HitWriter();
+
+    HitWriter(const HitWriter&) = delete;
+    HitWriter& operator=(const HitWriter&) = delete;
+
+    G4bool Open(const G4String& fileName, G4int runID, G4int threadID, std::size_t chunkSize);
+    void Close();
+    G4bool IsOpen() const { return fFile.is_open(); }
+    const G4String& GetFileName() const { return fFileName; }
+
+    // Write the buffered hits as a block: the file up to the returned
+    // size holds all the events filled so far (see CheckpointManager)
+    std::uint64_t Sync();
+
+    // Append all hits of an event
+    void Fill(G4int eventID, const TrackerHitsCollection& hits);
+    void Fill(G4int eventID, const PixelHitsCollection& pixels);
+
+    // Hits and bytes flushed to the file (by Sync() or Close()), hits
+    // lost by a failed write
+    std::uint64_t GetNbOfHits() const { return fNbOfHits; }
+    std::uint64_t GetNbOfBytes() const { return fNbOfBytes; }
+    std::uint64_t GetNbOfLostHits() const { return fNbOfLostHits; }
+
+    // Bytes of the column buffers (see MemoryMonitor)
+    std::size_t GetMemorySize() const;
+
+    // Bytes per hit in a block
+    static constexpr std::size_t kHitSize = 8 * 4;
+
+  private:
+    void Flush();
+    void Commit();  // the pending blocks are flushed
+    void Fail(const char* where, std::size_t nofBufferedHits = 0);
+    void Append(G4int eventID, G4int layer, G4double edep, const G4ThreeVector& pos, G4double time,
+                G4double weight);
+
+    template <typename T>
+    void WriteColumn(const std::vector<T>& column);
+
+    std::ofstream fFile;
+    G4String fFileName;
+    std::size_t fChunkSize = 0;
+
+    // per-column buffers
+    std::vector<std::int32_t> fEventID;
+    std::vector<std::int32_t> fLayer;
+    std::vector<float> fEdep;
+    std::vector<float> fX;
+    std::vector<float> fY;
+    std::vector<float> fZ;
+    std::vector<float> fTime;
+    std::vector<float> fWeight;
+
+    std::uint64_t fNbOfHits = 0;
+    std::uint64_t fNbOfBytes = 0;
+    std::uint64_t fNbOfPendingHits = 0;  // written to the stream, not flushed
+    std::uint64_t fNbOfPendingBytes = 0;
+    std::uint64_t fNbOfLostHits = 0;
+};
+
+}  // namespace B2a
+
+#endif
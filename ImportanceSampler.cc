@@ -0,0 +1,138 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file ImportanceSampler.cc
+/// \brief Implementation of the B2a::ImportanceSampler class
+
+#include "ImportanceSampler.hh"
+
+#include "DetectorConstruction.hh"
+#include "Run.hh"
+
+#include "G4DynamicParticle.hh"
+#include "G4RunManager.hh"
+#include "G4Step.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4Track.hh"
+#include "Randomize.hh"
+
+#include <algorithm>
+
+namespace B2a
+{
+
+namespace
+{
+// the boundary points are on the layer faces to the navigation tolerance:
+// the cell is taken slightly ahead of them
+constexpr G4double kLookAhead = 1. * um;
+}  // namespace
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool ImportanceSampler::Update()
+{
+  auto detector = static_cast<const DetectorConstruction*>(
+    G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+  const auto& layers = detector->GetLayerExtents();
+
+  fBoundaries.clear();
+  fImportances.assign(1, 1.);
+  fEnabled = false;
+  for (std::size_t i = 0; i < layers.size(); ++i) {
+    G4double importance = detector->GetLayerImportance((G4int)i);
+    fBoundaries.push_back(layers[i].zMin);
+    fImportances.push_back(importance);
+    fEnabled = fEnabled || importance != 1.;
+  }
+  if (!fEnabled) fImportances.clear();
+  return fEnabled;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int ImportanceSampler::GetCell(G4double z, G4double dirZ) const
+{
+  G4double zAhead = z + kLookAhead * dirZ;
+  return G4int(std::upper_bound(fBoundaries.begin(), fBoundaries.end(), zAhead)
+               - fBoundaries.begin());
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ImportanceSampler::Apply(const G4Step* step, G4TrackVector* secondaries, Run* run) const
+{
+  auto track = step->GetTrack();
+  if (track->GetTrackStatus() != fAlive) return;
+
+  // cell of this step and cell of the next one, whatever limited the step
+  auto preStepPoint = step->GetPreStepPoint();
+  auto postStepPoint = step->GetPostStepPoint();
+  G4int preCell =
+    GetCell(preStepPoint->GetPosition().z(), preStepPoint->GetMomentumDirection().z());
+  G4int postCell =
+    GetCell(postStepPoint->GetPosition().z(), postStepPoint->GetMomentumDirection().z());
+  if (postCell == preCell) return;
+
+  auto& counters = run->GetCellCounters(postCell);
+  G4double ratio = fImportances[postCell] / fImportances[preCell];
+  G4double weight = track->GetWeight() / ratio;
+
+  if (ratio < 1.) {
+    if (G4UniformRand() >= ratio) {
+      track->SetTrackStatus(fStopAndKill);
+      ++counters.killed;
+      return;
+    }
+    track->SetWeight(weight);
+    ++counters.entries;
+    counters.weight += weight;
+    return;
+  }
+
+  auto nofTracks = G4int(ratio);
+  if (G4UniformRand() < ratio - nofTracks) ++nofTracks;
+  track->SetWeight(weight);
+
+  // the copies start at the post-step point with the state of the track
+  for (G4int i = 1; i < nofTracks; ++i) {
+    auto particle = new G4DynamicParticle(*track->GetDynamicParticle());
+    particle->SetPrimaryParticle(nullptr);
+    auto copy = new G4Track(particle, track->GetGlobalTime(), track->GetPosition());
+    copy->SetWeight(weight);
+    copy->SetParentID(track->GetTrackID());
+    copy->SetCreatorProcess(track->GetCreatorProcess());
+    copy->SetTouchableHandle(postStepPoint->GetTouchableHandle());
+    secondaries->push_back(copy);
+  }
+  counters.entries += nofTracks;
+  counters.weight += nofTracks * weight;
+  counters.split += nofTracks - 1;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}  // namespace B2a
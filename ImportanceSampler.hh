@@ -0,0 +1,96 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file ImportanceSampler.hh
+/// \brief Definition of the B2a::ImportanceSampler class
+
+#ifndef B2aImportanceSampler_h
+#define B2aImportanceSampler_h 1
+
+#include "G4TrackVector.hh"
+#include "globals.hh"
+
+#include <vector>
+
+class G4Step;
+
+namespace B2a
+{
+
+class Run;
+
+/// Geometry importance sampling along the stack, one per thread (see
+/// SteppingAction).
+///
+/// The cells are slabs along z: cell 0 is upstream of the first layer,
+/// cell i + 1 extends from the upstream face of layer i to that of the
+/// next layer, with the importance of layer i (see
+/// DetectorConstruction::SetLayerImportance()). The cell of a step point
+/// is the one just ahead of it along its direction, so a step changes
+/// cells when its pre- and post-step points are in different cells,
+/// whether it ended on a boundary or turned back on one. There is one
+/// split or roulette per change of cell, with the importance ratio of
+/// the two cells, even if the step crossed several: a track moving to a
+/// cell of importance ratio r to its previous one is
+/// - split, for r > 1, into n = floor(r) or floor(r) + 1 tracks, on
+///   average r, each of weight w / r;
+/// - played Russian roulette, for r < 1: it survives with probability r
+///   and weight w / r.
+/// The expected weight is thus conserved, and the hits inherit the track
+/// weights. The copies start at the post-step point as secondaries of the
+/// split track.
+///
+/// The cells are read from the master detector construction at the start
+/// of each run; the random numbers come from the engine of the thread.
+
+class ImportanceSampler
+{
+  public:
+    ImportanceSampler() = default;
+    ~ImportanceSampler() = default;
+
+    // Read the cells of the current stack; false, and disabled, if all the
+    // importances are 1
+    G4bool Update();
+    G4bool IsEnabled() const { return fEnabled; }
+    G4int GetNbOfCells() const { return (G4int)fImportances.size(); }
+
+    // Split or roulette the track of the step if it changed cells;
+    // the copies are appended to the secondaries of the track
+    void Apply(const G4Step*, G4TrackVector* secondaries, Run*) const;
+
+  private:
+    // cell just ahead of a point moving along dirZ
+    G4int GetCell(G4double z, G4double dirZ) const;
+
+    std::vector<G4double> fBoundaries;  // upstream face of each layer
+    std::vector<G4double> fImportances;  // one per cell
+    G4bool fEnabled = false;
+};
+
+}  // namespace B2a
+
+#endif
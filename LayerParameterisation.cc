@@ -0,0 +1,75 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file LayerParameterisation.cc
+/// \brief Implementation of the B2a::LayerParameterisation class
+
+#include "LayerParameterisation.hh"
+
+#include "G4Box.hh"
+#include "G4ThreeVector.hh"
+#include "G4VPhysicalVolume.hh"
+
+namespace B2a
+{
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+LayerParameterisation::LayerParameterisation(G4double halfWidth,
+                                             const std::vector<G4double>& zPositions,
+                                             const std::vector<G4double>& halfThicknesses)
+  : fHalfWidth(halfWidth), fZPositions(zPositions), fHalfThicknesses(halfThicknesses)
+{
+  if (fZPositions.size() != fHalfThicknesses.size()) {
+    G4Exception("LayerParameterisation::LayerParameterisation()", "InvalidSetup",
+                FatalException, "Number of positions and thicknesses differ.");
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void LayerParameterisation::ComputeTransformation(const G4int copyNo,
+                                                  G4VPhysicalVolume* physVol) const
+{
+  // Note: copyNo will start with zero!
+  physVol->SetTranslation(G4ThreeVector(0, 0, fZPositions[copyNo]));
+  physVol->SetRotation(nullptr);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void LayerParameterisation::ComputeDimensions(G4Box& layer, const G4int copyNo,
+                                              const G4VPhysicalVolume*) const
+{
+  // Note: copyNo will start with zero!
+  layer.SetXHalfLength(fHalfWidth);
+  layer.SetYHalfLength(fHalfWidth);
+  layer.SetZHalfLength(fHalfThicknesses[copyNo]);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}  // namespace B2a
@@ -0,0 +1,72 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file LayerParameterisation.hh
+/// \brief Definition of the B2a::LayerParameterisation class
+
+#ifndef B2aLayerParameterisation_h
+#define B2aLayerParameterisation_h 1
+
+#include "G4VPVParameterisation.hh"
+#include "globals.hh"
+
+#include <vector>
+
+class G4Box;
+class G4VPhysicalVolume;
+
+namespace B2a
+{
+
+/// Parameterisation of a block of consecutive tracker layers of the same
+/// material.
+///
+/// The layers are square boxes of common transverse half width, placed
+/// along the z axis of their block envelope; each layer has its own
+/// thickness. Positions are relative to the envelope centre.
+
+class LayerParameterisation : public G4VPVParameterisation
+{
+  public:
+    LayerParameterisation(G4double halfWidth, const std::vector<G4double>& zPositions,
+                          const std::vector<G4double>& halfThicknesses);
+    ~LayerParameterisation() override = default;
+
+    void ComputeTransformation(const G4int copyNo, G4VPhysicalVolume* physVol) const override;
+
+    using G4VPVParameterisation::ComputeDimensions;
+    void ComputeDimensions(G4Box& layer, const G4int copyNo,
+                           const G4VPhysicalVolume* physVol) const override;
+
+  private:
+    G4double fHalfWidth = 0.;
+    std::vector<G4double> fZPositions;
+    std::vector<G4double> fHalfThicknesses;
+};
+
+}  // namespace B2a
+
+#endif
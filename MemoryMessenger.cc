@@ -0,0 +1,98 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file MemoryMessenger.cc
+/// \brief Implementation of the B2a::MemoryMessenger class
+
+#include "MemoryMessenger.hh"
+
+#include "MemoryMonitor.hh"
+
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithoutParameter.hh"
+#include "G4UIdirectory.hh"
+
+namespace B2a
+{
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+MemoryMessenger::MemoryMessenger(MemoryMonitor* monitor) : fMonitor(monitor)
+{
+  fDirectory = new G4UIdirectory("/B2/memory/");
+  fDirectory->SetGuidance("Memory accounting of the shared and thread-local data");
+
+  fPrintCmd = new G4UIcmdWithoutParameter("/B2/memory/print", this);
+  fPrintCmd->SetGuidance("Print the memory of the process and of the threads of the last");
+  fPrintCmd->SetGuidance("run (also printed at the end of each run).");
+  fPrintCmd->AvailableForStates(G4State_Idle);
+  fPrintCmd->SetToBeBroadcasted(false);
+
+  fIntervalCmd = new G4UIcmdWithAnInteger("/B2/memory/interval", this);
+  fIntervalCmd->SetGuidance("Events of a thread between two samples of its allocator pools");
+  fIntervalCmd->SetGuidance("and buffers (default 1000); 0: only at the end of the run.");
+  fIntervalCmd->SetParameterName("nofEvents", false);
+  fIntervalCmd->SetRange("nofEvents>=0");
+  fIntervalCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fGrowthWarningCmd = new G4UIcmdWithAnInteger("/B2/memory/growthWarning", this);
+  fGrowthWarningCmd->SetGuidance("Warn when the memory of a thread grows in that many");
+  fGrowthWarningCmd->SetGuidance("successive sampling intervals (default 4); 0: never.");
+  fGrowthWarningCmd->SetParameterName("nofIntervals", false);
+  fGrowthWarningCmd->SetRange("nofIntervals>=0");
+  fGrowthWarningCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+MemoryMessenger::~MemoryMessenger()
+{
+  delete fPrintCmd;
+  delete fIntervalCmd;
+  delete fGrowthWarningCmd;
+  delete fDirectory;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void MemoryMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+  if (command == fPrintCmd) {
+    fMonitor->Print();
+  }
+
+  if (command == fIntervalCmd) {
+    fMonitor->SetInterval(fIntervalCmd->GetNewIntValue(newValue));
+  }
+
+  if (command == fGrowthWarningCmd) {
+    fMonitor->SetGrowthWarning(fGrowthWarningCmd->GetNewIntValue(newValue));
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}  // namespace B2a
@@ -0,0 +1,75 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file MemoryMessenger.hh
+/// \brief Definition of the B2a::MemoryMessenger class
+
+#ifndef B2aMemoryMessenger_h
+#define B2aMemoryMessenger_h 1
+
+#include "G4UImessenger.hh"
+
+class G4UIdirectory;
+class G4UIcmdWithAnInteger;
+class G4UIcmdWithoutParameter;
+
+namespace B2a
+{
+
+class MemoryMonitor;
+
+/// Messenger class that defines commands for the MemoryMonitor.
+///
+/// It implements commands:
+/// - /B2/memory/print
+/// - /B2/memory/interval nofEvents
+/// - /B2/memory/growthWarning nofIntervals
+///
+/// A messenger exists on the master and on each worker, each one
+/// configuring the monitor of its own thread; only /B2/memory/print,
+/// which reports all the threads, is not broadcast.
+
+class MemoryMessenger : public G4UImessenger
+{
+  public:
+    MemoryMessenger(MemoryMonitor*);
+    ~MemoryMessenger() override;
+
+    void SetNewValue(G4UIcommand*, G4String) override;
+
+  private:
+    MemoryMonitor* fMonitor = nullptr;
+
+    G4UIdirectory* fDirectory = nullptr;
+
+    G4UIcmdWithoutParameter* fPrintCmd = nullptr;
+    G4UIcmdWithAnInteger* fIntervalCmd = nullptr;
+    G4UIcmdWithAnInteger* fGrowthWarningCmd = nullptr;
+};
+
+}  // namespace B2a
+
+#endif
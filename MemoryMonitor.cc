@@ -0,0 +1,355 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file MemoryMonitor.cc
+/// \brief Implementation of the B2a::MemoryMonitor class
+
+#include "MemoryMonitor.hh"
+
+#include "DetectorConstruction.hh"
+#include "Digitizer.hh"
+#include "HitWriter.hh"
+#include "MemoryMessenger.hh"
+#include "OnlineHistograms.hh"
+#include "PhaseSpaceWriter.hh"
+#include "PixelHitsCollection.hh"
+#include "TrackerHit.hh"
+#include "VoxelScorer.hh"
+
+#include "G4AutoLock.hh"
+#include "G4DynamicParticle.hh"
+#include "G4Event.hh"
+#include "G4LogicalVolumeStore.hh"
+#include "G4PhysicalVolumeStore.hh"
+#include "G4RunManager.hh"
+#include "G4SolidStore.hh"
+#include "G4TouchableHistory.hh"
+#include "G4Track.hh"
+#include "G4Trajectory.hh"
+#include "G4TrajectoryContainer.hh"
+#include "G4TrajectoryPoint.hh"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+
+#ifndef _WIN32
+#  include <sys/resource.h>
+#  include <unistd.h>
+#endif
+
+namespace
+{
+const char* kPoolNames[] = {"G4Track",           "G4DynamicParticle", "G4TouchableHistory",
+                            "G4Trajectory",      "G4TrajectoryPoint", "G4Event",
+                            "TrackerHit"};
+
+// Bytes held by a pool of the thread, 0 if it was never used
+template <typename T>
+std::size_t PoolSize(const G4Allocator<T>* allocator)
+{
+  return allocator ? allocator->GetAllocatedSize() : 0;
+}
+
+G4double MB(G4double bytes)
+{
+  return bytes / 1048576.;
+}
+}  // namespace
+
+namespace B2a
+{
+
+std::vector<std::pair<G4String, G4double>> MemoryMonitor::fSharedPhases;
+std::vector<const MemoryMonitor*> MemoryMonitor::fWorkers;
+G4Mutex MemoryMonitor::fWorkersMutex = G4MUTEX_INITIALIZER;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+MemoryMonitor::MemoryMonitor(const HitWriter* hitWriter, const PhaseSpaceWriter* phaseSpaceWriter,
+                             const OnlineHistograms* histograms, const VoxelScorer* voxels,
+                             const Digitizer* digitizer)
+  : fHitWriter(hitWriter),
+    fPhaseSpaceWriter(phaseSpaceWriter),
+    fHistograms(histograms),
+    fVoxels(voxels),
+    fDigitizer(digitizer)
+{
+  fMessenger = new MemoryMessenger(this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+MemoryMonitor::~MemoryMonitor()
+{
+  delete fMessenger;
+
+  G4AutoLock lock(&fWorkersMutex);
+  for (auto& worker : fWorkers) {
+    if (worker == this) worker = nullptr;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double MemoryMonitor::GetCurrentRSS()
+{
+#ifdef __linux__
+  std::ifstream statm("/proc/self/statm");
+  long size = 0, resident = 0;
+  if (!(statm >> size >> resident)) return -1.;
+  return MB(G4double(resident) * sysconf(_SC_PAGESIZE));
+#else
+  return -1.;
+#endif
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double MemoryMonitor::GetPeakRSS()
+{
+#ifdef _WIN32
+  return -1.;
+#else
+  rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) return -1.;
+#  ifdef __APPLE__
+  return MB(usage.ru_maxrss);  // bytes
+#  else
+  return usage.ru_maxrss / 1024.;  // kB
+#  endif
+#endif
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void MemoryMonitor::RecordSharedPhase(const G4String& phase)
+{
+  fSharedPhases.emplace_back(phase, GetCurrentRSS());
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void MemoryMonitor::BeginOfRun(G4int runID)
+{
+  fRunID = runID;
+  fUsage = Usage();
+  fGrowingIntervals = 0;
+  fWarned = false;
+
+  if (G4Threading::IsWorkerThread()) {
+    auto threadID = (std::size_t)G4Threading::G4GetThreadId();
+    G4AutoLock lock(&fWorkersMutex);
+    if (fWorkers.size() <= threadID) fWorkers.resize(threadID + 1, nullptr);
+    fWorkers[threadID] = this;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void MemoryMonitor::EndOfEvent(const G4Event* event)
+{
+  std::size_t nofHits = 0;
+  std::size_t hitBytes = 0;
+  if (auto hce = event->GetHCofThisEvent()) {
+    for (G4int i = 0; i < hce->GetNumberOfCollections(); ++i) {
+      auto collection = hce->GetHC(i);
+      if (!collection) continue;
+      nofHits += collection->GetSize();
+      if (auto hits = dynamic_cast<const TrackerHitsCollection*>(collection)) {
+        hitBytes += hits->entries() * sizeof(TrackerHit)
+                    + hits->GetVector()->capacity() * sizeof(TrackerHit*);
+      }
+      else if (auto pixels = dynamic_cast<const PixelHitsCollection*>(collection)) {
+        hitBytes += pixels->GetMemorySize();
+      }
+    }
+  }
+  auto trajectories = event->GetTrajectoryContainer();
+  std::size_t nofTrajectories = trajectories ? trajectories->size() : 0;
+
+  ++fUsage.events;
+  fUsage.hits += nofHits;
+  fUsage.hitBytes += hitBytes;
+  fUsage.trajectories += nofTrajectories;
+  fUsage.maxHits = std::max(fUsage.maxHits, nofHits);
+  fUsage.maxHitBytes = std::max(fUsage.maxHitBytes, hitBytes);
+  fUsage.maxTrajectories = std::max(fUsage.maxTrajectories, nofTrajectories);
+
+  if (fInterval <= 0 || fUsage.events % fInterval != 0) return;
+
+  // the first sample of the run is the reference of the growth
+  std::size_t last = fUsage.poolsTotal + fUsage.buffers;
+  Sample();
+  G4bool grown = fUsage.events > fInterval && fUsage.poolsTotal + fUsage.buffers > last;
+  fGrowingIntervals = grown ? fGrowingIntervals + 1 : 0;
+
+  if (fGrowthWarning > 0 && fGrowingIntervals >= fGrowthWarning && !fWarned) {
+    fWarned = true;
+    G4String thread =
+      G4Threading::IsWorkerThread() ? std::to_string(G4Threading::G4GetThreadId()) : "master";
+    G4ExceptionDescription msg;
+    msg << "The allocations of thread " << thread << " grew in each of the last "
+        << fGrowingIntervals << " intervals of " << fInterval << " events, to "
+        << MB(fUsage.poolsTotal) << " MB in pools and " << MB(fUsage.buffers)
+        << " MB in buffers after " << fUsage.events << " events";
+    G4Exception("MemoryMonitor::EndOfEvent()", "B2aMemory001", JustWarning, msg);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void MemoryMonitor::Sample()
+{
+  auto& pools = fUsage.pools;
+  pools[kTrackPool] = PoolSize(aTrackAllocator());
+  pools[kDynamicParticlePool] = PoolSize(pDynamicParticleAllocator());
+  pools[kTouchablePool] = PoolSize(aTouchableHistoryAllocator());
+  pools[kTrajectoryPool] = PoolSize(aTrajectoryAllocator());
+  pools[kTrajectoryPointPool] = PoolSize(aTrajectoryPointAllocator());
+  pools[kEventPool] = PoolSize(anEventAllocator());
+  pools[kHitPool] = PoolSize(TrackerHitAllocator);
+
+  std::size_t poolsTotal = 0;
+  for (auto size : pools) poolsTotal += size;
+  std::size_t buffers = fHitWriter->GetMemorySize() + fPhaseSpaceWriter->GetMemorySize()
+                        + fHistograms->GetMemorySize() + fVoxels->GetMemorySize()
+                        + fDigitizer->GetMemorySize();
+
+  fUsage.poolsTotal = poolsTotal;
+  fUsage.poolsPeak = std::max(fUsage.poolsPeak, poolsTotal);
+  fUsage.buffers = buffers;
+  fUsage.buffersPeak = std::max(fUsage.buffersPeak, buffers);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void MemoryMonitor::EndOfRun()
+{
+  // also the threads without events (e.g. processing sub-events)
+  Sample();
+  if (!G4Threading::IsWorkerThread()) Print();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void MemoryMonitor::Print() const
+{
+  G4double rss = GetCurrentRSS();
+  G4double peakRSS = GetPeakRSS();
+  G4double shared = fSharedPhases.empty() ? 0. : fSharedPhases.back().second;
+
+  G4cout << G4endl << " Memory: " << rss << " MB resident, " << peakRSS << " MB peak" << G4endl
+         << "  shared, resident after the start-up phases:" << G4endl;
+  G4double previous = 0.;
+  for (const auto& phase : fSharedPhases) {
+    G4cout << "  " << std::setw(22) << std::left << phase.first << std::right << std::setw(10)
+           << phase.second << " MB (+" << phase.second - previous << ")" << G4endl;
+    previous = phase.second;
+  }
+
+  auto detector = static_cast<const DetectorConstruction*>(
+    G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+  G4cout << "  geometry: " << G4SolidStore::GetInstance()->size() << " solids, "
+         << G4LogicalVolumeStore::GetInstance()->size() << " logical and "
+         << G4PhysicalVolumeStore::GetInstance()->size() << " physical volumes; field map "
+         << MB(detector->GetFieldMap().GetMemorySize()) << " MB" << G4endl;
+
+  // The workers are between runs, or have ended the current one before
+  // the master: their usage is not modified during this call.
+  std::vector<std::pair<G4String, const Usage*>> threads;
+  {
+    G4AutoLock lock(&fWorkersMutex);
+    for (std::size_t i = 0; i < fWorkers.size(); ++i) {
+      auto worker = fWorkers[i];
+      if (!worker || worker->fRunID != fRunID) continue;
+      threads.emplace_back(std::to_string(i), &worker->fUsage);
+    }
+  }
+  // the master processes events in sequential and sub-event modes
+  if (!G4Threading::IsMultithreadedApplication() || fUsage.events > 0 || threads.empty()) {
+    threads.emplace_back("master", &fUsage);
+  }
+
+  G4double threadRSS = (rss >= 0. && !fSharedPhases.empty()) ? rss - shared : -1.;
+  G4cout << "  thread-local, resident beyond the start-up: " << threadRSS << " MB, "
+         << threadRSS / threads.size() << " MB per thread" << G4endl;
+
+  G4cout << G4endl << " Thread-local memory (MB; hit collections in kB per event)" << G4endl
+         << std::setw(8) << "thread" << std::setw(10) << "events" << std::setw(12) << "hits/event"
+         << std::setw(10) << "max" << std::setw(12) << "hit kB" << std::setw(10) << "max"
+         << std::setw(12) << "traj/event" << std::setw(10) << "pools" << std::setw(10) << "peak"
+         << std::setw(10) << "buffers" << std::setw(10) << "peak" << std::setw(10) << "total"
+         << G4endl;
+
+  std::size_t pools[kNbOfPools] = {};
+  std::size_t total = 0;
+  for (const auto& thread : threads) {
+    PrintThread(thread.first, *thread.second);
+    for (G4int i = 0; i < kNbOfPools; ++i) pools[i] += thread.second->pools[i];
+    total += thread.second->poolsTotal + thread.second->buffers + thread.second->maxHitBytes;
+  }
+
+  G4cout << "  allocator pools, all threads:";
+  for (G4int i = 0; i < kNbOfPools; ++i) {
+    if (pools[i] > 0) G4cout << " " << kPoolNames[i] << " " << MB(pools[i]);
+  }
+  G4cout << G4endl;
+
+  G4cout << "B2a-memory run=" << fRunID << " threads=" << threads.size() << " rss_MB=" << rss
+         << " peak_rss_MB=" << peakRSS << " shared_MB=" << shared
+         << " thread_rss_MB=" << threadRSS << " measured_MB=" << MB(total) << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void MemoryMonitor::PrintThread(const G4String& thread, const Usage& usage) const
+{
+  G4double events = std::max(usage.events, 1);
+  G4double hitsPerEvent = usage.hits / events;
+  G4double hitKB = usage.hitBytes / events / 1024.;
+  G4double total = usage.poolsTotal + usage.buffers + usage.maxHitBytes;
+  G4double peak = usage.poolsPeak + usage.buffersPeak + usage.maxHitBytes;
+
+  G4cout << std::setw(8) << thread << std::setw(10) << usage.events << std::setw(12)
+         << hitsPerEvent << std::setw(10) << usage.maxHits << std::setw(12) << hitKB
+         << std::setw(10) << usage.maxHitBytes / 1024. << std::setw(12)
+         << usage.trajectories / events << std::setw(10) << MB(usage.poolsTotal) << std::setw(10)
+         << MB(usage.poolsPeak) << std::setw(10) << MB(usage.buffers) << std::setw(10)
+         << MB(usage.buffersPeak) << std::setw(10) << MB(total) << G4endl
+         << "B2a-memthread run=" << fRunID << " thread=" << thread << " events=" << usage.events
+         << " hits_per_event=" << hitsPerEvent << " max_hits=" << usage.maxHits
+         << " hit_kB_per_event=" << hitKB << " max_hit_kB=" << usage.maxHitBytes / 1024.
+         << " trajectories_per_event=" << usage.trajectories / events
+         << " max_trajectories=" << usage.maxTrajectories << " pools_MB=" << MB(usage.poolsTotal)
+         << " pools_peak_MB=" << MB(usage.poolsPeak) << " buffers_MB=" << MB(usage.buffers)
+         << " buffers_peak_MB=" << MB(usage.buffersPeak) << " total_MB=" << MB(total)
+         << " total_peak_MB=" << MB(peak) << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}  // namespace B2a
@@ -0,0 +1,168 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file MemoryMonitor.hh
+/// \brief Definition of the B2a::MemoryMonitor class
+
+#ifndef B2aMemoryMonitor_h
+#define B2aMemoryMonitor_h 1
+
+#include "G4Threading.hh"
+#include "globals.hh"
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+class G4Event;
+
+namespace B2a
+{
+
+class Digitizer;
+class HitWriter;
+class MemoryMessenger;
+class OnlineHistograms;
+class PhaseSpaceWriter;
+class VoxelScorer;
+
+/// Memory accounting of the job, shared data versus thread-local data.
+///
+/// The shared data (geometry, physics tables, field map) is built by the
+/// master before the workers start: the process RSS is recorded after
+/// each start-up phase (see StartupProfiler), the RSS beyond the last
+/// one is attributed to the threads.
+///
+/// Each thread measures what it owns:
+/// - the G4Allocator pools of the thread (tracks, dynamic particles,
+///   trajectories, hits...), which keep their pages once allocated;
+/// - its output buffers, histograms and voxel table;
+/// - the hit collections and trajectories of each of its events.
+/// The pools and buffers are sampled every /B2/memory/interval events; a
+/// thread whose sample grows in each of /B2/memory/growthWarning
+/// successive intervals warns once per run, the pools of a steady job
+/// only growing with the largest event seen.
+///
+/// The master prints the report at the end of each run with events, and
+/// on demand with /B2/memory/print (Idle state), followed by a
+/// "B2a-memory" line and one "B2a-memthread" line per thread meant to be
+/// parsed by scripts. The threads of the report are those of the last
+/// run (in sequential mode, the master).
+///
+/// One instance per thread, owned by the RunAction, configured by its
+/// MemoryMessenger.
+
+class MemoryMonitor
+{
+  public:
+    // Pools of the thread's G4Allocators
+    enum Pool
+    {
+      kTrackPool = 0,
+      kDynamicParticlePool,
+      kTouchablePool,
+      kTrajectoryPool,
+      kTrajectoryPointPool,
+      kEventPool,
+      kHitPool,
+      kNbOfPools
+    };
+
+    MemoryMonitor(const HitWriter*, const PhaseSpaceWriter*, const OnlineHistograms*,
+                  const VoxelScorer*, const Digitizer*);
+    ~MemoryMonitor();
+
+    MemoryMonitor(const MemoryMonitor&) = delete;
+    MemoryMonitor& operator=(const MemoryMonitor&) = delete;
+
+    // Configuration
+    void SetInterval(G4int nofEvents) { fInterval = nofEvents; }
+    void SetGrowthWarning(G4int nofIntervals) { fGrowthWarning = nofIntervals; }
+
+    // All threads
+    void BeginOfRun(G4int runID);
+    void EndOfRun();  // the master prints the report
+
+    // Thread processing events: once the event is accounted
+    void EndOfEvent(const G4Event*);
+
+    // Master: the report of the last run, and the current process memory
+    void Print() const;
+
+    // Master: records the process RSS after a start-up phase
+    static void RecordSharedPhase(const G4String& phase);
+
+    // Resident set size of the process, current and peak, in MB (-1 if
+    // unknown)
+    static G4double GetCurrentRSS();
+    static G4double GetPeakRSS();
+
+  private:
+    struct Usage {
+      G4int events = 0;
+      std::size_t pools[kNbOfPools] = {};  // bytes, last sample
+      std::size_t poolsTotal = 0;
+      std::size_t poolsPeak = 0;
+      std::size_t buffers = 0;  // bytes, last sample
+      std::size_t buffersPeak = 0;
+      G4double hits = 0.;  // sums over the events
+      G4double hitBytes = 0.;
+      G4double trajectories = 0.;
+      std::size_t maxHits = 0;
+      std::size_t maxHitBytes = 0;
+      std::size_t maxTrajectories = 0;
+    };
+
+    void Sample();
+    void PrintThread(const G4String& thread, const Usage&) const;
+
+    G4int fInterval = 1000;  // events
+    G4int fGrowthWarning = 4;  // intervals, 0: no warning
+
+    const HitWriter* fHitWriter = nullptr;
+    const PhaseSpaceWriter* fPhaseSpaceWriter = nullptr;
+    const OnlineHistograms* fHistograms = nullptr;
+    const VoxelScorer* fVoxels = nullptr;
+    const Digitizer* fDigitizer = nullptr;
+
+    G4int fRunID = -1;
+    Usage fUsage;
+    G4int fGrowingIntervals = 0;
+    G4bool fWarned = false;
+
+    // Process RSS after each start-up phase (master)
+    static std::vector<std::pair<G4String, G4double>> fSharedPhases;
+
+    // Monitors of the workers, by thread ID
+    static std::vector<const MemoryMonitor*> fWorkers;
+    static G4Mutex fWorkersMutex;
+
+    MemoryMessenger* fMessenger = nullptr;
+};
+
+}  // namespace B2a
+
+#endif
@@ -0,0 +1,459 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file OnlineHistograms.cc
+/// \brief Implementation of the B2a::OnlineHistograms class
+
+#include "OnlineHistograms.hh"
+
+#include "DetectorConstruction.hh"
+#include "HistoMessenger.hh"
+#include "StateIO.hh"
+
+#include "G4AutoLock.hh"
+#include "G4RunManager.hh"
+#include "G4SystemOfUnits.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+
+namespace
+{
+// Per kind: name, printed unit and its value
+const char* const kKindNames[] = {"spectrum", "depth", "multiplicity"};
+const char* const kKindUnits[] = {"MeV", "mm", "hits"};
+const G4double kKindScales[] = {MeV, mm, 1.};
+}  // namespace
+
+namespace B2a
+{
+
+std::vector<const OnlineHistograms*> OnlineHistograms::fWorkers;
+G4Mutex OnlineHistograms::fWorkersMutex = G4MUTEX_INITIALIZER;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+OnlineHistograms::OnlineHistograms()
+{
+  fBinning = {{kSpectrum, "all", 250, 0., 500. * MeV},
+              {kDepth, "all", 50},
+              {kMultiplicity, "all", 64}};
+  fMessenger = new HistoMessenger(this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+OnlineHistograms::~OnlineHistograms()
+{
+  delete fMessenger;
+
+  G4AutoLock lock(&fWorkersMutex);
+  for (auto& worker : fWorkers) {
+    if (worker == this) worker = nullptr;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void OnlineHistograms::BeginOfRun(G4int runID)
+{
+  fRunID = runID;
+  fHistograms.clear();
+  fLines.clear();
+  if (!fEnabled) return;
+
+  // the layer layout is constant during a run (see DetectorConstruction)
+  auto detector = static_cast<const DetectorConstruction*>(
+    G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+  const auto& extents = detector->GetLayerExtents();
+  auto nofLayers = (G4int)extents.size();
+
+  fLayerMaterial.clear();
+  fLayerZMin.clear();
+  for (G4int i = 0; i < nofLayers; ++i) {
+    fLayerMaterial.push_back(detector->GetLayerMaterial(i));
+    fLayerZMin.push_back(extents[i].zMin);
+  }
+  fEventEdep.assign(nofLayers, 0.);
+  fEventHits.assign(nofLayers, 0);
+  fEventWeightedEdep.assign(nofLayers, 0.);
+  fEventWeights.assign(nofLayers, 0.);
+
+  // the last rule covering a layer sets its binning
+  std::vector<const Binning*> rules[kNbOfKinds];
+  for (auto& kindRules : rules) kindRules.assign(nofLayers, nullptr);
+  for (const auto& binning : fBinning) {
+    for (auto layer : detector->GetLayerSet(binning.layerSet)) {
+      rules[binning.kind][layer] = (binning.nofBins > 0) ? &binning : nullptr;
+    }
+  }
+
+  std::size_t nofLines = 0;
+  for (auto& index : fIndex) index.assign(nofLayers, -1);
+  for (G4int layer = 0; layer < nofLayers; ++layer) {
+    for (std::uint32_t kind = 0; kind < kNbOfKinds; ++kind) {
+      auto binning = rules[kind][layer];
+      if (!binning) continue;
+
+      Histogram histogram;
+      histogram.kind = Kind(kind);
+      histogram.layer = layer;
+      histogram.nofBins = binning->nofBins;
+      histogram.min = binning->min;
+      histogram.max = binning->max;
+      if (kind == kDepth) histogram.max = extents[layer].zMax - extents[layer].zMin;
+      if (kind == kMultiplicity) histogram.max = binning->nofBins;
+      histogram.scale = histogram.nofBins / (histogram.max - histogram.min);
+      histogram.line = nofLines;
+      histogram.nofLines = (histogram.nofBins + 2 + 7) / 8;
+
+      fIndex[kind][layer] = (G4int)fHistograms.size();
+      fHistograms.push_back(histogram);
+      nofLines += 1 + 2 * histogram.nofLines;
+    }
+  }
+  fLines.assign(nofLines, CacheLine());
+
+  if (G4Threading::IsWorkerThread()) {
+    auto threadID = (std::size_t)G4Threading::G4GetThreadId();
+    G4AutoLock lock(&fWorkersMutex);
+    if (fWorkers.size() <= threadID) fWorkers.resize(threadID + 1, nullptr);
+    fWorkers[threadID] = this;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void OnlineHistograms::Fill(const Histogram& histogram, G4double x, G4double weight)
+{
+  G4int bin = 0;  // underflow
+  if (x >= histogram.max) {
+    bin = histogram.nofBins + 1;
+  }
+  else if (x >= histogram.min) {
+    bin = std::min(histogram.nofBins, 1 + G4int((x - histogram.min) * histogram.scale));
+  }
+
+  auto statistics = fLines[histogram.line].value;
+  statistics[0] += 1.;
+  statistics[1] += weight;
+  statistics[2] += weight * x;
+  statistics[3] += weight * x * x;
+
+  auto sumw = &fLines[histogram.line + 1];
+  auto sumw2 = sumw + histogram.nofLines;
+  sumw[bin / 8].value[bin % 8] += weight;
+  sumw2[bin / 8].value[bin % 8] += weight * weight;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void OnlineHistograms::FillEvent(const TrackerHitsCollection& hits, G4double weight)
+{
+  if (fLines.empty()) return;
+
+  const auto& depthIndex = fIndex[kDepth];
+  auto nofLayers = (G4int)fEventEdep.size();
+  for (std::size_t i = 0; i < hits.entries(); ++i) {
+    const auto hit = hits[i];
+    G4int layer = hit->GetChamberNb();
+    if (layer < 0 || layer >= nofLayers) continue;
+    fEventEdep[layer] += hit->GetEdep();
+    ++fEventHits[layer];
+    fEventWeightedEdep[layer] += hit->GetWeight() * hit->GetEdep();
+    fEventWeights[layer] += hit->GetWeight();
+    if (depthIndex[layer] >= 0) {
+      Fill(fHistograms[depthIndex[layer]], hit->GetPos().z() - fLayerZMin[layer],
+           hit->GetWeight() * hit->GetEdep());
+    }
+  }
+  EndEvent(weight);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void OnlineHistograms::FillEvent(const PixelHitsCollection& pixels, G4double weight)
+{
+  if (fLines.empty()) return;
+
+  auto nofLayers = (G4int)fEventEdep.size();
+  for (std::size_t i = 0; i < pixels.entries(); ++i) {
+    G4int layer = pixels.GetLayer(i);
+    if (layer < 0 || layer >= nofLayers) continue;
+    fEventEdep[layer] += pixels.GetEdep(i);
+    ++fEventHits[layer];
+    fEventWeightedEdep[layer] += pixels.GetWeight(i) * pixels.GetEdep(i);
+    fEventWeights[layer] += pixels.GetWeight(i);
+  }
+  EndEvent(weight);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void OnlineHistograms::EndEvent(G4double weight)
+{
+  for (std::size_t layer = 0; layer < fEventEdep.size(); ++layer) {
+    G4int spectrum = fIndex[kSpectrum][layer];
+    if (spectrum >= 0 && fEventEdep[layer] > 0.) {
+      Fill(fHistograms[spectrum], fEventEdep[layer],
+           fEventWeightedEdep[layer] / fEventEdep[layer]);
+    }
+    G4int multiplicity = fIndex[kMultiplicity][layer];
+    if (multiplicity >= 0) {
+      G4int nofHits = fEventHits[layer];
+      Fill(fHistograms[multiplicity], nofHits,
+           (nofHits > 0) ? fEventWeights[layer] / nofHits : weight);
+    }
+
+    fEventEdep[layer] = 0.;
+    fEventHits[layer] = 0;
+    fEventWeightedEdep[layer] = 0.;
+    fEventWeights[layer] = 0.;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool OnlineHistograms::Add(const std::vector<CacheLine>& lines)
+{
+  // the binning commands are broadcast: same histograms on all threads
+  if (lines.size() != fLines.size()) return false;
+
+  for (std::size_t i = 0; i < fLines.size(); ++i) {
+    for (G4int j = 0; j < 8; ++j) fLines[i].value[j] += lines[i].value[j];
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void OnlineHistograms::WriteState(std::ostream& os) const
+{
+  StateIO::WriteVector(os, fLines);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool OnlineHistograms::AddState(std::istream& is)
+{
+  std::vector<CacheLine> lines;
+  if (!StateIO::ReadVector(is, lines)) return false;
+  return lines.empty() || Add(lines);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void OnlineHistograms::EndOfRun(G4int nofEvents, const G4String& fileTag)
+{
+  if (fLines.empty()) return;
+
+  // The workers have ended the run before the master: their histograms
+  // are not modified until their next run, and the registry only at the
+  // beginning of a run or by a destructor, neither during this call.
+  // In sequential mode the master filled its own histograms.
+  for (std::size_t i = 0; i < fWorkers.size(); ++i) {
+    auto worker = fWorkers[i];
+    if (!worker || worker->fRunID != fRunID) continue;
+    if (!Add(worker->fLines)) {
+      G4ExceptionDescription msg;
+      msg << "The histograms of thread " << i << " have another binning, not merged";
+      G4Exception("OnlineHistograms::EndOfRun()", "B2aHisto003", JustWarning, msg);
+    }
+  }
+
+  if (nofEvents == 0) return;
+
+  Print(nofEvents);
+  Compare(nofEvents);
+  if (!fFileName.empty()) {
+    Write(fFileName + "_r" + std::to_string(fRunID) + fileTag + ".b2hist", nofEvents);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void OnlineHistograms::Compare(G4int nofEvents)
+{
+  auto sameBinning = [this]() {
+    if (fReferenceHistograms.size() != fHistograms.size()) return false;
+    for (std::size_t i = 0; i < fHistograms.size(); ++i) {
+      const auto& a = fHistograms[i];
+      const auto& b = fReferenceHistograms[i];
+      if (a.kind != b.kind || a.layer != b.layer || a.nofBins != b.nofBins || a.min != b.min
+          || a.max != b.max)
+      {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  if (fReferenceEvents == 0 || !sameBinning()) {
+    fReferenceRun = fRunID;
+    fReferenceEvents = nofEvents;
+    fReferenceHistograms = fHistograms;
+    fReferenceLines = fLines;
+    return;
+  }
+
+  G4cout << G4endl << " Comparison with the histograms of run " << fReferenceRun
+         << ", per event" << G4endl << std::setw(8) << "layer" << std::setw(14) << "kind"
+         << std::setw(12) << "chi2" << std::setw(8) << "ndf" << std::setw(12) << "chi2/ndf"
+         << G4endl;
+
+  G4double n = nofEvents;
+  G4double m = fReferenceEvents;
+  for (const auto& histogram : fHistograms) {
+    const auto sumw = &fLines[histogram.line + 1];
+    const auto sumw2 = sumw + histogram.nofLines;
+    const auto refSumw = &fReferenceLines[histogram.line + 1];
+    const auto refSumw2 = refSumw + histogram.nofLines;
+
+    // underflow and overflow included
+    G4double chi2 = 0.;
+    G4int ndf = 0;
+    for (G4int bin = 0; bin < histogram.nofBins + 2; ++bin) {
+      G4double x = sumw[bin / 8].value[bin % 8] / n;
+      G4double y = refSumw[bin / 8].value[bin % 8] / m;
+      G4double variance =
+        sumw2[bin / 8].value[bin % 8] / (n * n) + refSumw2[bin / 8].value[bin % 8] / (m * m);
+      if (variance <= 0.) continue;
+      chi2 += (x - y) * (x - y) / variance;
+      ++ndf;
+    }
+
+    const auto kind = kKindNames[histogram.kind];
+    G4cout << std::setw(8) << histogram.layer << std::setw(14) << kind << std::setw(12) << chi2
+           << std::setw(8) << ndf << std::setw(12) << (ndf > 0 ? chi2 / ndf : 0.) << G4endl
+           << "B2a-histocmp run=" << fRunID << " reference=" << fReferenceRun
+           << " layer=" << histogram.layer << " kind=" << kind << " chi2=" << chi2
+           << " ndf=" << ndf << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void OnlineHistograms::Print(G4int nofEvents) const
+{
+  G4cout << G4endl << " Online histograms, " << fHistograms.size() << " histograms, "
+         << fLines.size() * sizeof(CacheLine) / 1024. << " kB per thread" << G4endl
+         << std::setw(8) << "layer" << std::setw(22) << "material" << std::setw(14) << "kind"
+         << std::setw(8) << "bins" << std::setw(14) << "entries" << std::setw(14)
+         << "per event" << std::setw(14) << "mean" << std::setw(14) << "rms" << G4endl;
+
+  for (const auto& histogram : fHistograms) {
+    const auto statistics = fLines[histogram.line].value;
+    G4double scale = kKindScales[histogram.kind];
+    G4double sumw = statistics[1];
+    G4double mean = (sumw > 0.) ? statistics[2] / sumw : 0.;
+    G4double rms = (sumw > 0.) ? std::sqrt(std::max(0., statistics[3] / sumw - mean * mean)) : 0.;
+    const auto sumwBins = &fLines[histogram.line + 1];
+    G4int overflow = histogram.nofBins + 1;
+    G4double underflowWeight = sumwBins[0].value[0];
+    G4double overflowWeight = sumwBins[overflow / 8].value[overflow % 8];
+
+    const auto& material = fLayerMaterial[histogram.layer];
+    const auto kind = kKindNames[histogram.kind];
+    const auto unit = kKindUnits[histogram.kind];
+    G4cout << std::setw(8) << histogram.layer << std::setw(22) << material << std::setw(14)
+           << kind << std::setw(8) << histogram.nofBins << std::setw(14) << statistics[0]
+           << std::setw(14) << sumw / nofEvents << std::setw(10) << mean / scale << " "
+           << std::setw(3) << std::left << unit << std::right << std::setw(10) << rms / scale
+           << " " << std::setw(3) << std::left << unit << std::right << G4endl
+           << "B2a-histo run=" << fRunID << " layer=" << histogram.layer
+           << " material=" << material << " kind=" << kind << " bins=" << histogram.nofBins
+           << " entries=" << statistics[0] << " sumw_per_event=" << sumw / nofEvents
+           << " mean=" << mean / scale << " rms=" << rms / scale
+           << " underflow=" << underflowWeight / nofEvents
+           << " overflow=" << overflowWeight / nofEvents << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void OnlineHistograms::Write(const G4String& fileName, G4int nofEvents) const
+{
+  std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+  if (!file) {
+    G4ExceptionDescription msg;
+    msg << "Cannot open histogram file " << fileName;
+    G4Exception("OnlineHistograms::Write()", "B2aHisto001", JustWarning, msg);
+    return;
+  }
+
+  auto write = [&file](const auto& value) {
+    file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+  };
+
+  char magic[8] = {'B', '2', 'A', 'H', 'I', 'S', 'T', '\0'};
+  file.write(magic, sizeof(magic));
+  write(kVersion);
+  write(std::uint32_t(32));
+  write(std::int32_t(fRunID));
+  write(std::uint32_t(fHistograms.size()));
+  write(std::uint64_t(nofEvents));
+
+  for (const auto& histogram : fHistograms) {
+    char material[32] = {};
+    std::strncpy(material, fLayerMaterial[histogram.layer].c_str(), sizeof(material) - 1);
+    file.write(material, sizeof(material));
+    G4double scale = kKindScales[histogram.kind];
+    write(std::int32_t(histogram.layer));
+    write(std::uint32_t(histogram.kind));
+    write(std::uint32_t(histogram.nofBins));
+    write(std::uint32_t(0));
+    write(histogram.min / scale);
+    write(histogram.max / scale);
+
+    const auto statistics = fLines[histogram.line].value;
+    write(statistics[0]);
+    write(statistics[1]);
+    write(statistics[2] / scale);
+    write(statistics[3] / (scale * scale));
+
+    // the bins of sumw, then those of sumw2, are contiguous in the lines
+    auto nofValues = std::size_t(histogram.nofBins + 2);
+    auto sumw = fLines[histogram.line + 1].value;
+    auto sumw2 = fLines[histogram.line + 1 + histogram.nofLines].value;
+    file.write(reinterpret_cast<const char*>(sumw), nofValues * sizeof(G4double));
+    file.write(reinterpret_cast<const char*>(sumw2), nofValues * sizeof(G4double));
+  }
+
+  if (!file) {
+    G4ExceptionDescription msg;
+    msg << "Write error on histogram file " << fileName;
+    G4Exception("OnlineHistograms::Write()", "B2aHisto002", JustWarning, msg);
+    return;
+  }
+  G4cout << " Histograms written to " << fileName << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}  // namespace B2a
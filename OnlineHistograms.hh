@@ -0,0 +1,220 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file OnlineHistograms.hh
+/// \brief Definition of the B2a::OnlineHistograms class
+
+#ifndef B2aOnlineHistograms_h
+#define B2aOnlineHistograms_h 1
+
+#include "PixelHitsCollection.hh"
+#include "TrackerHit.hh"
+
+#include "G4Threading.hh"
+#include "globals.hh"
+
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+namespace B2a
+{
+
+class HistoMessenger;
+
+/// Fixed-binning histograms of the tracker, accumulated during the run.
+///
+/// Three kinds of histograms are booked per layer:
+/// - spectrum: energy deposited in the layer per event (MeV), for the
+///   events with a deposit, filled with the mean weight of the hits of
+///   the layer weighted by their deposits;
+/// - depth: depth of the hits from the upstream face of the layer (mm),
+///   filled with the energy deposit times the hit weight; only with the
+///   step hits (the pixels have no depth);
+/// - multiplicity: hits in the layer per event, including 0, filled with
+///   the mean weight of these hits, the event weight for none.
+/// With importance splitting (see ImportanceSampler) the hits of an
+/// event carry several weights: the means of the spectra and of the
+/// multiplicities stay those of the weighted sums, their shapes are
+/// only approximate.
+///
+/// The binning is set per layer by rules, applied in order at the
+/// beginning of each run: a rule sets the binning of one kind for a layer
+/// set (as for the CoincidenceTrigger: "all", a material name or layer
+/// numbers separated by commas), 0 bins removing the histogram. The
+/// default rules book the three kinds for all layers.
+///
+/// The contents of all histograms lie in one array of cache lines, each
+/// histogram starting on a line: its statistics (entries, sum of the
+/// weights, of w x and of w x^2), then the sums of the weights and of the
+/// squared weights of its bins, underflow and overflow included. Each
+/// thread fills its own array, so no line is shared between threads.
+///
+/// The histograms of the workers are not merged through the Run (its
+/// merge is serialised): each worker registers its histograms at the
+/// beginning of the run, and the master adds them at its end of run,
+/// once all the workers have ended theirs, without taking a lock. The
+/// master prints them and writes them to <name>_r<run>.b2hist:
+///
+///   file header, 32 bytes
+///     char     magic[8]      "B2AHIST\0"
+///     uint32   version       1
+///     uint32   headerSize    32
+///     int32    runID
+///     uint32   nofHistograms
+///     uint64   nofEvents
+///   per histogram
+///     char     material[32]
+///     int32    layer
+///     uint32   kind          0 spectrum, 1 depth, 2 multiplicity
+///     uint32   nofBins       n
+///     uint32   reserved
+///     float64  min, max      MeV, mm or hits
+///     float64  entries, sumw, sumwx, sumwx2
+///     float64  sumw[n + 2]   underflow, bins, overflow
+///     float64  sumw2[n + 2]
+///
+/// The first run with histograms is the reference of the following runs
+/// with the same binning: the master compares their per-event contents,
+/// bin by bin, in "B2a-histocmp" lines (chi2 and degrees of freedom), e.g.
+/// to check that a run with the acceptance filter agrees with an
+/// unfiltered one. A run with another binning becomes the reference.
+///
+/// One instance per thread, owned by the RunAction, configured by its
+/// HistoMessenger.
+
+class OnlineHistograms
+{
+  public:
+    enum Kind : std::uint32_t
+    {
+      kSpectrum = 0,
+      kDepth,
+      kMultiplicity,
+      kNbOfKinds
+    };
+
+    // Binning of one kind for a layer set; the depth histograms span the
+    // layer thickness, the multiplicity bins are one hit wide
+    struct Binning {
+      Kind kind = kSpectrum;
+      G4String layerSet;
+      G4int nofBins = 0;
+      G4double min = 0.;
+      G4double max = 0.;
+    };
+
+    static constexpr std::uint32_t kVersion = 1;
+
+    OnlineHistograms();
+    ~OnlineHistograms();
+
+    OnlineHistograms(const OnlineHistograms&) = delete;
+    OnlineHistograms& operator=(const OnlineHistograms&) = delete;
+
+    // Configuration
+    void SetEnabled(G4bool enabled) { fEnabled = enabled; }
+    void SetFileName(const G4String& name) { fFileName = name; }
+    void AddBinning(const Binning& binning) { fBinning.push_back(binning); }
+    void ClearBinning() { fBinning.clear(); }
+    G4bool IsEnabled() const { return fEnabled; }
+
+    // Bytes of the contents (see MemoryMonitor)
+    std::size_t GetMemorySize() const { return fLines.capacity() * sizeof(CacheLine); }
+
+    // All threads: books the histograms of the current stack
+    void BeginOfRun(G4int runID);
+
+    // Thread processing events; the event weight only weights the layers
+    // without hits
+    void FillEvent(const TrackerHitsCollection& hits, G4double weight);
+    void FillEvent(const PixelHitsCollection& pixels, G4double weight);
+
+    // Master: adds the histograms of the workers, prints and writes them
+    void EndOfRun(G4int nofEvents, const G4String& fileTag);
+
+    // Binary state of the contents (see CheckpointManager); a state read
+    // back is added if it has the binning of this run
+    void WriteState(std::ostream&) const;
+    G4bool AddState(std::istream&);
+
+  private:
+    struct alignas(64) CacheLine {
+      G4double value[8] = {};
+    };
+    static_assert(sizeof(CacheLine) == 8 * sizeof(G4double), "the lines must be contiguous");
+
+    struct Histogram {
+      Kind kind;
+      G4int layer;
+      G4int nofBins;
+      G4double min;
+      G4double max;
+      G4double scale;  // bins per unit
+      std::size_t line;  // first line: statistics, then sumw, then sumw2
+      std::size_t nofLines;  // of sumw and of sumw2
+    };
+
+    void Fill(const Histogram& histogram, G4double x, G4double weight);
+    void EndEvent(G4double weight);
+    G4bool Add(const std::vector<CacheLine>& lines);
+    void Print(G4int nofEvents) const;
+    void Compare(G4int nofEvents);
+    void Write(const G4String& fileName, G4int nofEvents) const;
+
+    G4bool fEnabled = false;
+    G4String fFileName = "histos";
+    std::vector<Binning> fBinning;
+
+    G4int fRunID = -1;
+    std::vector<Histogram> fHistograms;  // by layer, then kind
+    std::vector<G4int> fIndex[kNbOfKinds];  // per layer, -1: not booked
+    std::vector<CacheLine> fLines;
+    std::vector<G4String> fLayerMaterial;
+    std::vector<G4double> fLayerZMin;
+
+    // Histograms of the reference run (master)
+    G4int fReferenceRun = -1;
+    G4int fReferenceEvents = 0;
+    std::vector<Histogram> fReferenceHistograms;
+    std::vector<CacheLine> fReferenceLines;
+
+    // Current event, per layer: deposit and hits, and their weighted sums
+    std::vector<G4double> fEventEdep;
+    std::vector<G4int> fEventHits;
+    std::vector<G4double> fEventWeightedEdep;
+    std::vector<G4double> fEventWeights;
+
+    // Histograms of the workers, by thread ID
+    static std::vector<const OnlineHistograms*> fWorkers;
+    static G4Mutex fWorkersMutex;
+
+    HistoMessenger* fMessenger = nullptr;
+};
+
+}  // namespace B2a
+
+#endif
@@ -0,0 +1,141 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file OutputMessenger.cc
+/// \brief Implementation of the B2a::OutputMessenger class
+
+#include "OutputMessenger.hh"
+
+#include "RunAction.hh"
+
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIdirectory.hh"
+
+namespace B2a
+{
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+OutputMessenger::OutputMessenger(RunAction* runAction) : fRunAction(runAction)
+{
+  fDirectory = new G4UIdirectory("/B2/output/");
+  fDirectory->SetGuidance("Output control");
+
+  fHitFileCmd = new G4UIcmdWithAString("/B2/output/hitFile", this);
+  fHitFileCmd->SetGuidance("Stream the tracker hits to binary files.");
+  fHitFileCmd->SetGuidance("One file per thread and run is written:");
+  fHitFileCmd->SetGuidance("  <name>_r<run>[_t<thread>].b2h");
+  fHitFileCmd->SetGuidance("An empty name (default) disables the output.");
+  fHitFileCmd->SetParameterName("name", true);
+  fHitFileCmd->SetDefaultValue("");
+  fHitFileCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fChunkSizeCmd = new G4UIcmdWithAnInteger("/B2/output/chunkSize", this);
+  fChunkSizeCmd->SetGuidance("Number of hits buffered per thread before a block is written.");
+  fChunkSizeCmd->SetParameterName("nofHits", false);
+  fChunkSizeCmd->SetRange("nofHits>0");
+  fChunkSizeCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fProfileCmd = new G4UIcmdWithABool("/B2/output/profile", this);
+  fProfileCmd->SetGuidance("Profile the steps per volume, particle and process.");
+  fProfileCmd->SetGuidance("The table is printed at the end of each run.");
+  fProfileCmd->SetParameterName("enabled", true);
+  fProfileCmd->SetDefaultValue(true);
+  fProfileCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fProfileFileCmd = new G4UIcmdWithAString("/B2/output/profileFile", this);
+  fProfileFileCmd->SetGuidance("CSV file receiving the stepping profile of each run:");
+  fProfileFileCmd->SetGuidance("  <name>_r<run>.csv");
+  fProfileFileCmd->SetGuidance("An empty name (default) disables the file.");
+  fProfileFileCmd->SetParameterName("name", true);
+  fProfileFileCmd->SetDefaultValue("");
+  fProfileFileCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fPhaseSpaceFileCmd = new G4UIcmdWithAString("/B2/output/phaseSpaceFile", this);
+  fPhaseSpaceFileCmd->SetGuidance("Record the particles crossing the plane just downstream");
+  fPhaseSpaceFileCmd->SetGuidance("of the target (see /B2/source/replay).");
+  fPhaseSpaceFileCmd->SetGuidance("One file per thread and run is written:");
+  fPhaseSpaceFileCmd->SetGuidance("  <name>_r<run>[_t<thread>].phsp");
+  fPhaseSpaceFileCmd->SetGuidance("An empty name (default) disables the recording.");
+  fPhaseSpaceFileCmd->SetParameterName("name", true);
+  fPhaseSpaceFileCmd->SetDefaultValue("");
+  fPhaseSpaceFileCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fKeepRecordedCmd = new G4UIcmdWithABool("/B2/output/keepRecorded", this);
+  fKeepRecordedCmd->SetGuidance("Keep tracking the recorded particles through the stack.");
+  fKeepRecordedCmd->SetGuidance("By default they are killed once recorded.");
+  fKeepRecordedCmd->SetParameterName("keep", true);
+  fKeepRecordedCmd->SetDefaultValue(true);
+  fKeepRecordedCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+OutputMessenger::~OutputMessenger()
+{
+  delete fHitFileCmd;
+  delete fChunkSizeCmd;
+  delete fProfileCmd;
+  delete fProfileFileCmd;
+  delete fPhaseSpaceFileCmd;
+  delete fKeepRecordedCmd;
+  delete fDirectory;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void OutputMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+  if (command == fHitFileCmd) {
+    fRunAction->SetHitFileName(newValue);
+  }
+
+  if (command == fChunkSizeCmd) {
+    fRunAction->SetChunkSize(fChunkSizeCmd->GetNewIntValue(newValue));
+  }
+
+  if (command == fProfileCmd) {
+    fRunAction->SetProfiling(fProfileCmd->GetNewBoolValue(newValue));
+  }
+
+  if (command == fProfileFileCmd) {
+    fRunAction->SetProfileFileName(newValue);
+  }
+
+  if (command == fPhaseSpaceFileCmd) {
+    fRunAction->SetPhaseSpaceFileName(newValue);
+  }
+
+  if (command == fKeepRecordedCmd) {
+    fRunAction->SetKeepRecorded(fKeepRecordedCmd->GetNewBoolValue(newValue));
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}  // namespace B2a
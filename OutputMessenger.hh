@@ -0,0 +1,82 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file OutputMessenger.hh
+/// \brief Definition of the B2a::OutputMessenger class
+
+#ifndef B2aOutputMessenger_h
+#define B2aOutputMessenger_h 1
+
+#include "G4UImessenger.hh"
+
+class G4UIdirectory;
+class G4UIcmdWithABool;
+class G4UIcmdWithAString;
+class G4UIcmdWithAnInteger;
+class G4UIcommand;
+
+namespace B2a
+{
+
+class RunAction;
+
+/// Messenger class that defines commands for the output of RunAction.
+///
+/// It implements commands:
+/// - /B2/output/hitFile name
+/// - /B2/output/chunkSize n
+/// - /B2/output/profile true|false
+/// - /B2/output/profileFile name
+/// - /B2/output/phaseSpaceFile name
+/// - /B2/output/keepRecorded true|false
+///
+/// A messenger exists on the master and on each worker (the commands are
+/// broadcast), each one configuring the run action of its own thread.
+
+class OutputMessenger : public G4UImessenger
+{
+  public:
+    OutputMessenger(RunAction*);
+    ~OutputMessenger() override;
+
+    void SetNewValue(G4UIcommand*, G4String) override;
+
+  private:
+    RunAction* fRunAction = nullptr;
+
+    G4UIdirectory* fDirectory = nullptr;
+
+    G4UIcmdWithAString* fHitFileCmd = nullptr;
+    G4UIcmdWithAnInteger* fChunkSizeCmd = nullptr;
+    G4UIcmdWithABool* fProfileCmd = nullptr;
+    G4UIcmdWithAString* fProfileFileCmd = nullptr;
+    G4UIcmdWithAString* fPhaseSpaceFileCmd = nullptr;
+    G4UIcmdWithABool* fKeepRecordedCmd = nullptr;
+};
+
+}  // namespace B2a
+
+#endif
@@ -0,0 +1,240 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file OverlapValidator.cc
+/// \brief Implementation of the B2a::OverlapValidator class
+
+#include "OverlapValidator.hh"
+
+#include "FnvHash.hh"
+
+#include "G4LogicalVolume.hh"
+#include "G4Material.hh"
+#include "G4PVReplica.hh"
+#include "G4Region.hh"
+#include "G4VPVParameterisation.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4VSolid.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+// Suffix of a temporary file private to this job
+G4String UniqueSuffix()
+{
+  std::ostringstream os;
+  os << std::hex << std::random_device{}() << '_'
+     << std::chrono::steady_clock::now().time_since_epoch().count();
+  return os.str();
+}
+}  // namespace
+
+namespace B2a
+{
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool OverlapValidator::Validate(G4VPhysicalVolume* world)
+{
+  std::ostringstream description;
+  std::set<G4VPhysicalVolume*> volumes;
+  description << "resolution " << fResolution << '\n';
+  Describe(world, description, volumes);
+  G4String key = FnvHash(description.str());
+
+  // Cache lines: <key> ok|overlaps
+  if (!fCacheFile.empty()) {
+    std::ifstream cache(fCacheFile);
+    G4String entryKey, verdict;
+    while (cache >> entryKey >> verdict) {
+      if (entryKey != key) continue;
+      G4cout << G4endl << "----> Geometry " << key << " already validated: " << verdict
+             << G4endl;
+      if (verdict == "ok") return true;
+      G4Exception("OverlapValidator::Validate()", "Overlaps", JustWarning,
+                  "Overlaps found by a previous check of this geometry");
+      return false;
+    }
+  }
+
+  G4int nofOverlaps = Check(volumes);
+  G4cout << G4endl << "----> Geometry " << key << " validated: " << nofOverlaps
+         << " overlapping volume(s) out of " << volumes.size() << G4endl;
+
+  if (!fCacheFile.empty()) Store(key, nofOverlaps == 0);
+
+  if (nofOverlaps > 0) {
+    G4Exception("OverlapValidator::Validate()", "Overlaps", JustWarning,
+                "Overlaps found, see the GeomVol1002 warnings above");
+  }
+  return nofOverlaps == 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void OverlapValidator::Store(const G4String& key, G4bool ok) const
+{
+  // The cache and the new line are written to a private copy, which then
+  // replaces the cache with an atomic rename (as the checkpoints do): the
+  // jobs reading the cache always see a complete file. Of two jobs storing
+  // at once the last one wins; the other verdict is lost, which only costs
+  // a new check.
+  std::ostringstream contents;
+  {
+    std::ifstream cache(fCacheFile);
+    std::string line;
+    while (std::getline(cache, line)) contents << line << '\n';
+  }
+  contents << key << ' ' << (ok ? "ok" : "overlaps") << '\n';
+
+  G4String temporary = fCacheFile + ".tmp_" + UniqueSuffix();
+  std::ofstream file(temporary, std::ios::trunc);
+  file << contents.str();
+  file.close();
+
+  std::error_code error;
+  if (file) fs::rename(temporary.c_str(), fCacheFile.c_str(), error);
+  if (!file || error) {
+    fs::remove(temporary.c_str(), error);
+    G4ExceptionDescription msg;
+    msg << "Cannot write overlap cache file " << fCacheFile << ", the verdict is not cached";
+    G4Exception("OverlapValidator::Store()", "B2aOverlap001", JustWarning, msg);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void OverlapValidator::Describe(G4VPhysicalVolume* pv, std::ostream& os,
+                                std::set<G4VPhysicalVolume*>& volumes) const
+{
+  volumes.insert(pv);
+
+  auto lv = pv->GetLogicalVolume();
+  auto param = pv->GetParameterisation();
+  G4int nofCopies = param ? pv->GetMultiplicity() : 1;
+
+  for (G4int copy = 0; copy < nofCopies; ++copy) {
+    auto solid = lv->GetSolid();
+    if (param) {
+      param->ComputeTransformation(copy, pv);
+      solid = param->ComputeSolid(copy, pv);
+      solid->ComputeDimensions(param, copy, pv);
+    }
+    os << pv->GetName() << ' ' << (param ? copy : pv->GetCopyNo()) << ' '
+       << (lv->GetMaterial() ? lv->GetMaterial()->GetName() : G4String("none")) << ' '
+       << pv->GetTranslation() << ' ';
+    if (pv->GetRotation()) os << *pv->GetRotation();
+    solid->StreamInfo(os);
+  }
+
+  for (std::size_t i = 0; i < lv->GetNoDaughters(); ++i) {
+    Describe(lv->GetDaughter(i), os, volumes);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int OverlapValidator::Check(const std::set<G4VPhysicalVolume*>& volumes) const
+{
+  // One task per logical volume (see the class description)
+  std::map<G4LogicalVolume*, std::vector<G4VPhysicalVolume*>> groups;
+  for (auto pv : volumes) {
+    groups[pv->GetLogicalVolume()].push_back(pv);
+  }
+  std::vector<std::vector<G4VPhysicalVolume*>> tasks;
+  for (auto& group : groups) tasks.push_back(std::move(group.second));
+
+  std::atomic<std::size_t> next{0};
+  std::atomic<G4int> nofOverlaps{0};
+  auto work = [&]([[maybe_unused]] G4bool helper) {
+#ifdef G4MULTITHREADED
+    // The placements, solids and materials are read through per-thread
+    // copies (split classes), which a thread not started by Geant4 does
+    // not have: it copies those of the master, as a worker does (see
+    // G4WorkerThread::BuildGeometryAndPhysicsVector()).
+    if (helper) {
+      const_cast<G4LVManager&>(G4LogicalVolume::GetSubInstanceManager())
+        .SlaveCopySubInstanceArray();
+      const_cast<G4PVManager&>(G4VPhysicalVolume::GetSubInstanceManager())
+        .SlaveCopySubInstanceArray();
+      const_cast<G4PVRManager&>(G4PVReplica::GetSubInstanceManager())
+        .SlaveCopySubInstanceArray();
+      const_cast<G4RegionManager&>(G4Region::GetSubInstanceManager())
+        .SlaveInitializeSubInstance();
+    }
+#endif
+
+    for (auto task = next++; task < tasks.size(); task = next++) {
+      for (auto pv : tasks[task]) {
+        // the world has no mother: nothing to check
+        if (pv->GetMotherLogical() && pv->CheckOverlaps(fResolution, 0., false)) {
+          ++nofOverlaps;
+        }
+      }
+    }
+
+#ifdef G4MULTITHREADED
+    if (helper) {
+      const_cast<G4LVManager&>(G4LogicalVolume::GetSubInstanceManager()).FreeSlave();
+      const_cast<G4PVManager&>(G4VPhysicalVolume::GetSubInstanceManager()).FreeSlave();
+      const_cast<G4PVRManager&>(G4PVReplica::GetSubInstanceManager()).FreeSlave();
+      const_cast<G4RegionManager&>(G4Region::GetSubInstanceManager()).FreeSlave();
+    }
+#endif
+  };
+
+#ifdef G4MULTITHREADED
+  std::size_t nofThreads =
+    fNbOfThreads > 0 ? fNbOfThreads : std::max(1U, std::thread::hardware_concurrency());
+  nofThreads = std::min(nofThreads, tasks.size());
+#else
+  // a sequential build shares the geometry data of the only thread: the
+  // check is serial
+  std::size_t nofThreads = 1;
+#endif
+
+  std::vector<std::thread> threads;
+  for (std::size_t i = 1; i < nofThreads; ++i) threads.emplace_back(work, true);
+  work(false);
+  for (auto& thread : threads) thread.join();
+
+  return nofOverlaps;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}  // namespace B2a
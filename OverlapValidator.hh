@@ -0,0 +1,85 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file OverlapValidator.hh
+/// \brief Definition of the B2a::OverlapValidator class
+
+#ifndef B2aOverlapValidator_h
+#define B2aOverlapValidator_h 1
+
+#include "globals.hh"
+
+#include <ostream>
+#include <set>
+#include <vector>
+
+class G4VPhysicalVolume;
+
+namespace B2a
+{
+
+/// Overlap validation of a complete geometry tree.
+///
+/// The placements are not checked when they are created, but once the
+/// tree is complete, by a pool of threads. The verdict is stored in a
+/// cache file under a hash of the description of the tree (names,
+/// materials, positions, rotations and solid dimensions of all the
+/// volumes, including each copy of the parameterised ones) and of the
+/// resolution, so that an unchanged geometry is never checked twice.
+///
+/// The copies of a parameterised volume share, and modify, the solid of
+/// their logical volume: all the volumes of a logical volume are checked
+/// in the same thread. The helper threads get their own copy of the
+/// per-thread geometry data of the master, as the Geant4 workers do; a
+/// sequential Geant4 build has no such copies, and is checked serially.
+
+class OverlapValidator
+{
+  public:
+    OverlapValidator() = default;
+    ~OverlapValidator() = default;
+
+    // Returns false if overlaps were found (now or in a previous job)
+    G4bool Validate(G4VPhysicalVolume* world);
+
+    void SetResolution(G4int resolution) { fResolution = resolution; }
+    void SetNbOfThreads(G4int nofThreads) { fNbOfThreads = nofThreads; }
+    void SetCacheFile(const G4String& fileName) { fCacheFile = fileName; }
+
+  private:
+    void Store(const G4String& key, G4bool ok) const;  // in the cache file
+    void Describe(G4VPhysicalVolume* pv, std::ostream& os,
+                  std::set<G4VPhysicalVolume*>& volumes) const;
+    G4int Check(const std::set<G4VPhysicalVolume*>& volumes) const;
+
+    G4int fResolution = 1000;  // points per surface
+    G4int fNbOfThreads = 0;  // 0: all the cores
+    G4String fCacheFile = "overlaps.cache";  // empty: no cache
+};
+
+}  // namespace B2a
+
+#endif
@@ -0,0 +1,88 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file PhaseSpaceFile.hh
+/// \brief Definition of the B2a phase-space file format
+
+#ifndef B2aPhaseSpaceFile_h
+#define B2aPhaseSpaceFile_h 1
+
+#include "CLHEP/Units/SystemOfUnits.h"
+#include "globals.hh"
+
+#include <cstdint>
+
+namespace B2a
+{
+
+/// Phase-space file: the particles crossing the plane just downstream of
+/// the target (see PhaseSpaceWriter), replayed by PhaseSpaceReader.
+///
+/// File layout (little endian, fixed-size records so that the file can be
+/// memory-mapped and the records used in place):
+///
+///   file header, 40 bytes
+///     char     magic[8]      "B2APHSP\0"
+///     uint32   version       2
+///     uint32   headerSize    40
+///     uint32   recordSize    48
+///     int32    runID
+///     int32    threadID      -1 for the master/sequential thread
+///     float32  planeZ        mm, z of the plane in the recording geometry
+///     uint64   nofPrimaries  events generated by the thread
+///   records, until end of file, grouped by event
+///
+/// The records of an event are contiguous, in the order of the crossings.
+/// The events without any crossing have no record: nofPrimaries, updated
+/// at each checkpoint and when the file is closed, gives the number of
+/// primaries the records stand for.
+
+namespace PhaseSpace
+{
+constexpr std::uint32_t kVersion = 2;
+constexpr std::size_t kHeaderSize = 40;
+constexpr std::size_t kNbOfPrimariesOffset = 32;
+
+// distance of the plane from the downstream face of the target, so that
+// the replayed particles start inside the tracker, off its boundary
+constexpr G4double kPlaneOffset = 1. * CLHEP::um;
+
+struct Record {
+  std::int32_t pdg;  // PDG encoding
+  std::int32_t eventID;  // event of the recording thread
+  float energy;  // kinetic, MeV
+  float x, y, z;  // mm
+  float u, v, w;  // direction
+  float time;  // global, ns
+  float weight;
+  std::uint32_t reserved;
+};
+static_assert(sizeof(Record) == 48, "phase-space records are 48 bytes");
+}  // namespace PhaseSpace
+
+}  // namespace B2a
+
+#endif
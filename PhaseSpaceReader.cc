@@ -0,0 +1,223 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file PhaseSpaceReader.cc
+/// \brief Implementation of the B2a::PhaseSpaceReader class
+
+#include "PhaseSpaceReader.hh"
+
+#include "G4Event.hh"
+#include "G4IonTable.hh"
+#include "G4ParticleTable.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4PrimaryParticle.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4SystemOfUnits.hh"
+#include "Randomize.hh"
+
+#include <cstring>
+#include <fstream>
+
+#ifndef _WIN32
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+namespace B2a
+{
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+PhaseSpaceReader::~PhaseSpaceReader()
+{
+  Close();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool PhaseSpaceReader::Map(const G4String& fileName, File& file)
+{
+#ifndef _WIN32
+  G4int fd = open(fileName.c_str(), O_RDONLY);
+  struct stat status;
+  if (fd >= 0 && fstat(fd, &status) == 0 && status.st_size > 0) {
+    void* data = mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data != MAP_FAILED) {
+      // the records are read in order
+      madvise(data, status.st_size, MADV_SEQUENTIAL);
+      file.data = data;
+      file.size = status.st_size;
+    }
+  }
+  if (fd >= 0) close(fd);
+  return file.data != nullptr;
+#else
+  std::ifstream input(fileName, std::ios::binary | std::ios::ate);
+  if (!input) return false;
+  file.buffer.resize(input.tellg());
+  input.seekg(0);
+  input.read(file.buffer.data(), file.buffer.size());
+  file.data = file.buffer.data();
+  file.size = file.buffer.size();
+  return bool(input);
+#endif
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool PhaseSpaceReader::Open(const std::vector<G4String>& fileNames)
+{
+  Close();
+
+  fFiles.resize(fileNames.size());
+  std::size_t nofRecords = 0;
+  std::uint64_t nofPrimaries = 0;
+  for (std::size_t i = 0; i < fileNames.size(); ++i) {
+    auto& file = fFiles[i];
+    if (!Map(fileNames[i], file)) {
+      G4ExceptionDescription msg;
+      msg << "Cannot read phase-space file " << fileNames[i];
+      G4Exception("PhaseSpaceReader::Open()", "B2aPhsp002", JustWarning, msg);
+      Close();
+      return false;
+    }
+
+    auto header = static_cast<const char*>(file.data);
+    std::uint32_t version = 0, headerSize = 0, recordSize = 0;
+    float planeZ = 0.;
+    std::uint64_t filePrimaries = 0;
+    if (file.size >= PhaseSpace::kHeaderSize) {
+      std::memcpy(&version, header + 8, 4);
+      std::memcpy(&headerSize, header + 12, 4);
+      std::memcpy(&recordSize, header + 16, 4);
+      std::memcpy(&planeZ, header + 28, 4);
+      std::memcpy(&filePrimaries, header + PhaseSpace::kNbOfPrimariesOffset, 8);
+    }
+    if (file.size < PhaseSpace::kHeaderSize || std::memcmp(header, "B2APHSP", 8) != 0
+        || version != PhaseSpace::kVersion || headerSize != PhaseSpace::kHeaderSize
+        || recordSize != sizeof(PhaseSpace::Record)
+        || (file.size - headerSize) % recordSize != 0)
+    {
+      G4ExceptionDescription msg;
+      msg << fileNames[i] << " is not a phase-space file of this version";
+      G4Exception("PhaseSpaceReader::Open()", "B2aPhsp003", JustWarning, msg);
+      Close();
+      return false;
+    }
+    file.planeZ = planeZ * mm;
+
+    // index of the events: runs of records with the same event ID
+    auto records = reinterpret_cast<const PhaseSpace::Record*>(header + headerSize);
+    std::size_t n = (file.size - headerSize) / recordSize;
+    std::size_t nofEvents = fEvents.size();
+    for (std::size_t r = 0; r < n; ++r) {
+      if (r == 0 || records[r].eventID != records[r - 1].eventID) {
+        fEvents.push_back({records + r, 0, std::uint32_t(i)});
+      }
+      ++fEvents.back().nofRecords;
+    }
+    nofRecords += n;
+
+    // a file which was not closed nor checkpointed has no count
+    nofEvents = fEvents.size() - nofEvents;
+    if (filePrimaries < nofEvents) {
+      G4ExceptionDescription msg;
+      msg << fileNames[i] << " holds " << nofEvents << " events of " << filePrimaries
+          << " primaries, counted as " << nofEvents << " primaries";
+      G4Exception("PhaseSpaceReader::Open()", "B2aPhsp005", JustWarning, msg);
+      filePrimaries = nofEvents;
+    }
+    nofPrimaries += filePrimaries;
+  }
+
+  // each replayed event stands for nofPrimaries / nofEvents primaries
+  fNbOfPrimaries = nofPrimaries;
+  fEventWeight = (nofPrimaries > 0) ? G4double(fEvents.size()) / nofPrimaries : 1.;
+
+  G4cout << G4endl << "----> Phase space: " << nofRecords << " particles in " << fEvents.size()
+         << " events of " << nofPrimaries << " primaries from " << fFiles.size()
+         << " file(s), weight " << fEventWeight << " per replayed event" << G4endl;
+  return IsOpen();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhaseSpaceReader::Close()
+{
+#ifndef _WIN32
+  for (auto& file : fFiles) {
+    if (file.data) munmap(file.data, file.size);
+  }
+#endif
+  fFiles.clear();
+  fEvents.clear();
+  fNbOfPrimaries = 0;
+  fEventWeight = 1.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool PhaseSpaceReader::GeneratePrimaries(G4Event* event, G4double planeZ) const
+{
+  std::size_t index = event->GetEventID();
+  if (fEvents.empty() || (index >= fEvents.size() && !fRecycling)) return false;
+
+  const auto& range = fEvents[index % fEvents.size()];
+  G4bool rotate = fRotation && index >= fEvents.size();
+  G4double phi = rotate ? twopi * G4UniformRand() : 0.;
+  G4double shift = planeZ - fFiles[range.file].planeZ;
+
+  auto particleTable = G4ParticleTable::GetParticleTable();
+  for (std::uint32_t i = 0; i < range.nofRecords; ++i) {
+    const auto& record = range.records[i];
+    auto particle = particleTable->FindParticle(record.pdg);
+    if (!particle) particle = G4IonTable::GetIonTable()->GetIon(record.pdg);
+    if (!particle) continue;
+
+    G4ThreeVector position(record.x * mm, record.y * mm, record.z * mm + shift);
+    G4ThreeVector direction(record.u, record.v, record.w);
+    if (rotate) {
+      position.rotateZ(phi);
+      direction.rotateZ(phi);
+    }
+
+    auto primary = new G4PrimaryParticle(particle);
+    primary->SetKineticEnergy(record.energy * MeV);
+    primary->SetMomentumDirection(direction.unit());
+    primary->SetWeight(record.weight * fEventWeight);
+
+    auto vertex = new G4PrimaryVertex(position, record.time * ns);
+    vertex->SetPrimary(primary);
+    event->AddPrimaryVertex(vertex);
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}  // namespace B2a
@@ -0,0 +1,115 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file PhaseSpaceReader.hh
+/// \brief Definition of the B2a::PhaseSpaceReader class
+
+#ifndef B2aPhaseSpaceReader_h
+#define B2aPhaseSpaceReader_h 1
+
+#include "PhaseSpaceFile.hh"
+
+#include "globals.hh"
+
+#include <vector>
+
+class G4Event;
+
+namespace B2a
+{
+
+/// Replay of phase-space files (see PhaseSpaceFile.hh).
+///
+/// The files are memory-mapped once, on the master, and an index of the
+/// recorded events is built; the generators of all threads then read the
+/// records in place, without copy nor lock. Event n of a run replays the
+/// recorded event n, so that the recorded events are split among the
+/// threads as the events are. The particles start at the same distance
+/// from the target as when recorded, whatever the current stack.
+///
+/// The events without any crossing were not recorded: the particles of a
+/// replayed event carry, on top of their recorded weight, the number of
+/// recorded events over the number of primaries of the recording (see
+/// PhaseSpaceFile.hh), so that the weighted results per event (the scores,
+/// the weighted deposits and trigger counters) are per primary of the
+/// recording. The unweighted counts remain per replayed event.
+///
+/// With recycling, the recorded events are replayed again once all were
+/// used; with rotation, each reuse is rotated by a random angle around
+/// the beam (z) axis. Without recycling, the run of a thread is aborted
+/// when no recorded event is left.
+
+class PhaseSpaceReader
+{
+  public:
+    PhaseSpaceReader() = default;
+    ~PhaseSpaceReader();
+
+    PhaseSpaceReader(const PhaseSpaceReader&) = delete;
+    PhaseSpaceReader& operator=(const PhaseSpaceReader&) = delete;
+
+    G4bool Open(const std::vector<G4String>& fileNames);
+    void Close();
+    G4bool IsOpen() const { return !fEvents.empty(); }
+
+    void SetRecycling(G4bool recycling) { fRecycling = recycling; }
+    void SetRotation(G4bool rotation) { fRotation = rotation; }
+
+    std::size_t GetNbOfEvents() const { return fEvents.size(); }
+    std::uint64_t GetNbOfPrimaries() const { return fNbOfPrimaries; }
+
+    // Add the recorded particles of the event, started on the plane at
+    // planeZ in the current geometry; false if there is none left
+    G4bool GeneratePrimaries(G4Event* event, G4double planeZ) const;
+
+  private:
+    struct File {
+      void* data = nullptr;  // mapping
+      std::size_t size = 0;
+      std::vector<char> buffer;  // copy, where mmap is not available
+      G4double planeZ = 0.;
+    };
+
+    struct EventRange {
+      const PhaseSpace::Record* records;
+      std::uint32_t nofRecords;
+      std::uint32_t file;
+    };
+
+    G4bool Map(const G4String& fileName, File& file);
+
+    std::vector<File> fFiles;
+    std::vector<EventRange> fEvents;
+    std::uint64_t fNbOfPrimaries = 0;  // of the recording
+    G4double fEventWeight = 1.;  // recorded events per primary
+
+    G4bool fRecycling = false;
+    G4bool fRotation = false;
+};
+
+}  // namespace B2a
+
+#endif
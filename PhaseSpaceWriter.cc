@@ -0,0 +1,216 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file PhaseSpaceWriter.cc
+/// \brief Implementation of the B2a::PhaseSpaceWriter class
+
+#include "PhaseSpaceWriter.hh"
+
+#include "G4SystemOfUnits.hh"
+
+#include <algorithm>
+#include <cstring>
+
+namespace B2a
+{
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+PhaseSpaceWriter::~PhaseSpaceWriter()
+{
+  Close();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool PhaseSpaceWriter::Open(const G4String& fileName, G4int runID, G4int threadID,
+                              G4double planeZ, std::size_t chunkSize)
+{
+  Close();
+
+  fFile.open(fileName, std::ios::binary | std::ios::trunc);
+  if (!fFile) {
+    G4ExceptionDescription msg;
+    msg << "Cannot open phase-space file " << fileName;
+    G4Exception("PhaseSpaceWriter::Open()", "B2aPhsp001", JustWarning, msg);
+    return false;
+  }
+
+  fFileName = fileName;
+  fChunkSize = std::max<std::size_t>(chunkSize, 1);
+  fRecords.reserve(fChunkSize);
+  fPlaneZ = planeZ;
+  fNbOfPrimaries = 0;
+  fNbOfBytes = 0;
+
+  char header[PhaseSpace::kHeaderSize] = {};
+  std::memcpy(header, "B2APHSP", 8);
+  std::uint32_t version = PhaseSpace::kVersion;
+  std::uint32_t headerSize = sizeof(header);
+  std::uint32_t recordSize = sizeof(PhaseSpace::Record);
+  std::int32_t run = runID;
+  std::int32_t thread = threadID;
+  float plane = float(planeZ / mm);
+  std::memcpy(header + 8, &version, 4);
+  std::memcpy(header + 12, &headerSize, 4);
+  std::memcpy(header + 16, &recordSize, 4);
+  std::memcpy(header + 20, &run, 4);
+  std::memcpy(header + 24, &thread, 4);
+  std::memcpy(header + 28, &plane, 4);
+  std::memcpy(header + PhaseSpace::kNbOfPrimariesOffset, &fNbOfPrimaries, 8);
+  fFile.write(header, sizeof(header));
+  if (!fFile.good()) {
+    Fail("PhaseSpaceWriter::Open()");
+    return false;
+  }
+  fNbOfPendingRecords = 0;
+  fNbOfPendingBytes = sizeof(header);
+
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhaseSpaceWriter::Close()
+{
+  if (!fFile.is_open()) return;
+
+  Flush();
+  WriteNbOfPrimaries();
+  if (!fFile.is_open()) return;
+  fFile.close();
+  if (fFile.fail()) {
+    Fail("PhaseSpaceWriter::Close()");
+    return;
+  }
+  Commit();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::uint64_t PhaseSpaceWriter::Sync()
+{
+  if (!fFile.is_open()) return fNbOfBytes;
+
+  Flush();
+  WriteNbOfPrimaries();
+  if (!fFile.is_open()) return fNbOfBytes;
+  fFile.flush();
+  if (fFile.good()) {
+    Commit();
+  }
+  else {
+    Fail("PhaseSpaceWriter::Sync()");
+  }
+  return fNbOfBytes;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool PhaseSpaceWriter::Fill(G4int eventID, G4int pdg, G4double energy,
+                              const G4ThreeVector& position, const G4ThreeVector& direction,
+                              G4double time, G4double weight)
+{
+  // the rest of the run after a failed write
+  if (!fFile.is_open()) return false;
+
+  PhaseSpace::Record record{};
+  record.pdg = pdg;
+  record.eventID = eventID;
+  record.energy = float(energy / MeV);
+  record.x = float(position.x() / mm);
+  record.y = float(position.y() / mm);
+  record.z = float(position.z() / mm);
+  record.u = float(direction.x());
+  record.v = float(direction.y());
+  record.w = float(direction.z());
+  record.time = float(time / ns);
+  record.weight = float(weight);
+  fRecords.push_back(record);
+
+  if (fRecords.size() == fChunkSize) Flush();
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhaseSpaceWriter::Flush()
+{
+  if (fRecords.empty() || !fFile.is_open()) return;
+
+  fFile.write(reinterpret_cast<const char*>(fRecords.data()),
+              fRecords.size() * sizeof(PhaseSpace::Record));
+  if (fFile.good()) {
+    fNbOfPendingRecords += fRecords.size();
+    fNbOfPendingBytes += fRecords.size() * sizeof(PhaseSpace::Record);
+  }
+  else {
+    Fail("PhaseSpaceWriter::Flush()", fRecords.size());
+  }
+  fRecords.clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhaseSpaceWriter::WriteNbOfPrimaries()
+{
+  if (!fFile.is_open()) return;
+
+  fFile.seekp(PhaseSpace::kNbOfPrimariesOffset);
+  fFile.write(reinterpret_cast<const char*>(&fNbOfPrimaries), sizeof(fNbOfPrimaries));
+  fFile.seekp(0, std::ios::end);
+  if (!fFile.good()) Fail("PhaseSpaceWriter::WriteNbOfPrimaries()");
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhaseSpaceWriter::Commit()
+{
+  fNbOfBytes += fNbOfPendingBytes;
+  fNbOfPendingRecords = 0;
+  fNbOfPendingBytes = 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhaseSpaceWriter::Fail(const char* where, std::size_t nofBufferedRecords)
+{
+  // the blocks written since the last flush may not have reached the file
+  std::uint64_t nofLostRecords = fNbOfPendingRecords + nofBufferedRecords;
+  fNbOfPendingRecords = 0;
+  fNbOfPendingBytes = 0;
+
+  G4ExceptionDescription msg;
+  msg << "Cannot write phase-space file " << fFileName << ": " << nofLostRecords
+      << " records lost, the file is closed; its first " << fNbOfBytes << " bytes are valid";
+  G4Exception(where, "B2aPhsp004", JustWarning, msg);
+
+  fFile.close();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}  // namespace B2a
@@ -0,0 +1,104 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file PhaseSpaceWriter.hh
+/// \brief Definition of the B2a::PhaseSpaceWriter class
+
+#ifndef B2aPhaseSpaceWriter_h
+#define B2aPhaseSpaceWriter_h 1
+
+#include "PhaseSpaceFile.hh"
+
+#include "G4ThreeVector.hh"
+#include "globals.hh"
+
+#include <cstdint>
+#include <fstream>
+#include <vector>
+
+namespace B2a
+{
+
+/// Buffered writer of a phase-space file (see PhaseSpaceFile.hh).
+///
+/// As the HitWriter, each thread owns its own writer and file: the
+/// records are buffered and written by blocks of chunkSize records. The
+/// writes are checked as those of the HitWriter: on a failure the file
+/// is closed, with its committed size still valid, and the records of
+/// the blocks not yet flushed, and the next ones, are lost.
+
+class PhaseSpaceWriter
+{
+  public:
+    PhaseSpaceWriter() = default;
+    ~PhaseSpaceWriter();
+
+    PhaseSpaceWriter(const PhaseSpaceWriter&) = delete;
+    PhaseSpaceWriter& operator=(const PhaseSpaceWriter&) = delete;
+
+    G4bool Open(const G4String& fileName, G4int runID, G4int threadID, G4double planeZ,
+                std::size_t chunkSize);
+    void Close();
+    G4bool IsOpen() const { return fFile.is_open(); }
+    const G4String& GetFileName() const { return fFileName; }
+
+    // Write the buffered records: the file up to the returned size holds
+    // all the events filled so far (see CheckpointManager)
+    std::uint64_t Sync();
+
+    G4double GetPlaneZ() const { return fPlaneZ; }
+
+    // Bytes of the record buffer (see MemoryMonitor)
+    std::size_t GetMemorySize() const { return fRecords.capacity() * sizeof(PhaseSpace::Record); }
+
+    // Returns false if the record is lost (the file was closed by a
+    // failed write)
+    G4bool Fill(G4int eventID, G4int pdg, G4double energy, const G4ThreeVector& position,
+                const G4ThreeVector& direction, G4double time, G4double weight);
+
+    // Count a generated event, with or without crossing
+    void EndOfEvent() { ++fNbOfPrimaries; }
+
+  private:
+    void Flush();
+    void WriteNbOfPrimaries();  // in the header
+    void Commit();  // the pending blocks are flushed
+    void Fail(const char* where, std::size_t nofBufferedRecords = 0);
+
+    std::ofstream fFile;
+    G4String fFileName;
+    std::size_t fChunkSize = 0;
+    std::uint64_t fNbOfBytes = 0;  // flushed
+    std::uint64_t fNbOfPendingRecords = 0;  // written to the stream, not flushed
+    std::uint64_t fNbOfPendingBytes = 0;
+    std::uint64_t fNbOfPrimaries = 0;
+    G4double fPlaneZ = 0.;
+    std::vector<PhaseSpace::Record> fRecords;
+};
+
+}  // namespace B2a
+
+#endif
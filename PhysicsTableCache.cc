@@ -0,0 +1,263 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file PhysicsTableCache.cc
+/// \brief Implementation of the B2a::PhysicsTableCache class
+
+#include "PhysicsTableCache.hh"
+
+#include "FnvHash.hh"
+#include "PhysicsTableCacheMessenger.hh"
+
+#include "G4EmParameters.hh"
+#include "G4LogicalVolume.hh"
+#include "G4Material.hh"
+#include "G4Navigator.hh"
+#include "G4ProductionCuts.hh"
+#include "G4ProductionCutsTable.hh"
+#include "G4Region.hh"
+#include "G4StateManager.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4TransportationManager.hh"
+#include "G4VModularPhysicsList.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4VPhysicsConstructor.hh"
+#include "G4Version.hh"
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+G4String UniqueSuffix()
+{
+  std::ostringstream os;
+  os << std::hex << std::random_device{}() << '_'
+     << std::chrono::steady_clock::now().time_since_epoch().count();
+  return os.str();
+}
+}  // namespace
+
+namespace B2a
+{
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+PhysicsTableCache::PhysicsTableCache(G4VModularPhysicsList* physicsList)
+  : fPhysicsList(physicsList)
+{
+  auto directory = std::getenv("B2A_PHYSICS_CACHE");
+  fDirectory = directory ? directory : "physics_cache";
+
+  fMessenger = new PhysicsTableCacheMessenger(this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+PhysicsTableCache::~PhysicsTableCache()
+{
+  delete fMessenger;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool PhysicsTableCache::Notify(G4ApplicationState requestedState)
+{
+  if (!fEnabled || fDone) return true;
+
+  // Idle -> Init: (re)initialisation of the geometry or of the run, the
+  // last one before the first Idle -> GeomClosed builds the tables
+  auto currentState = G4StateManager::GetStateManager()->GetCurrentState();
+  if (currentState == G4State_Idle && requestedState == G4State_Init) {
+    Prepare();
+  }
+  else if (currentState == G4State_Idle && requestedState == G4State_GeomClosed) {
+    Store();
+    fDone = true;
+  }
+
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4String PhysicsTableCache::Describe() const
+{
+  std::ostringstream os;
+  os << "geant4=" << G4VERSION_NUMBER << '\n';
+
+  for (G4int i = 0;; ++i) {
+    auto physics = fPhysicsList->GetPhysics(i);
+    if (!physics) break;
+    os << "physics=" << physics->GetPhysicsName() << '\n';
+  }
+
+  auto emParameters = G4EmParameters::Instance();
+  os << "em=" << emParameters->MinKinEnergy() / keV << ',' << emParameters->MaxKinEnergy() / keV
+     << ',' << emParameters->NumberOfBinsPerDecade() << ','
+     << emParameters->LowestElectronEnergy() / keV << ','
+     << emParameters->MaxEnergyForCSDARange() / keV << " keV\n";
+
+  auto cutsTable = G4ProductionCutsTable::GetProductionCutsTable();
+  os << "cutsRange=" << cutsTable->GetLowEdgeEnergy() / keV << ','
+     << cutsTable->GetHighEdgeEnergy() / keV << " keV\n";
+
+  // Couples: walk the geometry as the kernel will do at the table build
+  auto world =
+    G4TransportationManager::GetTransportationManager()->GetNavigatorForTracking()->GetWorldVolume();
+  if (world) {
+    std::set<G4String> couples;
+    std::set<std::pair<const G4LogicalVolume*, const G4Region*>> done;
+    DescribeCouples(world->GetLogicalVolume(), nullptr, couples, done);
+    for (const auto& couple : couples) os << couple << '\n';
+  }
+
+  return os.str();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhysicsTableCache::DescribeCouples(
+  const G4LogicalVolume* lv, const G4Region* region, std::set<G4String>& couples,
+  std::set<std::pair<const G4LogicalVolume*, const G4Region*>>& done) const
+{
+  if (lv->IsRootRegion() && lv->GetRegion()) region = lv->GetRegion();
+  if (!done.insert({lv, region}).second) return;
+
+  auto cuts = (region && region->GetProductionCuts())
+                ? region->GetProductionCuts()
+                : G4ProductionCutsTable::GetProductionCutsTable()->GetDefaultProductionCuts();
+
+  auto material = lv->GetMaterial();
+  if (material) {
+    std::ostringstream os;
+    os << "couple=" << material->GetName() << ',' << material->GetDensity() / (g / cm3);
+    for (G4int i = 0; i < NumberOfG4CutIndex; ++i) {
+      os << ',' << cuts->GetProductionCut(i) / mm;
+    }
+    couples.insert(os.str());
+  }
+
+  for (std::size_t i = 0; i < lv->GetNoDaughters(); ++i) {
+    DescribeCouples(lv->GetDaughter(i)->GetLogicalVolume(), region, couples, done);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhysicsTableCache::Prepare()
+{
+  if (fRetrieving) {
+    fPhysicsList->ResetPhysicsTableRetrieved();
+    fRetrieving = false;
+  }
+
+  fDescription = Describe();
+  fEntry = (fs::path(fDirectory) / FnvHash(fDescription)).string();
+
+  std::error_code error;
+  if (!fs::is_directory(fEntry, error)) return;
+
+  std::ifstream manifest(fs::path(fEntry) / "key.txt");
+  std::ostringstream stored;
+  stored << manifest.rdbuf();
+  if (!manifest || stored.str() != fDescription) {
+    G4ExceptionDescription msg;
+    msg << "Stale entry " << fEntry << ", physics tables will be rebuilt";
+    G4Exception("PhysicsTableCache::Prepare()", "B2aTables001", JustWarning, msg);
+    Discard(fEntry);
+    return;
+  }
+
+  fPhysicsList->SetPhysicsTableRetrieved(fEntry);
+  fRetrieving = true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhysicsTableCache::Store()
+{
+  if (fRetrieving) {
+    // later builds (new couples) must not try to read this entry
+    G4bool retrieved = fPhysicsList->IsPhysicsTableRetrieved();
+    fPhysicsList->ResetPhysicsTableRetrieved();
+    fRetrieving = false;
+    if (retrieved) {
+      G4cout << G4endl << "----> Physics tables retrieved from " << fEntry << G4endl;
+      return;
+    }
+    G4ExceptionDescription msg;
+    msg << "Cannot retrieve " << fEntry << ", the entry is replaced";
+    G4Exception("PhysicsTableCache::Store()", "B2aTables002", JustWarning, msg);
+    Discard(fEntry);
+  }
+
+  // Write a private copy, then publish it with an atomic rename
+  std::error_code error;
+  fs::path temporary = fEntry + ".tmp_" + UniqueSuffix();
+  fs::create_directories(temporary, error);
+  if (error || !fPhysicsList->StorePhysicsTable(temporary.string())) {
+    G4ExceptionDescription msg;
+    msg << "Cannot write " << temporary;
+    G4Exception("PhysicsTableCache::Store()", "B2aTables003", JustWarning, msg);
+    fs::remove_all(temporary, error);
+    return;
+  }
+  {
+    std::ofstream manifest(temporary / "key.txt");
+    manifest << fDescription;
+  }
+
+  fs::rename(temporary, fEntry, error);
+  if (error) {
+    // another job published the same entry first
+    fs::remove_all(temporary, error);
+    return;
+  }
+  G4cout << G4endl << "----> Physics tables stored in " << fEntry << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhysicsTableCache::Discard(const G4String& entry) const
+{
+  // Move the entry out of the way first: only one job wins the rename,
+  // and no job can pick up a half-deleted entry
+  std::error_code error;
+  fs::path trash = entry + ".stale_" + UniqueSuffix();
+  fs::rename(entry, trash, error);
+  if (!error) fs::remove_all(trash, error);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}  // namespace B2a
@@ -0,0 +1,99 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file PhysicsTableCache.hh
+/// \brief Definition of the B2a::PhysicsTableCache class
+
+#ifndef B2aPhysicsTableCache_h
+#define B2aPhysicsTableCache_h 1
+
+#include "G4VStateDependent.hh"
+#include "globals.hh"
+
+#include <set>
+#include <utility>
+
+class G4LogicalVolume;
+class G4Region;
+class G4VModularPhysicsList;
+
+namespace B2a
+{
+
+class PhysicsTableCacheMessenger;
+
+/// On-disk cache of the physics tables built at the first run of a job.
+///
+/// The cache entry is a directory named after a hash of a description of
+/// everything the tables depend on: Geant4 version, physics constructors,
+/// EM table parameters and the (material, production cuts) couples of the
+/// current geometry. The full description is kept in the entry, and
+/// checked, to detect stale entries and hash collisions.
+///
+/// Before the first physics table build the tables are retrieved from the
+/// entry if it exists, after it they are stored if they were not. Entries
+/// are written in a private directory which is then atomically renamed, so
+/// that concurrent jobs on one node never see a partial entry; the losers
+/// of the race just discard their copy.
+///
+/// Geant4 only retrieves the tables of the processes which support it
+/// (electromagnetic ones), the other tables are still built.
+
+class PhysicsTableCache : public G4VStateDependent
+{
+  public:
+    PhysicsTableCache(G4VModularPhysicsList* physicsList);
+    ~PhysicsTableCache() override;
+
+    G4bool Notify(G4ApplicationState requestedState) override;
+
+    void SetEnabled(G4bool enabled) { fEnabled = enabled; }
+    void SetDirectory(const G4String& directory) { fDirectory = directory; }
+
+  private:
+    G4String Describe() const;
+    void DescribeCouples(const G4LogicalVolume* lv, const G4Region* region,
+                         std::set<G4String>& couples,
+                         std::set<std::pair<const G4LogicalVolume*, const G4Region*>>& done) const;
+    void Prepare();  // before each initialisation preceding the first run
+    void Store();  // at the start of the first run
+    void Discard(const G4String& entry) const;
+
+    G4VModularPhysicsList* fPhysicsList = nullptr;
+    PhysicsTableCacheMessenger* fMessenger = nullptr;
+
+    G4bool fEnabled = true;
+    G4String fDirectory;
+
+    G4bool fDone = false;  // the cache only serves the first table build
+    G4bool fRetrieving = false;
+    G4String fDescription;
+    G4String fEntry;
+};
+
+}  // namespace B2a
+
+#endif
@@ -0,0 +1,87 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file PhysicsTableCacheMessenger.cc
+/// \brief Implementation of the B2a::PhysicsTableCacheMessenger class
+
+#include "PhysicsTableCacheMessenger.hh"
+
+#include "PhysicsTableCache.hh"
+
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIdirectory.hh"
+
+namespace B2a
+{
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+PhysicsTableCacheMessenger::PhysicsTableCacheMessenger(PhysicsTableCache* cache) : fCache(cache)
+{
+  fDirectory = new G4UIdirectory("/B2/physics/");
+  fDirectory->SetGuidance("Physics tables control.");
+
+  fCacheCmd = new G4UIcmdWithABool("/B2/physics/cache", this);
+  fCacheCmd->SetGuidance("Retrieve the physics tables from the on-disk cache, or store them.");
+  fCacheCmd->SetParameterName("enabled", true);
+  fCacheCmd->SetDefaultValue(true);
+  fCacheCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fCacheCmd->SetToBeBroadcasted(false);
+
+  fCacheDirCmd = new G4UIcmdWithAString("/B2/physics/cacheDir", this);
+  fCacheDirCmd->SetGuidance("Directory of the physics table cache.");
+  fCacheDirCmd->SetGuidance("Default: $B2A_PHYSICS_CACHE, else physics_cache");
+  fCacheDirCmd->SetParameterName("name", false);
+  fCacheDirCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fCacheDirCmd->SetToBeBroadcasted(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+PhysicsTableCacheMessenger::~PhysicsTableCacheMessenger()
+{
+  delete fCacheCmd;
+  delete fCacheDirCmd;
+  delete fDirectory;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhysicsTableCacheMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+  if (command == fCacheCmd) {
+    fCache->SetEnabled(fCacheCmd->GetNewBoolValue(newValue));
+  }
+
+  if (command == fCacheDirCmd) {
+    fCache->SetDirectory(newValue);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}  // namespace B2a
@@ -0,0 +1,72 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file PhysicsTableCacheMessenger.hh
+/// \brief Definition of the B2a::PhysicsTableCacheMessenger class
+
+#ifndef B2aPhysicsTableCacheMessenger_h
+#define B2aPhysicsTableCacheMessenger_h 1
+
+#include "G4UImessenger.hh"
+
+class G4UIdirectory;
+class G4UIcmdWithABool;
+class G4UIcmdWithAString;
+
+namespace B2a
+{
+
+class PhysicsTableCache;
+
+/// Messenger class that defines commands for PhysicsTableCache.
+///
+/// It implements commands:
+/// - /B2/physics/cache true|false
+/// - /B2/physics/cacheDir name
+///
+/// Both must be given before the first run; the cache lives on the
+/// master only, so no command is broadcast.
+
+class PhysicsTableCacheMessenger : public G4UImessenger
+{
+  public:
+    PhysicsTableCacheMessenger(PhysicsTableCache*);
+    ~PhysicsTableCacheMessenger() override;
+
+    void SetNewValue(G4UIcommand*, G4String) override;
+
+  private:
+    PhysicsTableCache* fCache = nullptr;
+
+    G4UIdirectory* fDirectory = nullptr;
+
+    G4UIcmdWithABool* fCacheCmd = nullptr;
+    G4UIcmdWithAString* fCacheDirCmd = nullptr;
+};
+
+}  // namespace B2a
+
+#endif
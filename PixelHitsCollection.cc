@@ -0,0 +1,99 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file PixelHitsCollection.cc
+/// \brief Implementation of the B2a::PixelHitsCollection class
+
+#include "PixelHitsCollection.hh"
+
+#include "G4UnitsTable.hh"
+
+#include <algorithm>
+#include <iomanip>
+#include <tuple>
+
+namespace B2a
+{
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PixelHitsCollection::Reserve(std::size_t size)
+{
+  fLayer.reserve(size);
+  fPixel.reserve(size);
+  fEdep.reserve(size);
+  fTime.reserve(size);
+  fWeight.reserve(size);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PixelHitsCollection::Merge(std::vector<Entry> others)
+{
+  for (std::size_t i = 0; i < entries(); ++i) others.push_back(GetEntry(i));
+  std::sort(others.begin(), others.end(), [](const Entry& a, const Entry& b) {
+    return std::tie(a.layer, a.pixel, a.time, a.edep, a.weight)
+           < std::tie(b.layer, b.pixel, b.time, b.edep, b.weight);
+  });
+
+  fLayer.clear();
+  fPixel.clear();
+  fEdep.clear();
+  fTime.clear();
+  fWeight.clear();
+
+  // the first entry of a pixel has its earliest time
+  std::size_t first = 0;
+  while (first < others.size()) {
+    const auto& pixel = others[first];
+    G4double edep = 0.;
+    G4double weightedEdep = 0.;
+    std::size_t last = first;
+    for (; last < others.size(); ++last) {
+      if (others[last].layer != pixel.layer || others[last].pixel != pixel.pixel) break;
+      edep += others[last].edep;
+      weightedEdep += others[last].weight * others[last].edep;
+    }
+    Add(pixel.layer, pixel.pixel, edep, pixel.time, (edep > 0.) ? weightedEdep / edep : 1.);
+    first = last;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PixelHitsCollection::PrintAllHits()
+{
+  for (std::size_t i = 0; i < entries(); ++i) {
+    G4cout << "  layer: " << fLayer[i] << " pixel: " << fPixel[i] << " Edep: " << std::setw(7)
+           << G4BestUnit(fEdep[i], "Energy") << " Position: " << std::setw(7)
+           << G4BestUnit(GetPosition(i), "Length") << " Time: " << G4BestUnit(fTime[i], "Time")
+           << " Weight: " << fWeight[i] << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}  // namespace B2a
@@ -0,0 +1,141 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file PixelHitsCollection.hh
+/// \brief Definition of the B2a::PixelHitsCollection class
+
+#ifndef B2aPixelHitsCollection_h
+#define B2aPixelHitsCollection_h 1
+
+#include "G4ThreeVector.hh"
+#include "G4VHitsCollection.hh"
+#include "globals.hh"
+
+#include <vector>
+
+namespace B2a
+{
+
+/// Pixel grid of the layers: nofPixels x nofPixels square pixels covering
+/// the layer width, numbered iy * nofPixels + ix within a layer.
+
+struct PixelGrid {
+  G4int nofPixels = 0;  // per side, 0: no pixels (one hit per step)
+  G4double halfWidth = 0.;
+  G4double pitch = 0.;
+  std::vector<G4double> layerZ;  // centre of each layer, world frame
+
+  std::size_t GetNbOfCells() const { return layerZ.size() * nofPixels * nofPixels; }
+  G4ThreeVector GetCentre(G4int layer, G4int pixel) const
+  {
+    return G4ThreeVector(-halfWidth + (pixel % nofPixels + 0.5) * pitch,
+                         -halfWidth + (pixel / nofPixels + 0.5) * pitch, layerZ[layer]);
+  }
+};
+
+/// Pixel hits collection
+///
+/// The non-empty pixels of an event, in columns (structure of arrays)
+/// rather than as one hit object per pixel: layer, pixel number, summed
+/// energy deposit, time of the first deposit and weight. The pixels are
+/// ordered by layer, then pixel number.
+///
+/// The weight of a pixel is the mean of the weights of its deposits,
+/// weighted by their energy, so that weight x edep is the weighted sum of
+/// the deposits.
+
+class PixelHitsCollection : public G4VHitsCollection
+{
+  public:
+    // One pixel, as a row of the columns
+    struct Entry {
+      G4int layer;
+      G4int pixel;
+      G4double edep;
+      G4double time;
+      G4double weight;
+    };
+
+    PixelHitsCollection(const G4String& detName, const G4String& colName, const PixelGrid* grid)
+      : G4VHitsCollection(detName, colName), fGrid(grid)
+    {}
+    ~PixelHitsCollection() override = default;
+
+    void Reserve(std::size_t size);
+    void Add(G4int layer, G4int pixel, G4double edep, G4double time, G4double weight)
+    {
+      fLayer.push_back(layer);
+      fPixel.push_back(pixel);
+      fEdep.push_back(edep);
+      fTime.push_back(time);
+      fWeight.push_back(weight);
+    }
+
+    // methods from base class
+    std::size_t GetSize() const override { return fLayer.size(); }
+    void PrintAllHits() override;
+
+    std::size_t entries() const { return fLayer.size(); }
+    G4int GetLayer(std::size_t i) const { return fLayer[i]; }
+    G4int GetPixel(std::size_t i) const { return fPixel[i]; }
+    G4double GetEdep(std::size_t i) const { return fEdep[i]; }
+    G4double GetTime(std::size_t i) const { return fTime[i]; }
+    G4double GetWeight(std::size_t i) const { return fWeight[i]; }
+    G4ThreeVector GetPosition(std::size_t i) const
+    {
+      return fGrid->GetCentre(fLayer[i], fPixel[i]);
+    }
+    Entry GetEntry(std::size_t i) const
+    {
+      return {fLayer[i], fPixel[i], fEdep[i], fTime[i], fWeight[i]};
+    }
+
+    // Bytes of the columns (see MemoryMonitor)
+    std::size_t GetMemorySize() const
+    {
+      return (fLayer.capacity() + fPixel.capacity()) * sizeof(G4int)
+             + (fEdep.capacity() + fTime.capacity() + fWeight.capacity()) * sizeof(G4double);
+    }
+
+    // Adds pixels of the same grid (those of the sub-events, see
+    // SubEventDriver); the deposits of a pixel are summed in the order of
+    // their times, so that the result does not depend on the order of
+    // the pixels given
+    void Merge(std::vector<Entry> others);
+
+  private:
+    const PixelGrid* fGrid = nullptr;  // owned by the sensitive detector
+
+    std::vector<G4int> fLayer;
+    std::vector<G4int> fPixel;
+    std::vector<G4double> fEdep;
+    std::vector<G4double> fTime;
+    std::vector<G4double> fWeight;
+};
+
+}  // namespace B2a
+
+#endif
@@ -0,0 +1,350 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file Run.cc
+/// \brief Implementation of the B2a::Run class
+
+#include "Run.hh"
+
+#include "StateIO.hh"
+#include "SubEventDriver.hh"
+
+#include "G4Event.hh"
+#include "G4LogicalVolume.hh"
+#include "G4Material.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4VProcess.hh"
+
+#include <algorithm>
+#include <cmath>
+
+namespace B2a
+{
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Run::Merge(const G4Run* run)
+{
+  auto localRun = static_cast<const Run*>(run);
+
+  fNbOfHits += localRun->fNbOfHits;
+  fEdep += localRun->fEdep;
+  fNbOfWrittenHits += localRun->fNbOfWrittenHits;
+  fNbOfAcceptedEvents += localRun->fNbOfAcceptedEvents;
+  fNbOfAcceptedHits += localRun->fNbOfAcceptedHits;
+  fNbOfRecordedParticles += localRun->fNbOfRecordedParticles;
+
+  for (const auto& entry : localRun->fTriggerCounters) {
+    auto& counters = fTriggerCounters[entry.first];
+    counters.accepted += entry.second.accepted;
+    counters.weight += entry.second.weight;
+    counters.energy += entry.second.energy;
+    counters.angle += entry.second.angle;
+  }
+
+  for (G4int i = 0; i < kNbOfTimeBins; ++i) {
+    fEventTimes[i] += localRun->fEventTimes[i];
+  }
+  fMaxEventTime = std::max(fMaxEventTime, localRun->fMaxEventTime);
+
+  for (G4int i = 0; i < kNbOfHitBins; ++i) {
+    fHitSpectrum[i] += localRun->fHitSpectrum[i];
+    fHitSpectrum2[i] += localRun->fHitSpectrum2[i];
+  }
+
+  fStackScore.sum += localRun->fStackScore.sum;
+  fStackScore.sum2 += localRun->fStackScore.sum2;
+  const auto& layerScores = localRun->fLayerScores;
+  if (fLayerScores.size() < layerScores.size()) fLayerScores.resize(layerScores.size());
+  for (std::size_t i = 0; i < layerScores.size(); ++i) {
+    fLayerScores[i].sum += layerScores[i].sum;
+    fLayerScores[i].sum2 += layerScores[i].sum2;
+  }
+  fBiased = fBiased || localRun->fBiased;
+
+  const auto& cells = localRun->fCellCounters;
+  if (fCellCounters.size() < cells.size()) fCellCounters.resize(cells.size());
+  for (std::size_t i = 0; i < cells.size(); ++i) {
+    fCellCounters[i].entries += cells[i].entries;
+    fCellCounters[i].weight += cells[i].weight;
+    fCellCounters[i].split += cells[i].split;
+    fCellCounters[i].killed += cells[i].killed;
+  }
+
+  for (const auto& entry : localRun->fRegionCounters) {
+    auto& counters = fRegionCounters[entry.first];
+    counters.steps += entry.second.steps;
+    counters.secondaries += entry.second.secondaries;
+    counters.killed += entry.second.killed;
+  }
+
+  const auto& filter = localRun->fFilterCounters;
+  fFilterCounters.killedAtBirth += filter.killedAtBirth;
+  fFilterCounters.killedInFlight += filter.killedInFlight;
+  fFilterCounters.deferred += filter.deferred;
+  fFilterCounters.dropped += filter.dropped;
+  fFilterCounters.abortedEvents += filter.abortedEvents;
+
+  // the pointers are resolved here, in the worker which owns them
+  fProfiling = localRun->fProfiling;
+  for (const auto& entry : localRun->fProfileCounters) {
+    AddProfile(fProfile, entry.first, entry.second);
+  }
+  for (const auto& entry : localRun->fProfile) {
+    AddProfile(fProfile, entry.first, entry.second);
+  }
+
+  G4Run::Merge(run);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Run::RecordEvent(const G4Event* event)
+{
+  if (event->GetNumberOfPrimaryVertex() == 0) return;
+
+  // in sub-event mode the event of the master is complete only here
+  if (auto subEvent = SubEventDriver::GetInstance()) subEvent->CompleteEvent(event);
+  G4Run::RecordEvent(event);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Run::WriteState(std::ostream& os) const
+{
+  using namespace StateIO;
+
+  Write(os, fNbOfHits);
+  Write(os, fEdep);
+  Write(os, fNbOfWrittenHits);
+  Write(os, fNbOfAcceptedEvents);
+  Write(os, fNbOfAcceptedHits);
+  Write(os, fNbOfRecordedParticles);
+
+  Write(os, std::uint64_t(fTriggerCounters.size()));
+  for (const auto& entry : fTriggerCounters) {
+    WriteString(os, entry.first);
+    Write(os, entry.second);
+  }
+  Write(os, std::uint64_t(fRegionCounters.size()));
+  for (const auto& entry : fRegionCounters) {
+    WriteString(os, entry.first);
+    Write(os, entry.second);
+  }
+  Write(os, fFilterCounters);
+
+  Write(os, fEventTimes);
+  Write(os, fMaxEventTime);
+  Write(os, fHitSpectrum);
+  Write(os, fHitSpectrum2);
+
+  Write(os, fStackScore);
+  WriteVector(os, fLayerScores);
+  Write(os, fBiased);
+  WriteVector(os, fCellCounters);
+
+  // by name, the pointers are only meaningful in this job
+  Write(os, fProfiling);
+  auto profile = GetProfile();
+  Write(os, std::uint64_t(profile.size()));
+  for (const auto& entry : profile) {
+    WriteString(os, std::get<0>(entry.first));
+    WriteString(os, std::get<1>(entry.first));
+    WriteString(os, std::get<2>(entry.first));
+    WriteString(os, std::get<3>(entry.first));
+    Write(os, entry.second);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool Run::ReadState(std::istream& is, G4int nofEvents)
+{
+  using namespace StateIO;
+
+  Read(is, fNbOfHits);
+  Read(is, fEdep);
+  Read(is, fNbOfWrittenHits);
+  Read(is, fNbOfAcceptedEvents);
+  Read(is, fNbOfAcceptedHits);
+  Read(is, fNbOfRecordedParticles);
+
+  std::uint64_t size = 0;
+  std::string name;
+  Read(is, size);
+  for (std::uint64_t i = 0; i < size && ReadString(is, name); ++i) {
+    Read(is, fTriggerCounters[name]);
+  }
+  Read(is, size);
+  for (std::uint64_t i = 0; i < size && ReadString(is, name); ++i) {
+    Read(is, fRegionCounters[name]);
+  }
+  Read(is, fFilterCounters);
+
+  Read(is, fEventTimes);
+  Read(is, fMaxEventTime);
+  Read(is, fHitSpectrum);
+  Read(is, fHitSpectrum2);
+
+  Read(is, fStackScore);
+  ReadVector(is, fLayerScores);
+  Read(is, fBiased);
+  ReadVector(is, fCellCounters);
+
+  Read(is, fProfiling);
+  Read(is, size);
+  for (std::uint64_t i = 0; i < size && is; ++i) {
+    std::string volume, material, particle, process;
+    ReadString(is, volume);
+    ReadString(is, material);
+    ReadString(is, particle);
+    ReadString(is, process);
+    Read(is, fProfile[ProfileName(volume, material, particle, process)]);
+  }
+
+  numberOfEvent = nofEvents;
+  return bool(is);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Run::AddEventTime(G4double seconds)
+{
+  G4int bin = (seconds > kMinEventTime)
+                ? G4int(std::log10(seconds / kMinEventTime) * kTimeBinsPerDecade)
+                : 0;
+  ++fEventTimes[std::min(bin, kNbOfTimeBins - 1)];
+  fMaxEventTime = std::max(fMaxEventTime, seconds);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double Run::GetHitBinLowEdge(G4int bin)
+{
+  return keV * std::pow(10., G4double(bin) / kHitBinsPerDecade);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double Run::GetTimeBinLowEdge(G4int bin)
+{
+  return kMinEventTime * std::pow(10., G4double(bin) / kTimeBinsPerDecade);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Run::AddHitEdep(G4double edep, G4double weight)
+{
+  if (edep < keV) return;
+  G4int bin = G4int(std::log10(edep / keV) * kHitBinsPerDecade);
+  bin = std::min(bin, kNbOfHitBins - 1);
+  fHitSpectrum[bin] += weight;
+  fHitSpectrum2[bin] += weight * weight;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Run::AddEventScore(G4double weight, const std::vector<G4double>& layerEdep)
+{
+  if (weight != 1.) fBiased = true;
+
+  if (fLayerScores.size() < layerEdep.size()) fLayerScores.resize(layerEdep.size());
+  G4double total = 0.;
+  for (std::size_t i = 0; i < layerEdep.size(); ++i) {
+    fLayerScores[i].Add(layerEdep[i]);
+    total += layerEdep[i];
+  }
+  fStackScore.Add(total);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double Run::Score::GetRelativeError(G4int n) const
+{
+  if (n < 2 || sum <= 0.) return 1.;
+  G4double mean = sum / n;
+  G4double variance = std::max(sum2 / n - mean * mean, 0.) / (n - 1);
+  return std::sqrt(variance) / mean;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double Run::GetEventTimeQuantile(G4double q) const
+{
+  std::uint64_t nofEvents = 0;
+  for (auto count : fEventTimes) nofEvents += count;
+  if (nofEvents == 0) return 0.;
+
+  // first bin reaching the quantile, at its (logarithmic) centre
+  auto rank = std::uint64_t(std::ceil(q * nofEvents));
+  std::uint64_t sum = 0;
+  G4int bin = 0;
+  for (; bin < kNbOfTimeBins - 1; ++bin) {
+    sum += fEventTimes[bin];
+    if (sum >= std::max<std::uint64_t>(rank, 1)) break;
+  }
+  return std::min(fMaxEventTime,
+                  kMinEventTime * std::pow(10., (bin + 0.5) / kTimeBinsPerDecade));
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Run::AddProfile(Profile& profile, const ProfileKey& key, const ProfileCounters& counters)
+{
+  auto material = key.volume->GetMaterial();
+  ProfileName name{key.volume->GetName(), material ? material->GetName() : G4String("none"),
+                   key.particle->GetParticleName(),
+                   key.process ? key.process->GetProcessName() : G4String("primary")};
+  AddProfile(profile, name, counters);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Run::AddProfile(Profile& profile, const ProfileName& name, const ProfileCounters& counters)
+{
+  auto& total = profile[name];
+  total.steps += counters.steps;
+  total.tracks += counters.tracks;
+  total.edep += counters.edep;
+  total.time += counters.time;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+Run::Profile Run::GetProfile() const
+{
+  // sequential mode: the master run itself was filled in the event loop
+  Profile profile = fProfile;
+  for (const auto& entry : fProfileCounters) {
+    AddProfile(profile, entry.first, entry.second);
+  }
+  return profile;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}  // namespace B2a
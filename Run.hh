@@ -0,0 +1,303 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file Run.hh
+/// \brief Definition of the B2a::Run class
+
+#ifndef B2aRun_h
+#define B2aRun_h 1
+
+#include "G4Run.hh"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <map>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+class G4LogicalVolume;
+class G4ParticleDefinition;
+class G4VProcess;
+
+namespace B2a
+{
+
+class PhaseSpaceWriter;
+class VoxelScorer;
+
+/// Run class.
+///
+/// Each worker fills its own instance during the event loop, without any
+/// lock; the master instance sums them in Merge() at the end of the run.
+///
+/// The energy deposits, the hit spectrum and the trigger rates are sums
+/// of statistical weights: they estimate the quantities per primary of
+/// the unbiased source whatever the biasing.
+///
+/// The state of the accumulators is saved in the checkpoints (see
+/// CheckpointManager); a run read back from a checkpoint is added to the
+/// master run with Merge().
+
+class Run : public G4Run
+{
+  public:
+    // Step accounting of one region
+    struct RegionCounters {
+      std::uint64_t steps = 0;
+      std::uint64_t secondaries = 0;
+      std::uint64_t killed = 0;  // tracks killed by the region user limits
+    };
+
+    // Tracks removed by the acceptance filter (see StackingAction)
+    struct FilterCounters {
+      std::uint64_t killedAtBirth = 0;
+      std::uint64_t killedInFlight = 0;  // on entering a volume
+      std::uint64_t deferred = 0;
+      std::uint64_t dropped = 0;  // deferred, then not tracked
+      std::uint64_t abortedEvents = 0;
+    };
+
+    // Events accepted by a trigger condition, with the sums of their
+    // weights, Compton incident energy and scatter angle
+    struct TriggerCounters {
+      std::uint64_t accepted = 0;
+      G4double weight = 0.;
+      G4double energy = 0.;
+      G4double angle = 0.;
+    };
+
+    // Track population of an importance cell (see ImportanceSampler):
+    // tracks entering it, with their weights, and the splits and
+    // roulette kills on entering
+    struct CellCounters {
+      std::uint64_t entries = 0;
+      G4double weight = 0.;
+      std::uint64_t split = 0;  // copies added
+      std::uint64_t killed = 0;
+    };
+
+    // Weighted energy deposit of a layer, or of the stack, per event:
+    // sums of the event values and of their squares
+    struct Score {
+      G4double sum = 0.;
+      G4double sum2 = 0.;
+
+      void Add(G4double value)
+      {
+        sum += value;
+        sum2 += value * value;
+      }
+      // relative statistical error of the mean over n events
+      G4double GetRelativeError(G4int n) const;
+    };
+
+    // Stepping profile of one (volume, particle, process) entry; the
+    // process is the one which limited the steps, and which created the
+    // tracks (tracks are counted in the volume where they start)
+    struct ProfileCounters {
+      std::uint64_t steps = 0;
+      std::uint64_t tracks = 0;
+      G4double edep = 0.;
+      G4double time = 0.;  // wall clock, in s
+    };
+
+    // Key used in the event loop: pointers, only meaningful in the thread
+    // which fills the run
+    struct ProfileKey {
+      const G4LogicalVolume* volume;
+      const G4ParticleDefinition* particle;
+      const G4VProcess* process;
+      G4bool operator==(const ProfileKey& other) const
+      {
+        return volume == other.volume && particle == other.particle && process == other.process;
+      }
+    };
+    struct ProfileKeyHash {
+      std::size_t operator()(const ProfileKey& key) const
+      {
+        std::hash<const void*> hash;
+        return hash(key.volume) ^ (hash(key.particle) << 1) ^ (hash(key.process) << 2);
+      }
+    };
+
+    // Key of the merged profile: volume, material, particle and process names
+    using ProfileName = std::tuple<G4String, G4String, G4String, G4String>;
+    using Profile = std::map<ProfileName, ProfileCounters>;
+
+    Run() = default;
+    ~Run() override = default;
+
+    void Merge(const G4Run*) override;
+
+    // The events restored from a checkpoint are generated empty (see
+    // GeneratorAction), and not counted, nor are the sub-events; in
+    // sub-event mode the events are accounted here (see SubEventDriver)
+    void RecordEvent(const G4Event*) override;
+
+    // Binary state of the accumulators; a state read back counts the
+    // given number of events
+    void WriteState(std::ostream&) const;
+    G4bool ReadState(std::istream&, G4int nofEvents);
+
+    void AddEventHits(std::uint64_t nofHits, G4double edep)
+    {
+      fNbOfHits += nofHits;
+      fEdep += edep;
+    }
+    void AddWrittenHits(std::uint64_t nofHits, std::uint64_t nofLostHits = 0)
+    {
+      fNbOfWrittenHits += nofHits;
+      fNbOfWrittenHits -= std::min(nofLostHits, fNbOfWrittenHits);
+    }
+    void AddAcceptedEvent(std::uint64_t nofHits)
+    {
+      ++fNbOfAcceptedEvents;
+      fNbOfAcceptedHits += nofHits;
+    }
+    void AddRecordedParticle() { ++fNbOfRecordedParticles; }
+    void AddEventTime(G4double seconds);
+    void AddHitEdep(G4double edep, G4double weight);
+    void AddEventScore(G4double weight, const std::vector<G4double>& layerEdep);
+
+    std::uint64_t GetNbOfHits() const { return fNbOfHits; }
+    G4double GetEdep() const { return fEdep; }
+    std::uint64_t GetNbOfWrittenHits() const { return fNbOfWrittenHits; }
+    std::uint64_t GetNbOfAcceptedEvents() const { return fNbOfAcceptedEvents; }
+    std::uint64_t GetNbOfAcceptedHits() const { return fNbOfAcceptedHits; }
+    std::uint64_t GetNbOfRecordedParticles() const { return fNbOfRecordedParticles; }
+
+    // Scores of the stack and of each layer; biased if any event weight
+    // differs from 1 or with importance sampling
+    const Score& GetStackScore() const { return fStackScore; }
+    const std::vector<Score>& GetLayerScores() const { return fLayerScores; }
+    G4bool IsBiased() const { return fBiased; }
+
+    // Event processing time (s): quantile q in [0, 1], to the bin
+    // resolution (2.3%), and maximum
+    G4double GetEventTimeQuantile(G4double q) const;
+    G4double GetMaxEventTime() const { return fMaxEventTime; }
+
+    // Histogram of the event times, log bins from 1 us to 1000 s
+    static constexpr G4int kTimeBinsPerDecade = 100;
+    static constexpr G4int kNbOfTimeBins = 9 * kTimeBinsPerDecade;
+    static constexpr G4double kMinEventTime = 1.e-6;
+    static G4double GetTimeBinLowEdge(G4int bin);  // s
+    const std::array<std::uint64_t, kNbOfTimeBins>& GetEventTimes() const { return fEventTimes; }
+
+    // Spectrum of the hit energy deposits, log bins from 1 keV to 10 GeV
+    static constexpr G4int kHitBinsPerDecade = 10;
+    static constexpr G4int kNbOfHitBins = 7 * kHitBinsPerDecade;
+    static G4double GetHitBinLowEdge(G4int bin);
+    const std::array<G4double, kNbOfHitBins>& GetHitSpectrum() const { return fHitSpectrum; }
+    // sums of the squared hit weights per bin (variance of the spectrum)
+    const std::array<G4double, kNbOfHitBins>& GetHitSpectrum2() const { return fHitSpectrum2; }
+
+    // Counters of a region, created on first use (the returned reference
+    // stays valid for the lifetime of the run)
+    RegionCounters& GetRegionCounters(const G4String& region) { return fRegionCounters[region]; }
+    const std::map<G4String, RegionCounters>& GetRegionCounters() const { return fRegionCounters; }
+
+    // Counters of a trigger condition, created on first use
+    TriggerCounters& GetTriggerCounters(const G4String& name) { return fTriggerCounters[name]; }
+    const std::map<G4String, TriggerCounters>& GetTriggerCounters() const
+    {
+      return fTriggerCounters;
+    }
+
+    // Importance sampling with the given number of cells, 0 when disabled
+    void SetImportanceSampling(G4int nofCells)
+    {
+      fCellCounters.resize(nofCells);
+      if (nofCells > 0) fBiased = true;
+    }
+    CellCounters& GetCellCounters(G4int cell) { return fCellCounters[cell]; }
+    const std::vector<CellCounters>& GetCellCounters() const { return fCellCounters; }
+
+    FilterCounters& GetFilterCounters() { return fFilterCounters; }
+    const FilterCounters& GetFilterCounters() const { return fFilterCounters; }
+
+    // Phase-space recording of the thread (see SteppingAction), nullptr
+    // when disabled; the recorded particles are killed unless kept
+    void SetPhaseSpaceWriter(PhaseSpaceWriter* writer, G4bool keepRecorded)
+    {
+      fPhaseSpaceWriter = writer;
+      fKeepRecorded = keepRecorded;
+    }
+    PhaseSpaceWriter* GetPhaseSpaceWriter() const { return fPhaseSpaceWriter; }
+    G4bool KeepsRecorded() const { return fKeepRecorded; }
+
+    // Voxel scoring of the thread (see SteppingAction), nullptr when
+    // disabled
+    void SetVoxelScorer(VoxelScorer* scorer) { fVoxelScorer = scorer; }
+    VoxelScorer* GetVoxelScorer() const { return fVoxelScorer; }
+
+    // Stepping profile (only filled when enabled, see SteppingAction)
+    void SetProfiling(G4bool profiling) { fProfiling = profiling; }
+    G4bool IsProfiling() const { return fProfiling; }
+    ProfileCounters& GetProfileCounters(const ProfileKey& key) { return fProfileCounters[key]; }
+    Profile GetProfile() const;
+
+  private:
+    std::uint64_t fNbOfHits = 0;
+    G4double fEdep = 0.;  // total energy deposit in the layers
+    std::uint64_t fNbOfWrittenHits = 0;
+    std::uint64_t fNbOfAcceptedEvents = 0;  // by the trigger
+    std::uint64_t fNbOfAcceptedHits = 0;
+    std::uint64_t fNbOfRecordedParticles = 0;  // in the phase space
+    std::map<G4String, TriggerCounters> fTriggerCounters;
+    std::map<G4String, RegionCounters> fRegionCounters;
+    FilterCounters fFilterCounters;
+
+    std::array<std::uint64_t, kNbOfTimeBins> fEventTimes{};
+    G4double fMaxEventTime = 0.;
+
+    std::array<G4double, kNbOfHitBins> fHitSpectrum{};
+    std::array<G4double, kNbOfHitBins> fHitSpectrum2{};
+
+    Score fStackScore;
+    std::vector<Score> fLayerScores;
+    G4bool fBiased = false;
+    std::vector<CellCounters> fCellCounters;
+
+    static void AddProfile(Profile& profile, const ProfileKey& key, const ProfileCounters&);
+    static void AddProfile(Profile& profile, const ProfileName& name, const ProfileCounters&);
+
+    PhaseSpaceWriter* fPhaseSpaceWriter = nullptr;
+    G4bool fKeepRecorded = false;
+    VoxelScorer* fVoxelScorer = nullptr;
+
+    G4bool fProfiling = false;
+    std::unordered_map<ProfileKey, ProfileCounters, ProfileKeyHash> fProfileCounters;
+    Profile fProfile;  // merged (master), or read back
+};
+
+}  // namespace B2a
+
+#endif
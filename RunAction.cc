@@ -0,0 +1,613 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file RunAction.cc
+/// \brief Implementation of the B2a::RunAction class
+
+#include "RunAction.hh"
+
+#include "CheckpointManager.hh"
+#include "DetectorConstruction.hh"
+#include "OutputMessenger.hh"
+#include "Run.hh"
+#include "ShardDriver.hh"
+#include "StartupProfiler.hh"
+#include "SubEventDriver.hh"
+
+#include "G4RunManager.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4Threading.hh"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+namespace B2a
+{
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RunAction::RunAction()
+{
+  fMessenger = new OutputMessenger(this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RunAction::~RunAction()
+{
+  delete fMessenger;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4Run* RunAction::GenerateRun()
+{
+  auto run = new Run;
+  run->SetProfiling(fProfiling);
+  if (ProcessesEvents() && !fPhaseSpaceFileName.empty()) {
+    run->SetPhaseSpaceWriter(&fPhaseSpaceWriter, fKeepRecorded);
+  }
+  if (ProcessesEvents() && fVoxels.IsEnabled()) run->SetVoxelScorer(&fVoxels);
+  return run;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool RunAction::ProcessesEvents() const
+{
+  // in sub-event mode the master, the workers only processing sub-events
+  if (SubEventDriver::GetInstance()) return IsMaster();
+
+  // workers, or the only thread of a sequential application
+  return !IsMaster() || !G4Threading::IsMultithreadedApplication();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4String RunAction::GetFileTag() const
+{
+  // the outputs of the shards of a job share the storage, those of the
+  // jobs resuming a run the directory
+  auto shard = ShardDriver::GetInstance();
+  auto checkpoint = CheckpointManager::GetInstance();
+  return (shard ? shard->GetFileTag() : "") + (checkpoint ? checkpoint->GetFileTag() : "");
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RunAction::BeginOfRunAction(const G4Run* run)
+{
+  // inform the runManager to save random number seed
+  G4RunManager::GetRunManager()->SetRandomNumberStore(false);
+
+  if (IsMaster()) fTimer.Start();
+
+  auto checkpoint = CheckpointManager::GetInstance();
+
+  // In sub-event mode the master completes the events: the stages fed
+  // by the stepping, or by the end of the events, of the thread would
+  // miss the tracks of the sub-events (see SubEventDriver)
+  auto subEvent = SubEventDriver::GetInstance();
+  if (IsMaster() && subEvent) {
+    G4String stages;
+    if (!fPhaseSpaceFileName.empty()) stages += " phase-space recording,";
+    if (fVoxels.IsEnabled()) stages += " voxel scoring,";
+    if (checkpoint && checkpoint->IsEnabled()) stages += " checkpoints,";
+    if (!stages.empty()) {
+      stages.pop_back();
+      G4ExceptionDescription msg;
+      msg << "Not available in sub-event mode:" << stages;
+      G4Exception("RunAction::BeginOfRunAction()", "B2aSubEvent001", FatalException, msg);
+    }
+    subEvent->BeginOfRun();
+  }
+
+  // restores the checkpoint of a resumed run, before the threads start;
+  // the stages the checkpoints do not save cannot be resumed
+  if (IsMaster() && checkpoint) {
+    G4String unsaved;
+    if (fDigitizer.IsEnabled()) unsaved += " digitization,";
+    if (fVoxels.IsEnabled()) unsaved += " voxel scoring,";
+    if (!unsaved.empty()) unsaved.pop_back();
+    checkpoint->BeginOfRun(run->GetRunID(), unsaved);
+  }
+
+  G4String fileTag = GetFileTag();
+  auto shard = ShardDriver::GetInstance();
+  if (IsMaster() && shard && !shard->IsSplitRun()) {
+    G4ExceptionDescription msg;
+    msg << "Run " << run->GetRunID()
+        << " was not started with /B2/shard/beamOn, all the shards process the same events";
+    G4Exception("RunAction::BeginOfRunAction()", "B2aShard002", JustWarning, msg);
+  }
+
+  if (ProcessesEvents() && !fHitFileName.empty()) {
+    G4int threadID = G4Threading::IsWorkerThread() ? G4Threading::G4GetThreadId() : -1;
+    G4String fileName = fHitFileName + "_r" + std::to_string(run->GetRunID()) + fileTag;
+    if (threadID >= 0) fileName += "_t" + std::to_string(threadID);
+    fileName += ".b2h";
+    fHitWriter.Open(fileName, run->GetRunID(), threadID, fChunkSize);
+  }
+
+  if (ProcessesEvents() && !fPhaseSpaceFileName.empty()) {
+    auto detector = static_cast<const DetectorConstruction*>(
+      G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+    G4double planeZ = detector->GetTargetExtent().zMax + PhaseSpace::kPlaneOffset;
+    G4int threadID = G4Threading::IsWorkerThread() ? G4Threading::G4GetThreadId() : -1;
+    G4String fileName = fPhaseSpaceFileName + "_r" + std::to_string(run->GetRunID()) + fileTag;
+    if (threadID >= 0) fileName += "_t" + std::to_string(threadID);
+    fileName += ".phsp";
+    fPhaseSpaceWriter.Open(fileName, run->GetRunID(), threadID, planeZ, fChunkSize);
+  }
+
+  if (ProcessesEvents()) {
+    fTrigger.BeginOfRun();
+    fDigitizer.BeginOfRun(run->GetRunID());
+  }
+
+  // also on the master, which adds up the histograms and voxels of the
+  // workers
+  fHistograms.BeginOfRun(run->GetRunID());
+  fVoxels.BeginOfRun(run->GetRunID(), fileTag);
+  fMemory.BeginOfRun(run->GetRunID());
+
+  // the outputs of the thread are known to the checkpoints from now on
+  fCompletedEvents.clear();
+  fEventsSinceCheckpoint = 0;
+  if (ProcessesEvents() && checkpoint && checkpoint->IsEnabled()) PostCheckpoint(run);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RunAction::EndOfEvent(G4int eventID)
+{
+  if (fPhaseSpaceWriter.IsOpen()) fPhaseSpaceWriter.EndOfEvent();
+
+  auto checkpoint = CheckpointManager::GetInstance();
+  if (!checkpoint || !checkpoint->IsEnabled()) return;
+
+  if (!fCompletedEvents.empty() && fCompletedEvents.back().last == eventID) {
+    ++fCompletedEvents.back().last;
+  }
+  else {
+    fCompletedEvents.push_back({eventID, eventID + 1});
+  }
+
+  if (++fEventsSinceCheckpoint >= checkpoint->GetInterval()) {
+    PostCheckpoint(G4RunManager::GetRunManager()->GetCurrentRun());
+    fEventsSinceCheckpoint = 0;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RunAction::PostCheckpoint(const G4Run* run)
+{
+  // the state is serialised here, the file written by the writer thread
+  // of the checkpoint manager
+  CheckpointManager::Segment segment;
+  segment.events = fCompletedEvents;
+  if (fHitWriter.IsOpen()) {
+    segment.hitFile = fHitWriter.GetFileName();
+    segment.hitFileSize = fHitWriter.Sync();
+  }
+  if (fPhaseSpaceWriter.IsOpen()) {
+    segment.phaseSpaceFile = fPhaseSpaceWriter.GetFileName();
+    segment.phaseSpaceFileSize = fPhaseSpaceWriter.Sync();
+  }
+  std::ostringstream runState;
+  static_cast<const Run*>(run)->WriteState(runState);
+  segment.run = runState.str();
+  std::ostringstream histoState;
+  fHistograms.WriteState(histoState);
+  segment.histograms = histoState.str();
+
+  G4int threadID = G4Threading::IsWorkerThread() ? G4Threading::G4GetThreadId() : -1;
+  CheckpointManager::GetInstance()->Post(threadID, std::move(segment));
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RunAction::EndOfRunAction(const G4Run* run)
+{
+  // the last state of the thread, its outputs complete
+  auto checkpoint = CheckpointManager::GetInstance();
+  if (ProcessesEvents() && checkpoint && checkpoint->IsEnabled()) PostCheckpoint(run);
+
+  // write the last, partially filled, block; digitize the last batch
+  fHitWriter.Close();
+  fPhaseSpaceWriter.Close();
+  fDigitizer.EndOfRun();
+
+  // the workers fold their last voxel event before the master adds them
+  if (!IsMaster()) {
+    fVoxels.EndOfRun();
+    fMemory.EndOfRun();
+    return;
+  }
+
+  fTimer.Stop();
+
+  G4int nofThreads = std::max(1, G4RunManager::GetRunManager()->GetNumberOfThreads());
+  G4double wallTime = fTimer.GetRealElapsed();
+
+  // the states restored from the checkpoint complete the run
+  if (checkpoint) {
+    auto masterRun = static_cast<Run*>(G4RunManager::GetRunManager()->GetNonConstCurrentRun());
+    checkpoint->EndOfRun(masterRun, &fHistograms);
+  }
+
+  // also for an empty share, so that the merge sees all the shards
+  auto localRun = static_cast<const Run*>(run);
+  if (auto shard = ShardDriver::GetInstance()) {
+    shard->WriteSummary(localRun, wallTime, nofThreads);
+  }
+
+  G4int nofEvents = run->GetNumberOfEvent();
+  if (nofEvents == 0) return;
+
+  auto shard = ShardDriver::GetInstance();
+  fHistograms.EndOfRun(nofEvents, shard ? shard->GetFileTag() : "");
+  fVoxels.EndOfRun();
+
+  G4double rate = (wallTime > 0.) ? nofEvents / wallTime : 0.;
+
+  G4cout << G4endl << "--------------------End of Global Run-----------------------" << G4endl
+         << " Run " << run->GetRunID() << ": " << nofEvents << " events in " << wallTime
+         << " s on " << nofThreads << " thread(s), " << rate << " events/s" << G4endl
+         << "B2a-throughput run=" << run->GetRunID() << " threads=" << nofThreads
+         << " events=" << nofEvents << " wall_s=" << wallTime << " events_per_s=" << rate
+         << G4endl;
+
+  G4double peakRSS = MemoryMonitor::GetPeakRSS();
+  G4cout << " Event time: " << localRun->GetEventTimeQuantile(0.5) * 1.e3 << " ms median, "
+         << localRun->GetEventTimeQuantile(0.99) * 1.e3 << " ms 99%, peak RSS " << peakRSS
+         << " MB" << G4endl
+         << "B2a-latency run=" << run->GetRunID()
+         << " p50_ms=" << localRun->GetEventTimeQuantile(0.5) * 1.e3
+         << " p90_ms=" << localRun->GetEventTimeQuantile(0.9) * 1.e3
+         << " p99_ms=" << localRun->GetEventTimeQuantile(0.99) * 1.e3
+         << " max_ms=" << localRun->GetMaxEventTime() * 1.e3 << " peak_rss_MB=" << peakRSS
+         << G4endl;
+
+  G4cout << " Layers: " << G4double(localRun->GetNbOfHits()) / nofEvents << " hits, "
+         << localRun->GetEdep() / MeV / nofEvents << " MeV per event" << G4endl;
+
+  auto nofHits = localRun->GetNbOfWrittenHits();
+  if (nofHits > 0) {
+    G4double hitRate = (wallTime > 0.) ? nofHits / wallTime : 0.;
+    G4cout << " Hit output: " << nofHits << " hits, "
+           << nofHits * HitWriter::kHitSize / 1048576. << " MB, " << hitRate / 1.e6
+           << " Mhits/s" << G4endl;
+  }
+
+  auto nofRecorded = localRun->GetNbOfRecordedParticles();
+  if (nofRecorded > 0) {
+    G4cout << " Phase space: " << nofRecorded << " particles recorded, "
+           << G4double(nofRecorded) / nofEvents << " per event, "
+           << nofRecorded * sizeof(PhaseSpace::Record) / 1048576. << " MB" << G4endl;
+  }
+
+  PrintRegionReport(localRun);
+  PrintFilterReport(localRun);
+  PrintTriggerReport(localRun);
+  PrintFomReport(localRun);
+  PrintImportanceReport(localRun);
+  PrintDigiReport();
+  PrintProfileReport(localRun);
+  if (auto subEvent = SubEventDriver::GetInstance()) subEvent->EndOfRun(run->GetRunID());
+  fMemory.EndOfRun();
+
+  // once, after the first run with events
+  StartupProfiler::Instance()->Print();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RunAction::PrintRegionReport(const Run* run)
+{
+  const auto& regions = run->GetRegionCounters();
+  if (regions.empty()) return;
+
+  G4int nofEvents = run->GetNumberOfEvent();
+  G4bool first = (fReferenceEvents == 0);
+  if (first) {
+    fRegionReference = regions;
+    fReferenceEvents = nofEvents;
+  }
+
+  G4cout << G4endl << " Per-region accounting, per event"
+         << (first ? " (reference run)" : ", saved w.r.t. the reference run") << G4endl
+         << std::setw(26) << std::left << " Region" << std::right << std::setw(14) << "steps"
+         << std::setw(14) << "secondaries" << std::setw(12) << "killed";
+  if (!first) G4cout << std::setw(14) << "saved steps" << std::setw(14) << "saved sec.";
+  G4cout << G4endl;
+
+  auto perEvent = [](std::uint64_t count, G4int events) { return G4double(count) / events; };
+
+  for (const auto& entry : regions) {
+    const auto& counters = entry.second;
+    G4double steps = perEvent(counters.steps, nofEvents);
+    G4double secondaries = perEvent(counters.secondaries, nofEvents);
+    G4cout << " " << std::setw(25) << std::left << entry.first << std::right << std::setw(14)
+           << steps << std::setw(14) << secondaries << std::setw(12)
+           << perEvent(counters.killed, nofEvents);
+    if (!first) {
+      const auto& reference = fRegionReference[entry.first];
+      G4cout << std::setw(14) << perEvent(reference.steps, fReferenceEvents) - steps
+             << std::setw(14) << perEvent(reference.secondaries, fReferenceEvents) - secondaries;
+    }
+    G4cout << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RunAction::PrintFilterReport(const Run* run)
+{
+  const auto& filter = run->GetFilterCounters();
+  auto removed = filter.killedAtBirth + filter.killedInFlight + filter.dropped;
+  if (removed == 0 && filter.deferred == 0) return;
+
+  G4int nofEvents = run->GetNumberOfEvent();
+  auto perEvent = [nofEvents](std::uint64_t count) { return G4double(count) / nofEvents; };
+
+  // saved steps: against the reference run, which should be unfiltered
+  std::uint64_t steps = 0;
+  for (const auto& entry : run->GetRegionCounters()) steps += entry.second.steps;
+  std::uint64_t referenceSteps = 0;
+  for (const auto& entry : fRegionReference) referenceSteps += entry.second.steps;
+  G4double savedSteps =
+    (fReferenceEvents > 0) ? G4double(referenceSteps) / fReferenceEvents - perEvent(steps) : 0.;
+
+  G4cout << G4endl << " Acceptance filter, per event: " << perEvent(filter.killedAtBirth)
+         << " tracks killed at birth, " << perEvent(filter.killedInFlight) << " in flight, "
+         << perEvent(filter.deferred) << " deferred, " << perEvent(filter.dropped)
+         << " dropped; " << filter.abortedEvents << " events ended early; " << savedSteps
+         << " steps saved" << G4endl
+         << "B2a-filter run=" << run->GetRunID() << " killed_birth=" << filter.killedAtBirth
+         << " killed_flight=" << filter.killedInFlight << " deferred=" << filter.deferred
+         << " dropped=" << filter.dropped << " aborted_events=" << filter.abortedEvents
+         << " saved_steps_per_event=" << savedSteps
+         << " hits_per_event=" << perEvent(run->GetNbOfHits())
+         << " edep_MeV_per_event=" << run->GetEdep() / MeV / nofEvents << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RunAction::PrintTriggerReport(const Run* run)
+{
+  // the conditions of the master are those of the workers (broadcast)
+  const auto& conditions = fTrigger.GetConditions();
+  if (conditions.empty()) return;
+
+  G4int nofEvents = run->GetNumberOfEvent();
+  const auto& allCounters = run->GetTriggerCounters();
+
+  G4cout << G4endl << " Trigger" << G4endl << std::setw(26) << std::left << " Condition"
+         << std::right << std::setw(14) << "accepted" << std::setw(12) << "rate %"
+         << std::setw(14) << "E0 [keV]" << std::setw(14) << "theta [deg]" << G4endl;
+  for (const auto& condition : conditions) {
+    auto entry = allCounters.find(condition.name);
+    auto counters = (entry != allCounters.end()) ? entry->second : Run::TriggerCounters();
+    G4double rate = 100. * counters.weight / nofEvents;
+    G4double accepted = std::max<G4double>(G4double(counters.accepted), 1.);
+    G4cout << " " << std::setw(25) << std::left << condition.name << std::right << std::setw(14)
+           << counters.accepted << std::setw(12) << rate << std::setw(14)
+           << counters.energy / accepted / keV << std::setw(14) << counters.angle / accepted / deg
+           << G4endl << "B2a-trigger run=" << run->GetRunID() << " name=" << condition.name
+           << " accepted=" << counters.accepted << " rate=" << rate / 100. << G4endl;
+  }
+
+  auto nofHits = run->GetNbOfHits();
+  G4cout << " Accepted: " << run->GetNbOfAcceptedEvents() << " events ("
+         << 100. * run->GetNbOfAcceptedEvents() / nofEvents << "%), "
+         << run->GetNbOfAcceptedHits() << " hits ("
+         << (nofHits > 0 ? 100. * run->GetNbOfAcceptedHits() / nofHits : 0.)
+         << "% of the output)" << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RunAction::PrintFomReport(const Run* run)
+{
+  const auto& layerScores = run->GetLayerScores();
+  if (layerScores.empty()) return;
+
+  G4int nofEvents = run->GetNumberOfEvent();
+  G4double time = fTimer.GetRealElapsed();
+  G4bool biased = run->IsBiased();
+
+  std::vector<const Run::Score*> scores = {&run->GetStackScore()};
+  for (const auto& score : layerScores) scores.push_back(&score);
+  G4bool compare = biased && fFomReference.size() == scores.size();
+
+  G4cout << G4endl << " Figure of merit of the weighted energy deposit per primary ("
+         << (biased ? "biased" : "unbiased") << " source)" << G4endl << std::setw(26)
+         << std::left << " Scope" << std::right << std::setw(14) << "mean [MeV]" << std::setw(12)
+         << "error %" << std::setw(14) << "FOM [1/s]" << std::setw(12)
+         << (compare ? "gain" : "") << G4endl;
+
+  std::vector<G4double> foms;
+  for (std::size_t i = 0; i < scores.size(); ++i) {
+    G4double mean = scores[i]->sum / nofEvents;
+    G4double error = scores[i]->GetRelativeError(nofEvents);
+    G4double fom = (time > 0. && error > 0.) ? 1. / (error * error * time) : 0.;
+    G4double gain = (compare && fFomReference[i] > 0.) ? fom / fFomReference[i] : 0.;
+    foms.push_back(fom);
+
+    G4String scope = (i == 0) ? G4String("stack") : "layer" + std::to_string(i - 1);
+    G4cout << " " << std::setw(25) << std::left << scope << std::right << std::setw(14)
+           << mean / MeV << std::setw(12) << 100. * error << std::setw(14) << fom;
+    if (compare) G4cout << std::setw(12) << gain;
+    G4cout << G4endl << "B2a-fom run=" << run->GetRunID() << " biased=" << biased
+           << " scope=" << scope << " mean_MeV=" << mean / MeV << " rel_err=" << error
+           << " fom=" << fom;
+    if (compare) G4cout << " gain=" << gain;
+    G4cout << G4endl;
+  }
+
+  if (!biased) fFomReference = foms;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RunAction::PrintImportanceReport(const Run* run)
+{
+  const auto& cells = run->GetCellCounters();
+  if (cells.empty()) return;
+
+  auto detector = static_cast<const DetectorConstruction*>(
+    G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+  const auto& layerScores = run->GetLayerScores();
+  G4int nofEvents = run->GetNumberOfEvent();
+
+  G4cout << G4endl << " Importance cells (cell i + 1: layer i to the next layer)" << G4endl
+         << std::setw(6) << "cell" << std::setw(12) << "importance" << std::setw(14)
+         << "entries" << std::setw(14) << "weight" << std::setw(12) << "split" << std::setw(12)
+         << "killed" << std::setw(12) << "error %" << G4endl;
+
+  for (std::size_t i = 0; i < cells.size(); ++i) {
+    G4int layer = G4int(i) - 1;
+    G4double importance = (layer >= 0) ? detector->GetLayerImportance(layer) : 1.;
+    G4double error = (layer >= 0 && layer < G4int(layerScores.size()))
+                       ? layerScores[layer].GetRelativeError(nofEvents)
+                       : 0.;
+    G4cout << std::setw(6) << i << std::setw(12) << importance << std::setw(14)
+           << cells[i].entries << std::setw(14) << cells[i].weight << std::setw(12)
+           << cells[i].split << std::setw(12) << cells[i].killed << std::setw(12)
+           << 100. * error << G4endl;
+    G4cout << "B2a-importance run=" << run->GetRunID() << " cell=" << i << " layer=" << layer
+           << " importance=" << importance << " entries=" << cells[i].entries
+           << " weight=" << cells[i].weight << " split=" << cells[i].split
+           << " killed=" << cells[i].killed << " rel_err=" << error << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RunAction::PrintDigiReport()
+{
+  // the workers have added their summaries at their end of run
+  auto total = Digitizer::TakeTotal();
+  if (total.materials.empty()) return;
+
+  G4cout << G4endl << " Digitization" << G4endl << std::setw(26) << std::left << " Material"
+         << std::right << std::setw(14) << "hits" << std::setw(14) << "digits" << std::setw(12)
+         << "eff. %" << std::setw(16) << "mean [keV]" << G4endl;
+
+  std::uint64_t nofHits = 0;
+  std::uint64_t nofDigits = 0;
+  for (const auto& entry : total.materials) {
+    const auto& sums = entry.second;
+    nofHits += sums.hits;
+    nofDigits += sums.digits;
+    G4cout << " " << std::setw(25) << std::left << entry.first << std::right << std::setw(14)
+           << sums.hits << std::setw(14) << sums.digits << std::setw(12)
+           << (sums.hits > 0 ? 100. * sums.digits / sums.hits : 0.) << std::setw(16)
+           << (sums.weight > 0. ? sums.energy / sums.weight / keV : 0.) << G4endl;
+  }
+
+  G4double rate = (total.stageTime > 0.) ? nofHits / total.stageTime : 0.;
+  G4cout << " Stage: " << total.batches << " batches, " << total.stageTime << " s ("
+         << rate / 1.e6 << " Mhits/s), workers waited " << total.waitTime << " s" << G4endl
+         << "B2a-digi hits=" << nofHits << " digits=" << nofDigits << " batches=" << total.batches
+         << " stage_s=" << total.stageTime << " wait_s=" << total.waitTime
+         << " hits_per_s=" << rate << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RunAction::PrintProfileReport(const Run* run)
+{
+  if (!run->IsProfiling()) return;
+
+  auto profile = run->GetProfile();
+  if (profile.empty()) return;
+
+  std::vector<const Run::Profile::value_type*> entries;
+  Run::ProfileCounters total;
+  for (const auto& entry : profile) {
+    entries.push_back(&entry);
+    total.steps += entry.second.steps;
+    total.tracks += entry.second.tracks;
+    total.edep += entry.second.edep;
+    total.time += entry.second.time;
+  }
+  std::sort(entries.begin(), entries.end(),
+            [](auto a, auto b) { return a->second.time > b->second.time; });
+
+  // the table only shows the most expensive entries, the file all of them
+  const std::size_t nofLines = 20;
+  G4cout << G4endl << " Stepping profile, " << entries.size() << " entries, top "
+         << std::min(nofLines, entries.size()) << " by time (all threads)" << G4endl
+         << std::setw(13) << std::left << " Volume" << std::setw(22) << "Material" << std::setw(12)
+         << "Particle" << std::setw(16) << "Process" << std::right << std::setw(12) << "steps"
+         << std::setw(10) << "tracks" << std::setw(12) << "edep [MeV]" << std::setw(10)
+         << "time [s]" << std::setw(8) << "time %" << std::setw(10) << "ns/step" << G4endl;
+
+  auto printLine = [&total](const Run::ProfileName& name, const Run::ProfileCounters& counters) {
+    G4cout << " " << std::setw(12) << std::left << std::get<0>(name) << std::setw(22)
+           << std::get<1>(name) << std::setw(12) << std::get<2>(name) << std::setw(16)
+           << std::get<3>(name) << std::right << std::setw(12) << counters.steps << std::setw(10)
+           << counters.tracks << std::setw(12) << counters.edep / MeV << std::setw(10)
+           << counters.time << std::setw(8)
+           << (total.time > 0. ? 100. * counters.time / total.time : 0.) << std::setw(10)
+           << (counters.steps > 0 ? 1.e9 * counters.time / counters.steps : 0.) << G4endl;
+  };
+  for (std::size_t i = 0; i < std::min(nofLines, entries.size()); ++i) {
+    printLine(entries[i]->first, entries[i]->second);
+  }
+  printLine({"total", "", "", ""}, total);
+
+  if (fProfileFileName.empty()) return;
+
+  G4String fileName =
+    fProfileFileName + "_r" + std::to_string(run->GetRunID()) + GetFileTag() + ".csv";
+  std::ofstream file(fileName);
+  if (!file) {
+    G4ExceptionDescription msg;
+    msg << "Cannot open profile file " << fileName;
+    G4Exception("RunAction::PrintProfileReport()", "B2aProfile001", JustWarning, msg);
+    return;
+  }
+  file << "volume,material,particle,process,steps,tracks,edep_MeV,time_s\n";
+  for (auto entry : entries) {
+    const auto& name = entry->first;
+    const auto& counters = entry->second;
+    file << std::get<0>(name) << ',' << std::get<1>(name) << ',' << std::get<2>(name) << ','
+         << std::get<3>(name) << ',' << counters.steps << ',' << counters.tracks << ','
+         << counters.edep / MeV << ',' << counters.time << '\n';
+  }
+  G4cout << " Stepping profile written to " << fileName << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}  // namespace B2a
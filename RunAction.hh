@@ -0,0 +1,181 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file RunAction.hh
+/// \brief Definition of the B2a::RunAction class
+
+#ifndef B2aRunAction_h
+#define B2aRunAction_h 1
+
+#include "CheckpointManager.hh"
+#include "CoincidenceTrigger.hh"
+#include "Digitizer.hh"
+#include "HitWriter.hh"
+#include "MemoryMonitor.hh"
+#include "OnlineHistograms.hh"
+#include "PhaseSpaceWriter.hh"
+#include "Run.hh"
+#include "VoxelScorer.hh"
+
+#include "G4Timer.hh"
+#include "G4UserRunAction.hh"
+
+class G4Run;
+
+namespace B2a
+{
+
+class OutputMessenger;
+
+/// Run action class.
+///
+/// On the master it times the event loop and prints the run throughput,
+/// including a single "B2a-throughput" line meant to be parsed by scripts
+/// (see scaling.sh), and the event time quantiles and peak memory in a
+/// "B2a-latency" line (see benchmark.sh).
+///
+/// Each thread processing events owns its outputs and scorers, opened at
+/// the beginning of each run; the master adds them up, prints and writes
+/// them at the end of the run. In a sharded job (see ShardDriver) the
+/// output files carry the shard number, and in sub-event mode (see
+/// SubEventDriver) the master is the thread processing events.
+
+class RunAction : public G4UserRunAction
+{
+  public:
+    RunAction();
+    ~RunAction() override;
+
+    G4Run* GenerateRun() override;
+    void BeginOfRunAction(const G4Run*) override;
+    void EndOfRunAction(const G4Run*) override;
+
+    // Real time of the last event loop (master)
+    G4double GetEventLoopTime() const { return fTimer.GetRealElapsed(); }
+
+    void SetHitFileName(const G4String& name) { fHitFileName = name; }
+    void SetChunkSize(G4int size) { fChunkSize = size; }
+    void SetProfiling(G4bool profiling) { fProfiling = profiling; }
+    void SetProfileFileName(const G4String& name) { fProfileFileName = name; }
+    void SetPhaseSpaceFileName(const G4String& name) { fPhaseSpaceFileName = name; }
+    void SetKeepRecorded(G4bool keep) { fKeepRecorded = keep; }
+
+    // The writer of this thread, nullptr if the hit output is disabled
+    HitWriter* GetHitWriter() { return fHitWriter.IsOpen() ? &fHitWriter : nullptr; }
+
+    Digitizer* GetDigitizer() { return &fDigitizer; }
+    CoincidenceTrigger* GetTrigger() { return &fTrigger; }
+
+    // The histograms of this thread, nullptr if they are disabled
+    OnlineHistograms* GetHistograms() { return fHistograms.IsEnabled() ? &fHistograms : nullptr; }
+
+    // The voxel scorer of this thread, nullptr if it is disabled
+    VoxelScorer* GetVoxels() { return fVoxels.IsEnabled() ? &fVoxels : nullptr; }
+
+    MemoryMonitor* GetMemoryMonitor() { return &fMemory; }
+
+    // An event has been accounted (see EventAction)
+    void EndOfEvent(G4int eventID);
+
+  private:
+    G4bool ProcessesEvents() const;
+    // Tag of the output files of the run: the shard number (see
+    // ShardDriver) and the generation of a resumed run
+    G4String GetFileTag() const;
+
+    // In a checkpointed run (see CheckpointManager) each thread processing
+    // events posts its state when it has opened its outputs, every
+    // /B2/checkpoint/interval of its events, and at its end of run
+    void PostCheckpoint(const G4Run*);
+
+    // Steps, secondaries and killed tracks per region; the first run of
+    // the job is the reference for the savings of the following runs
+    void PrintRegionReport(const Run*);
+
+    // Tracks removed by the acceptance filter (/B2/filter/) and steps
+    // saved w.r.t. the reference run ("B2a-filter" line)
+    void PrintFilterReport(const Run*);
+
+    void PrintDigiReport();  // summary of the digitizers of all threads
+    void PrintTriggerReport(const Run*);  // accept rate of each condition
+
+    // Figure of merit 1/(R^2 T) of the weighted deposit in the stack and
+    // in each layer, R its relative error and T the wall time of the event
+    // loop ("B2a-fom" lines); the last unbiased run is the reference for
+    // the gain of a biased run (see GeneratorAction)
+    void PrintFomReport(const Run*);
+
+    // Track population of each importance cell with the error of its layer
+    // ("B2a-importance" lines), to tune the importances for errors flat
+    // along the stack
+    void PrintImportanceReport(const Run*);
+
+    // Stepping profile (see SteppingAction) sorted by time, optionally
+    // written to a CSV file (/B2/output/profile)
+    void PrintProfileReport(const Run*);
+
+    G4Timer fTimer;
+
+    // hits of the events passing the trigger, opened when a file name is set
+    G4String fHitFileName;
+    std::size_t fChunkSize = 65536;
+    HitWriter fHitWriter;
+
+    // particles crossing the plane downstream of the target (see
+    // SteppingAction), to be replayed with /B2/source/replay
+    G4String fPhaseSpaceFileName;
+    G4bool fKeepRecorded = false;
+    PhaseSpaceWriter fPhaseSpaceWriter;
+
+    Digitizer fDigitizer;  // fed the events passing the trigger
+    CoincidenceTrigger fTrigger;
+    OnlineHistograms fHistograms;  // /B2/histo/
+    VoxelScorer fVoxels;  // /B2/voxel/
+
+    // told the end of each event; the master prints the memory of the
+    // shared data and of each thread (/B2/memory/)
+    MemoryMonitor fMemory{&fHitWriter, &fPhaseSpaceWriter, &fHistograms, &fVoxels, &fDigitizer};
+
+    // events completed in this run, since the last checkpoint
+    std::vector<CheckpointManager::EventRange> fCompletedEvents;
+    G4int fEventsSinceCheckpoint = 0;
+
+    G4bool fProfiling = false;
+    G4String fProfileFileName;
+
+    OutputMessenger* fMessenger = nullptr;
+
+    // per-event region counters of the reference run (master)
+    std::map<G4String, Run::RegionCounters> fRegionReference;
+    G4int fReferenceEvents = 0;
+
+    // figures of merit of the last unbiased run: stack, then each layer
+    std::vector<G4double> fFomReference;
+};
+
+}  // namespace B2a
+
+#endif
@@ -0,0 +1,191 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file ShardDriver.cc
+/// \brief Implementation of the B2a::ShardDriver class
+
+#include "ShardDriver.hh"
+
+#include "Run.hh"
+#include "ShardMessenger.hh"
+
+#include "G4RunManager.hh"
+#include "G4SystemOfUnits.hh"
+#include "Randomize.hh"
+
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+
+namespace B2a
+{
+
+ShardDriver* ShardDriver::fgInstance = nullptr;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ShardDriver::ShardDriver(G4int index, G4int nofShards) : fIndex(index), fNbOfShards(nofShards)
+{
+  fgInstance = this;
+  fMessenger = new ShardMessenger(this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ShardDriver::~ShardDriver()
+{
+  delete fMessenger;
+  fgInstance = nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool ShardDriver::Parse(const G4String& value, G4int& index, G4int& nofShards)
+{
+  auto slash = value.find('/');
+  if (slash == std::string::npos) return false;
+  try {
+    index = std::stoi(value.substr(0, slash));
+    nofShards = std::stoi(value.substr(slash + 1));
+  }
+  catch (const std::exception&) {
+    return false;
+  }
+  return nofShards > 0 && index >= 0 && index < nofShards;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ShardDriver::BeamOn(G4int nofEvents)
+{
+  // contiguous ranges, the sizes of which differ by at most one event
+  auto first = G4int(std::int64_t(nofEvents) * fIndex / fNbOfShards);
+  auto last = G4int(std::int64_t(nofEvents) * (fIndex + 1) / fNbOfShards);
+
+  G4cout << G4endl << "---> Shard " << fIndex << "/" << fNbOfShards << ": events " << first
+         << " to " << last - 1 << " of " << nofEvents << G4endl;
+
+  fFirstEvent = first;
+  fNbOfLogicalEvents = nofEvents;
+  fSplitRun = true;
+  G4RunManager::GetRunManager()->BeamOn(last - first);
+  fFirstEvent = 0;
+  fSplitRun = false;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ShardDriver::SeedEvent(G4int runID, G4int eventID) const
+{
+  // with MixMax, the default engine, distinct seed triplets give
+  // independent streams
+  long seeds[3] = {long(fSeed), long(runID), long(eventID)};
+  G4Random::setTheSeeds(seeds, 3);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ShardDriver::WriteSummary(const Run* run, G4double wallTime, G4int nofThreads) const
+{
+  G4String fileName = fSummaryFileName + "_r" + std::to_string(run->GetRunID()) + GetFileTag()
+                      + ".txt";
+  std::ofstream file(fileName);
+  if (!file) {
+    G4ExceptionDescription msg;
+    msg << "Cannot open shard summary file " << fileName;
+    G4Exception("ShardDriver::WriteSummary()", "B2aShard001", JustWarning, msg);
+    return;
+  }
+
+  // sums only, at full precision: the summaries of the shards are added
+  // by mergeShards, and merged summaries can be merged again
+  G4int nofEvents = run->GetNumberOfEvent();
+  G4int logicalEvents = fSplitRun ? fNbOfLogicalEvents : nofEvents;
+  file << std::setprecision(std::numeric_limits<G4double>::max_digits10);
+  file << "# B2a shard summary (see mergeShards)\n"
+       << "version 1\n"
+       << "shard " << fIndex << ' ' << fNbOfShards << '\n'
+       << "run " << run->GetRunID() << '\n'
+       << "events " << fFirstEvent << ' ' << nofEvents << ' ' << logicalEvents << '\n'
+       << "threads " << nofThreads << '\n'
+       << "wall_s " << wallTime << '\n'
+       << "core_s " << wallTime * nofThreads << '\n'
+       << "hits " << run->GetNbOfHits() << ' ' << run->GetEdep() / MeV << '\n'
+       << "written_hits " << run->GetNbOfWrittenHits() << '\n'
+       << "accepted " << run->GetNbOfAcceptedEvents() << ' ' << run->GetNbOfAcceptedHits()
+       << '\n'
+       << "recorded " << run->GetNbOfRecordedParticles() << '\n'
+       << "biased " << run->IsBiased() << '\n';
+
+  const auto& stack = run->GetStackScore();
+  file << "score stack " << stack.sum / MeV << ' ' << stack.sum2 / (MeV * MeV) << '\n';
+  const auto& layers = run->GetLayerScores();
+  for (std::size_t i = 0; i < layers.size(); ++i) {
+    file << "score " << i << ' ' << layers[i].sum / MeV << ' ' << layers[i].sum2 / (MeV * MeV)
+         << '\n';
+  }
+
+  const auto& spectrum = run->GetHitSpectrum();
+  for (G4int i = 0; i < Run::kNbOfHitBins; ++i) {
+    file << "hit_bin " << Run::GetHitBinLowEdge(i) / MeV << ' ' << spectrum[i] << '\n';
+  }
+
+  // event times: the non-empty bins, at their (logarithmic) centre
+  const auto& times = run->GetEventTimes();
+  for (G4int i = 0; i < Run::kNbOfTimeBins; ++i) {
+    if (times[i] == 0) continue;
+    file << "event_time " << std::sqrt(Run::GetTimeBinLowEdge(i) * Run::GetTimeBinLowEdge(i + 1))
+         << ' ' << times[i] << '\n';
+  }
+  file << "max_event_time_s " << run->GetMaxEventTime() << '\n';
+
+  for (const auto& entry : run->GetRegionCounters()) {
+    const auto& counters = entry.second;
+    file << "region " << entry.first << ' ' << counters.steps << ' ' << counters.secondaries
+         << ' ' << counters.killed << '\n';
+  }
+  for (const auto& entry : run->GetTriggerCounters()) {
+    const auto& counters = entry.second;
+    file << "trigger " << entry.first << ' ' << counters.accepted << ' ' << counters.weight
+         << ' ' << counters.energy / keV << ' ' << counters.angle / deg << '\n';
+  }
+  const auto& filter = run->GetFilterCounters();
+  file << "filter " << filter.killedAtBirth << ' ' << filter.killedInFlight << ' '
+       << filter.deferred << ' ' << filter.dropped << ' ' << filter.abortedEvents << '\n';
+  const auto& cells = run->GetCellCounters();
+  for (std::size_t i = 0; i < cells.size(); ++i) {
+    file << "cell " << i << ' ' << cells[i].entries << ' ' << cells[i].weight << ' '
+         << cells[i].split << ' ' << cells[i].killed << '\n';
+  }
+
+  G4cout << " Shard summary: " << fileName << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}  // namespace B2a
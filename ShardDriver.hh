@@ -0,0 +1,107 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file ShardDriver.hh
+/// \brief Definition of the B2a::ShardDriver class
+
+#ifndef B2aShardDriver_h
+#define B2aShardDriver_h 1
+
+#include "globals.hh"
+
+namespace B2a
+{
+
+class Run;
+class ShardMessenger;
+
+/// Driver of one shard of a job split over processes (--shard i/N).
+///
+/// /B2/shard/beamOn n runs the share of shard i of a logical run of n
+/// events: the events [n i / N, n (i + 1) / N), which keep their global
+/// numbers (see GeneratorAction). Each event is seeded from the job seed,
+/// the run number and its global number only, so the events, and the
+/// merged results, do not depend on the number of shards or threads.
+///
+/// The outputs of the threads carry the shard number in their names
+/// (see RunAction), and at the end of each run the master writes the
+/// summary of the shard: counters, scores, spectra and timing, in a text
+/// file, <name>_r<run>_s<i>.txt. mergeShards combines the summaries and
+/// the hit files of all the shards of a run.
+///
+/// Master thread only, driven by ShardMessenger; the workers read the
+/// event range of the current run through GetInstance().
+
+class ShardDriver
+{
+  public:
+    ShardDriver(G4int index, G4int nofShards);
+    ~ShardDriver();
+
+    // "i/N", with 0 <= i < N; false if malformed
+    static G4bool Parse(const G4String& value, G4int& index, G4int& nofShards);
+
+    // nullptr if the job is not sharded
+    static const ShardDriver* GetInstance() { return fgInstance; }
+
+    void SetSeed(G4long seed) { fSeed = seed; }
+    G4long GetSeed() const { return fSeed; }
+    void SetSummaryFileName(const G4String& name) { fSummaryFileName = name; }
+
+    void BeamOn(G4int nofEvents);
+
+    G4int GetIndex() const { return fIndex; }
+    G4int GetNbOfShards() const { return fNbOfShards; }
+    G4String GetFileTag() const { return "_s" + std::to_string(fIndex); }
+
+    // Global number of the first event of the current run; 0 for a run
+    // started with /run/beamOn, which is not split
+    G4int GetFirstEvent() const { return fFirstEvent; }
+    G4bool IsSplitRun() const { return fSplitRun; }
+
+    // Seed the engine of the calling thread for an event
+    void SeedEvent(G4int runID, G4int eventID) const;
+
+    void WriteSummary(const Run*, G4double wallTime, G4int nofThreads) const;
+
+  private:
+    static ShardDriver* fgInstance;
+
+    G4int fIndex = 0;
+    G4int fNbOfShards = 1;
+    G4long fSeed = 12345;
+    G4String fSummaryFileName = "shard";
+
+    G4int fFirstEvent = 0;
+    G4int fNbOfLogicalEvents = 0;
+    G4bool fSplitRun = false;
+
+    ShardMessenger* fMessenger = nullptr;
+};
+
+}  // namespace B2a
+
+#endif
@@ -0,0 +1,99 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file ShardMessenger.cc
+/// \brief Implementation of the B2a::ShardMessenger class
+
+#include "ShardMessenger.hh"
+
+#include "ShardDriver.hh"
+
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIdirectory.hh"
+
+namespace B2a
+{
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ShardMessenger::ShardMessenger(ShardDriver* shard) : fShardDriver(shard)
+{
+  fDirectory = new G4UIdirectory("/B2/shard/");
+  fDirectory->SetGuidance("One shard of a job split over processes (--shard i/N).");
+
+  fSeedCmd = new G4UIcmdWithAnInteger("/B2/shard/seed", this);
+  fSeedCmd->SetGuidance("Seed of the job, the same in all the shards: each event is");
+  fSeedCmd->SetGuidance("seeded from it, the run number and the event number.");
+  fSeedCmd->SetParameterName("seed", false);
+  fSeedCmd->SetRange("seed>0");
+  fSeedCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fSeedCmd->SetToBeBroadcasted(false);
+
+  fSummaryCmd = new G4UIcmdWithAString("/B2/shard/summaryFile", this);
+  fSummaryCmd->SetGuidance("Base name of the summary files, <name>_r<run>_s<shard>.txt.");
+  fSummaryCmd->SetParameterName("name", false);
+  fSummaryCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fSummaryCmd->SetToBeBroadcasted(false);
+
+  fBeamOnCmd = new G4UIcmdWithAnInteger("/B2/shard/beamOn", this);
+  fBeamOnCmd->SetGuidance("Run the share of this shard of a run of nofEvents events.");
+  fBeamOnCmd->SetParameterName("nofEvents", false);
+  fBeamOnCmd->SetRange("nofEvents>0");
+  fBeamOnCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fBeamOnCmd->SetToBeBroadcasted(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ShardMessenger::~ShardMessenger()
+{
+  delete fSeedCmd;
+  delete fSummaryCmd;
+  delete fBeamOnCmd;
+  delete fDirectory;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ShardMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+  if (command == fSeedCmd) {
+    fShardDriver->SetSeed(fSeedCmd->GetNewIntValue(newValue));
+  }
+
+  if (command == fSummaryCmd) {
+    fShardDriver->SetSummaryFileName(newValue);
+  }
+
+  if (command == fBeamOnCmd) {
+    fShardDriver->BeamOn(fBeamOnCmd->GetNewIntValue(newValue));
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}  // namespace B2a
@@ -0,0 +1,241 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file SourceMessenger.cc
+/// \brief Implementation of the B2a::SourceMessenger class
+
+#include "SourceMessenger.hh"
+
+#include "GeneratorAction.hh"
+#include "PhaseSpaceReader.hh"
+
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithADouble.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIdirectory.hh"
+#include "G4UIparameter.hh"
+
+#include <sstream>
+
+#ifndef _WIN32
+#  include <glob.h>
+#endif
+
+namespace B2a
+{
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SourceMessenger::SourceMessenger(PhaseSpaceReader* phaseSpace, SourceParameters* source)
+  : fPhaseSpace(phaseSpace), fSource(source)
+{
+  fDirectory = new G4UIdirectory("/B2/source/");
+  fDirectory->SetGuidance("Primary source control");
+
+  fReplayCmd = new G4UIcmdWithAString("/B2/source/replay", this);
+  fReplayCmd->SetGuidance("Replay phase-space files instead of shooting the beam.");
+  fReplayCmd->SetGuidance("The files (see /B2/output/phaseSpaceFile) are given");
+  fReplayCmd->SetGuidance("separated by spaces, wildcards allowed; none goes back");
+  fReplayCmd->SetGuidance("to the beam.");
+  fReplayCmd->SetParameterName("files", false);
+  fReplayCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fReplayCmd->SetToBeBroadcasted(false);
+
+  fRecycleCmd = new G4UIcmdWithABool("/B2/source/recycle", this);
+  fRecycleCmd->SetGuidance("Replay the recorded events again once all were used.");
+  fRecycleCmd->SetParameterName("recycle", true);
+  fRecycleCmd->SetDefaultValue(true);
+  fRecycleCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fRecycleCmd->SetToBeBroadcasted(false);
+
+  fRotateCmd = new G4UIcmdWithABool("/B2/source/rotate", this);
+  fRotateCmd->SetGuidance("Rotate each reuse of a recorded event by a random angle");
+  fRotateCmd->SetGuidance("around the beam axis.");
+  fRotateCmd->SetParameterName("rotate", true);
+  fRotateCmd->SetDefaultValue(true);
+  fRotateCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fRotateCmd->SetToBeBroadcasted(false);
+
+  fConeCmd = new G4UIcmdWithADoubleAndUnit("/B2/source/setCone", this);
+  fConeCmd->SetGuidance("Spread the beam uniformly in solid angle within a cone");
+  fConeCmd->SetGuidance("around +z; 0 for the direction of the gun.");
+  fConeCmd->SetParameterName("angle", false);
+  fConeCmd->SetUnitCategory("Angle");
+  fConeCmd->SetDefaultUnit("deg");
+  fConeCmd->SetRange("angle>=0. && angle<=90.");
+  fConeCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fConeCmd->SetToBeBroadcasted(false);
+
+  fSpectrumCmd = new G4UIcommand("/B2/source/setSpectrum", this);
+  fSpectrumCmd->SetGuidance("Sample the beam energy from dN/dE ~ E^-slope between");
+  fSpectrumCmd->SetGuidance("the two energies; a minimum energy of 0 for the energy");
+  fSpectrumCmd->SetGuidance("of the gun.");
+  auto slopePrm = new G4UIparameter("slope", 'd', false);
+  fSpectrumCmd->SetParameter(slopePrm);
+  auto minEnergyPrm = new G4UIparameter("minEnergy", 'd', false);
+  minEnergyPrm->SetParameterRange("minEnergy>=0.");
+  fSpectrumCmd->SetParameter(minEnergyPrm);
+  auto maxEnergyPrm = new G4UIparameter("maxEnergy", 'd', false);
+  maxEnergyPrm->SetParameterRange("maxEnergy>=0.");
+  fSpectrumCmd->SetParameter(maxEnergyPrm);
+  auto unitPrm = new G4UIparameter("unit", 's', true);
+  unitPrm->SetDefaultUnit("MeV");
+  fSpectrumCmd->SetParameter(unitPrm);
+  fSpectrumCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fSpectrumCmd->SetToBeBroadcasted(false);
+
+  fBiasDirectory = new G4UIdirectory("/B2/source/bias/");
+  fBiasDirectory->SetGuidance("Biased sampling of the source, the primaries are weighted");
+
+  fBiasCmd = new G4UIcmdWithABool("/B2/source/bias/enable", this);
+  fBiasCmd->SetGuidance("Sample the source from the biased density; each primary");
+  fBiasCmd->SetGuidance("carries the ratio of the physical to the biased density.");
+  fBiasCmd->SetParameterName("enable", true);
+  fBiasCmd->SetDefaultValue(true);
+  fBiasCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fBiasCmd->SetToBeBroadcasted(false);
+
+  fBiasConeCmd = new G4UIcmdWithADoubleAndUnit("/B2/source/bias/cone", this);
+  fBiasConeCmd->SetGuidance("Set the half angle of the preferred cone around +z;");
+  fBiasConeCmd->SetGuidance("0 for the acceptance of the first layer.");
+  fBiasConeCmd->SetParameterName("angle", false);
+  fBiasConeCmd->SetUnitCategory("Angle");
+  fBiasConeCmd->SetDefaultUnit("deg");
+  fBiasConeCmd->SetRange("angle>=0. && angle<=90.");
+  fBiasConeCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fBiasConeCmd->SetToBeBroadcasted(false);
+
+  fBiasConeFractionCmd = new G4UIcmdWithADouble("/B2/source/bias/coneFraction", this);
+  fBiasConeFractionCmd->SetGuidance("Set the fraction of the primaries shot in the preferred");
+  fBiasConeFractionCmd->SetGuidance("cone, the others are shot in the whole source cone.");
+  fBiasConeFractionCmd->SetParameterName("fraction", false);
+  fBiasConeFractionCmd->SetRange("fraction>=0. && fraction<1.");
+  fBiasConeFractionCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fBiasConeFractionCmd->SetToBeBroadcasted(false);
+
+  fBiasSlopeCmd = new G4UIcmdWithADouble("/B2/source/bias/spectrumSlope", this);
+  fBiasSlopeCmd->SetGuidance("Set the slope of the biased power law spectrum, harder");
+  fBiasSlopeCmd->SetGuidance("than the physical one to favour the high energies.");
+  fBiasSlopeCmd->SetParameterName("slope", false);
+  fBiasSlopeCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fBiasSlopeCmd->SetToBeBroadcasted(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SourceMessenger::~SourceMessenger()
+{
+  delete fReplayCmd;
+  delete fRecycleCmd;
+  delete fRotateCmd;
+  delete fConeCmd;
+  delete fSpectrumCmd;
+  delete fBiasCmd;
+  delete fBiasConeCmd;
+  delete fBiasConeFractionCmd;
+  delete fBiasSlopeCmd;
+  delete fBiasDirectory;
+  delete fDirectory;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SourceMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+  if (command == fReplayCmd) {
+    if (newValue == "none") {
+      fPhaseSpace->Close();
+      return;
+    }
+    std::vector<G4String> fileNames;
+    std::istringstream is(newValue);
+    G4String fileName;
+    while (is >> fileName) {
+#ifndef _WIN32
+      // e.g. target_r0_t*.phsp: the files of all the threads of a run
+      glob_t matches;
+      if (glob(fileName.c_str(), 0, nullptr, &matches) == 0) {
+        for (std::size_t i = 0; i < matches.gl_pathc; ++i) {
+          fileNames.emplace_back(matches.gl_pathv[i]);
+        }
+        globfree(&matches);
+        continue;
+      }
+      globfree(&matches);
+#endif
+      fileNames.push_back(fileName);
+    }
+    fPhaseSpace->Open(fileNames);
+  }
+
+  if (command == fRecycleCmd) {
+    fPhaseSpace->SetRecycling(fRecycleCmd->GetNewBoolValue(newValue));
+  }
+
+  if (command == fRotateCmd) {
+    fPhaseSpace->SetRotation(fRotateCmd->GetNewBoolValue(newValue));
+  }
+
+  if (command == fConeCmd) {
+    fSource->coneAngle = fConeCmd->GetNewDoubleValue(newValue);
+  }
+
+  if (command == fSpectrumCmd) {
+    G4double slope = 0., minEnergy = 0., maxEnergy = 0.;
+    G4String unit;
+    std::istringstream is(newValue);
+    is >> slope >> minEnergy >> maxEnergy >> unit;
+    if (minEnergy > 0. && maxEnergy <= minEnergy) {
+      G4cout << "-->  WARNING from SourceMessenger : empty energy range, "
+             << "the command is ignored" << G4endl;
+      return;
+    }
+    fSource->spectrumSlope = slope;
+    fSource->minEnergy = minEnergy * G4UIcommand::ValueOf(unit);
+    fSource->maxEnergy = maxEnergy * G4UIcommand::ValueOf(unit);
+  }
+
+  if (command == fBiasCmd) {
+    fSource->biased = fBiasCmd->GetNewBoolValue(newValue);
+  }
+
+  if (command == fBiasConeCmd) {
+    fSource->biasConeAngle = fBiasConeCmd->GetNewDoubleValue(newValue);
+  }
+
+  if (command == fBiasConeFractionCmd) {
+    fSource->biasConeFraction = fBiasConeFractionCmd->GetNewDoubleValue(newValue);
+  }
+
+  if (command == fBiasSlopeCmd) {
+    fSource->biasSpectrumSlope = fBiasSlopeCmd->GetNewDoubleValue(newValue);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}  // namespace B2a
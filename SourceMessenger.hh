@@ -0,0 +1,92 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file SourceMessenger.hh
+/// \brief Definition of the B2a::SourceMessenger class
+
+#ifndef B2aSourceMessenger_h
+#define B2aSourceMessenger_h 1
+
+#include "G4UImessenger.hh"
+
+class G4UIdirectory;
+class G4UIcommand;
+class G4UIcmdWithABool;
+class G4UIcmdWithADouble;
+class G4UIcmdWithADoubleAndUnit;
+class G4UIcmdWithAString;
+
+namespace B2a
+{
+
+class PhaseSpaceReader;
+struct SourceParameters;
+
+/// Messenger class that defines commands for the primary source.
+///
+/// It implements commands:
+/// - /B2/source/replay file... | none
+/// - /B2/source/recycle true|false
+/// - /B2/source/rotate true|false
+/// - /B2/source/setCone angle unit
+/// - /B2/source/setSpectrum slope minEnergy maxEnergy unit
+/// - /B2/source/bias/enable true|false
+/// - /B2/source/bias/cone angle unit
+/// - /B2/source/bias/coneFraction fraction
+/// - /B2/source/bias/spectrumSlope slope
+///
+/// The phase space and the source parameters are shared by the generators
+/// of all threads: the commands are executed on the master only.
+
+class SourceMessenger : public G4UImessenger
+{
+  public:
+    SourceMessenger(PhaseSpaceReader*, SourceParameters*);
+    ~SourceMessenger() override;
+
+    void SetNewValue(G4UIcommand*, G4String) override;
+
+  private:
+    PhaseSpaceReader* fPhaseSpace = nullptr;
+    SourceParameters* fSource = nullptr;
+
+    G4UIdirectory* fDirectory = nullptr;
+    G4UIdirectory* fBiasDirectory = nullptr;
+
+    G4UIcmdWithAString* fReplayCmd = nullptr;
+    G4UIcmdWithABool* fRecycleCmd = nullptr;
+    G4UIcmdWithABool* fRotateCmd = nullptr;
+    G4UIcmdWithADoubleAndUnit* fConeCmd = nullptr;
+    G4UIcommand* fSpectrumCmd = nullptr;
+    G4UIcmdWithABool* fBiasCmd = nullptr;
+    G4UIcmdWithADoubleAndUnit* fBiasConeCmd = nullptr;
+    G4UIcmdWithADouble* fBiasConeFractionCmd = nullptr;
+    G4UIcmdWithADouble* fBiasSlopeCmd = nullptr;
+};
+
+}  // namespace B2a
+
+#endif
@@ -0,0 +1,116 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file StackingAction.cc
+/// \brief Implementation of the B2a::StackingAction class
+
+#include "StackingAction.hh"
+
+#include "AcceptanceFilter.hh"
+#include "Run.hh"
+#include "SubEventDriver.hh"
+
+#include "G4RunManager.hh"
+#include "G4StackManager.hh"
+#include "G4Track.hh"
+
+namespace B2a
+{
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+StackingAction::StackingAction()
+{
+  fFilter = new AcceptanceFilter;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+StackingAction::~StackingAction()
+{
+  delete fFilter;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4ClassificationOfNewTrack StackingAction::ClassifyNewTrack(const G4Track* track)
+{
+  // in sub-event mode the tracks to process go to the sub-events or not
+  auto subEvent = SubEventDriver::GetInstance();
+  auto process = subEvent ? subEvent->Classify(track) : fUrgent;
+
+  if (!fFilter->IsEnabled()) return process;
+
+  auto verdict = fFilter->Classify(track->GetParticleDefinition(), track->GetKineticEnergy(),
+                                   track->GetPosition(), track->GetMomentumDirection(),
+                                   track->GetTouchableHandle());
+  if (verdict == AcceptanceFilter::kReach) return process;
+
+  auto run = static_cast<Run*>(G4RunManager::GetRunManager()->GetNonConstCurrentRun());
+  auto& counters = run->GetFilterCounters();
+  if (verdict == AcceptanceFilter::kNever) {
+    ++counters.killedAtBirth;
+    return fKill;
+  }
+
+  // only defer once: the tracks are classified again at the next stage
+  if (fStage > 0) return process;
+  ++counters.deferred;
+  return fWaiting;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StackingAction::NewStage()
+{
+  ++fStage;
+
+  // the stack manager has already moved the waiting tracks to the
+  // urgent stack when it calls NewStage()
+  if (stackManager->GetNUrgentTrack() == 0) return;
+
+  if (fFilter->IsAbortingEvents()) {
+    auto run = static_cast<Run*>(G4RunManager::GetRunManager()->GetNonConstCurrentRun());
+    auto& counters = run->GetFilterCounters();
+    counters.dropped += stackManager->GetNUrgentTrack();
+    ++counters.abortedEvents;
+    stackManager->clear();
+    return;
+  }
+
+  stackManager->ReClassify();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StackingAction::PrepareNewEvent()
+{
+  fStage = 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}  // namespace B2a
@@ -0,0 +1,74 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file StackingAction.hh
+/// \brief Definition of the B2a::StackingAction class
+
+#ifndef B2aStackingAction_h
+#define B2aStackingAction_h 1
+
+#include "G4UserStackingAction.hh"
+
+namespace B2a
+{
+
+class AcceptanceFilter;
+
+/// Stacking action class
+///
+/// When the AcceptanceFilter is enabled, the new tracks which can never
+/// reach a layer are killed, and those which may only reach one after
+/// scattering are deferred to a second stage, once the other tracks of
+/// the event have been processed. At that stage they are tracked as
+/// usual or, with /B2/filter/abortEvents, dropped, which ends the event.
+///
+/// The counts are added to the Run of this thread (see RunAction). The
+/// action owns the filter of its thread, also used by the SteppingAction.
+///
+/// In sub-event mode the tracks to process are classified by the
+/// SubEventDriver: the energetic secondaries of the master go to the
+/// sub-events.
+
+class StackingAction : public G4UserStackingAction
+{
+  public:
+    StackingAction();
+    ~StackingAction() override;
+
+    G4ClassificationOfNewTrack ClassifyNewTrack(const G4Track*) override;
+    void NewStage() override;
+    void PrepareNewEvent() override;
+
+    const AcceptanceFilter* GetFilter() const { return fFilter; }
+
+  private:
+    AcceptanceFilter* fFilter = nullptr;
+    G4int fStage = 0;
+};
+
+}  // namespace B2a
+
+#endif
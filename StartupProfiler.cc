@@ -0,0 +1,129 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file StartupProfiler.cc
+/// \brief Implementation of the B2a::StartupProfiler class
+
+#include "StartupProfiler.hh"
+
+#include "MemoryMonitor.hh"
+
+#include "G4AutoLock.hh"
+#include "G4StateManager.hh"
+
+#include <algorithm>
+#include <iomanip>
+
+namespace B2a
+{
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+StartupProfiler* StartupProfiler::Instance()
+{
+  // deleted by the G4StateManager it registered to
+  static auto instance = new StartupProfiler;
+  return instance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+StartupProfiler::StartupProfiler() : fJobStart(Clock::now()), fPhaseStart(fJobStart) {}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double StartupProfiler::Elapsed() const
+{
+  std::chrono::duration<G4double> elapsed = Clock::now() - fJobStart;
+  return elapsed.count();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool StartupProfiler::Notify(G4ApplicationState requestedState)
+{
+  // Only the master state manager notifies this object
+  auto currentState = G4StateManager::GetStateManager()->GetCurrentState();
+
+  if (requestedState == G4State_Init && fNofInitialisations < 2) {
+    fPhaseStart = Clock::now();
+  }
+  else if (currentState == G4State_Init && requestedState == G4State_Idle
+           && fNofInitialisations < 2)
+  {
+    std::chrono::duration<G4double> elapsed = Clock::now() - fPhaseStart;
+    G4String phase = (fNofInitialisations == 0) ? "initialisation" : "physics tables";
+    Record(phase, elapsed.count());
+    MemoryMonitor::RecordSharedPhase(phase);
+    ++fNofInitialisations;
+  }
+
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StartupProfiler::Record(const G4String& phase, G4double seconds)
+{
+  G4AutoLock lock(&fMutex);
+
+  auto entry = std::find_if(fPhases.begin(), fPhases.end(),
+                            [&phase](const auto& item) { return item.first == phase; });
+  if (entry == fPhases.end()) {
+    fPhases.emplace_back(phase, seconds);
+  }
+  else {
+    entry->second = std::max(entry->second, seconds);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StartupProfiler::Print()
+{
+  G4AutoLock lock(&fMutex);
+
+  if (fPrinted) return;
+  fPrinted = true;
+
+  G4cout << G4endl << " Start-up phases (wall clock, s)" << G4endl;
+  for (const auto& phase : fPhases) {
+    G4cout << "  " << std::setw(20) << std::left << phase.first << std::right
+           << std::setw(10) << phase.second << G4endl;
+  }
+  G4cout << "  " << std::setw(20) << std::left << "total" << std::right << std::setw(10)
+         << Elapsed() << G4endl;
+
+  for (const auto& phase : fPhases) {
+    G4String name = phase.first;
+    std::replace(name.begin(), name.end(), ' ', '_');
+    G4cout << "B2a-startup phase=" << name << " s=" << phase.second << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}  // namespace B2a
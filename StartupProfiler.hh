@@ -0,0 +1,102 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file StartupProfiler.hh
+/// \brief Definition of the B2a::StartupProfiler class
+
+#ifndef B2aStartupProfiler_h
+#define B2aStartupProfiler_h 1
+
+#include "G4Threading.hh"
+#include "G4VStateDependent.hh"
+#include "globals.hh"
+
+#include <chrono>
+#include <utility>
+#include <vector>
+
+namespace B2a
+{
+
+/// Wall-clock breakdown of the job start-up.
+///
+/// The phases are recorded either explicitly, with Record() or a Scope,
+/// or from the state transitions of the master application:
+/// - "initialisation": /run/initialize (PreInit -> Init -> Idle)
+/// - "physics tables": the first run initialisation (Idle -> Init -> Idle)
+/// Phases recorded by several threads (e.g. "SD and field") keep the
+/// slowest one. The table is printed once, at the end of the first run,
+/// followed by "B2a-startup" lines meant to be parsed by scripts.
+///
+/// The instance must first be created on the master thread; it is then
+/// owned, and deleted, by the master G4StateManager.
+
+class StartupProfiler : public G4VStateDependent
+{
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    static StartupProfiler* Instance();
+
+    G4bool Notify(G4ApplicationState requestedState) override;
+
+    void Record(const G4String& phase, G4double seconds);
+    void Print();
+
+    G4double Elapsed() const;  // since the start of the job
+
+    /// Records the lifetime of the scope as a phase
+    class Scope
+    {
+      public:
+        Scope(const G4String& phase) : fPhase(phase), fStart(Clock::now()) {}
+        ~Scope()
+        {
+          std::chrono::duration<G4double> elapsed = Clock::now() - fStart;
+          StartupProfiler::Instance()->Record(fPhase, elapsed.count());
+        }
+
+      private:
+        G4String fPhase;
+        Clock::time_point fStart;
+    };
+
+  private:
+    StartupProfiler();
+    ~StartupProfiler() override = default;
+
+    Clock::time_point fJobStart;
+    Clock::time_point fPhaseStart;
+    G4int fNofInitialisations = 0;
+    G4bool fPrinted = false;
+
+    std::vector<std::pair<G4String, G4double>> fPhases;
+    G4Mutex fMutex = G4MUTEX_INITIALIZER;
+};
+
+}  // namespace B2a
+
+#endif
@@ -0,0 +1,106 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file StateIO.hh
+/// \brief Definition of the B2a::StateIO functions
+
+#ifndef B2aStateIO_h
+#define B2aStateIO_h 1
+
+#include "globals.hh"
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace B2a
+{
+
+/// Binary state of the accumulators, as saved in the checkpoints (see
+/// CheckpointManager): plain values in the byte order of the host,
+/// strings and arrays preceded by their size. A checkpoint is resumed on
+/// the platform which wrote it.
+
+namespace StateIO
+{
+
+template <typename T>
+void Write(std::ostream& os, const T& value)
+{
+  static_assert(std::is_trivially_copyable<T>::value, "plain values only");
+  os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+G4bool Read(std::istream& is, T& value)
+{
+  static_assert(std::is_trivially_copyable<T>::value, "plain values only");
+  is.read(reinterpret_cast<char*>(&value), sizeof(T));
+  return bool(is);
+}
+
+inline void WriteString(std::ostream& os, const std::string& value)
+{
+  Write(os, std::uint64_t(value.size()));
+  os.write(value.data(), value.size());
+}
+
+inline G4bool ReadString(std::istream& is, std::string& value)
+{
+  std::uint64_t size = 0;
+  if (!Read(is, size)) return false;
+  value.resize(size);
+  is.read(&value[0], size);
+  return bool(is);
+}
+
+template <typename T>
+void WriteVector(std::ostream& os, const std::vector<T>& values)
+{
+  static_assert(std::is_trivially_copyable<T>::value, "plain values only");
+  Write(os, std::uint64_t(values.size()));
+  os.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+}
+
+template <typename T>
+G4bool ReadVector(std::istream& is, std::vector<T>& values)
+{
+  static_assert(std::is_trivially_copyable<T>::value, "plain values only");
+  std::uint64_t size = 0;
+  if (!Read(is, size)) return false;
+  values.resize(size);
+  is.read(reinterpret_cast<char*>(values.data()), size * sizeof(T));
+  return bool(is);
+}
+
+}  // namespace StateIO
+
+}  // namespace B2a
+
+#endif
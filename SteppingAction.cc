@@ -0,0 +1,199 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file SteppingAction.cc
+/// \brief Implementation of the B2a::SteppingAction class
+
+#include "SteppingAction.hh"
+
+#include "G4Event.hh"
+#include "G4LogicalVolume.hh"
+#include "G4Region.hh"
+#include "G4RunManager.hh"
+#include "G4Step.hh"
+#include "G4SteppingManager.hh"
+#include "G4Track.hh"
+#include "G4TransportationProcessType.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4VProcess.hh"
+
+namespace B2a
+{
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SteppingAction::UpdateRun()
+{
+  auto run = static_cast<Run*>(G4RunManager::GetRunManager()->GetNonConstCurrentRun());
+  if (run != fRun) {
+    fRun = run;
+    fRegion = nullptr;
+    fProfileCounters = nullptr;
+    fPhaseSpace = run->GetPhaseSpaceWriter();
+    if (fPhaseSpace && !fPhaseSpace->IsOpen()) fPhaseSpace = nullptr;
+    fVoxels = run->GetVoxelScorer();
+    run->SetImportanceSampling(fImportance.Update() ? fImportance.GetNbOfCells() : 0);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SteppingAction::BeginOfTrack(const G4Track* track)
+{
+  UpdateRun();
+  if (!fRun->IsProfiling()) return;
+
+  // a track starting outside the world has no volume (and no steps)
+  if (auto volume = track->GetVolume()) {
+    Run::ProfileKey key{volume->GetLogicalVolume(), track->GetParticleDefinition(),
+                        track->GetCreatorProcess()};
+    ++fRun->GetProfileCounters(key).tracks;
+  }
+
+  fLastTime = Clock::now();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SteppingAction::UserSteppingAction(const G4Step* step)
+{
+  UpdateRun();
+
+  auto preStepPoint = step->GetPreStepPoint();
+  auto region = preStepPoint->GetPhysicalVolume()->GetLogicalVolume()->GetRegion();
+  if (region != fRegion) {
+    fRegion = region;
+    fRegionCounters = &fRun->GetRegionCounters(region->GetName());
+  }
+
+  ++fRegionCounters->steps;
+  fRegionCounters->secondaries += step->GetNumberOfSecondariesInCurrentStep();
+
+  auto process = step->GetPostStepPoint()->GetProcessDefinedStep();
+  if (process && process->GetProcessSubType() == USER_SPECIAL_CUTS) {
+    ++fRegionCounters->killed;
+  }
+
+  if (fFilter && fFilter->IsEnabled()) ApplyFilter(step);
+
+  if (fPhaseSpace) RecordPhaseSpace(step);
+
+  if (fVoxels) fVoxels->Fill(step);
+
+  if (fImportance.IsEnabled()) {
+    fImportance.Apply(step, fpSteppingManager->GetfSecondary(), fRun);
+  }
+
+  if (!fRun->IsProfiling()) return;
+
+  // consecutive steps mostly share their key: look it up only on change
+  Run::ProfileKey key{preStepPoint->GetPhysicalVolume()->GetLogicalVolume(),
+                      step->GetTrack()->GetParticleDefinition(), process};
+  if (!fProfileCounters || !(key == fProfileKey)) {
+    fProfileKey = key;
+    fProfileCounters = &fRun->GetProfileCounters(key);
+  }
+
+  auto now = Clock::now();
+  std::chrono::duration<G4double> elapsed = now - fLastTime;
+  fLastTime = now;
+
+  ++fProfileCounters->steps;
+  fProfileCounters->edep += step->GetTotalEnergyDeposit();
+  fProfileCounters->time += elapsed.count();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SteppingAction::ApplyFilter(const G4Step* step)
+{
+  auto postStepPoint = step->GetPostStepPoint();
+  if (postStepPoint->GetStepStatus() != fGeomBoundary) return;
+
+  auto track = step->GetTrack();
+  if (track->GetTrackStatus() != fAlive || !track->GetNextVolume()) return;
+
+  auto verdict = fFilter->Classify(track->GetParticleDefinition(),
+                                   postStepPoint->GetKineticEnergy(), postStepPoint->GetPosition(),
+                                   postStepPoint->GetMomentumDirection(),
+                                   postStepPoint->GetTouchableHandle());
+  if (verdict != AcceptanceFilter::kNever) return;
+
+  track->SetTrackStatus(fStopAndKill);
+  ++fRun->GetFilterCounters().killedInFlight;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SteppingAction::RecordPhaseSpace(const G4Step* step)
+{
+  auto preStepPoint = step->GetPreStepPoint();
+  auto postStepPoint = step->GetPostStepPoint();
+  G4double planeZ = fPhaseSpace->GetPlaneZ();
+  G4double z0 = preStepPoint->GetPosition().z();
+  G4double z1 = postStepPoint->GetPosition().z();
+  if (!(z0 < planeZ && z1 >= planeZ)) return;
+
+  auto track = step->GetTrack();
+  G4int eventID = G4RunManager::GetRunManager()->GetCurrentEvent()->GetEventID();
+  G4bool kill = !fRun->KeepsRecorded();
+
+  // state on the plane: straight line between the step points, and the
+  // energy and direction of the pre-step point (the plane is in air)
+  G4double f = (planeZ - z0) / (z1 - z0);
+  auto position = preStepPoint->GetPosition()
+                  + f * (postStepPoint->GetPosition() - preStepPoint->GetPosition());
+  G4double time = preStepPoint->GetGlobalTime()
+                  + f * (postStepPoint->GetGlobalTime() - preStepPoint->GetGlobalTime());
+  if (fPhaseSpace->Fill(eventID, track->GetParticleDefinition()->GetPDGEncoding(),
+                        preStepPoint->GetKineticEnergy(), position,
+                        preStepPoint->GetMomentumDirection(), time, track->GetWeight()))
+  {
+    fRun->AddRecordedParticle();
+  }
+  if (kill) track->SetTrackStatus(fStopAndKill);
+
+  // secondaries of this step created beyond the plane; a track killed
+  // before it is tracked makes no step
+  auto secondaries = step->GetSecondary();
+  std::size_t first = secondaries->size() - step->GetNumberOfSecondariesInCurrentStep();
+  for (auto i = first; i < secondaries->size(); ++i) {
+    auto secondary = (*secondaries)[i];
+    if (secondary->GetPosition().z() < planeZ) continue;
+    if (fPhaseSpace->Fill(eventID, secondary->GetParticleDefinition()->GetPDGEncoding(),
+                          secondary->GetKineticEnergy(), secondary->GetPosition(),
+                          secondary->GetMomentumDirection(), secondary->GetGlobalTime(),
+                          secondary->GetWeight()))
+    {
+      fRun->AddRecordedParticle();
+    }
+    if (kill) secondary->SetTrackStatus(fStopAndKill);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}  // namespace B2a
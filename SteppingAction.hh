@@ -0,0 +1,113 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file SteppingAction.hh
+/// \brief Definition of the B2a::SteppingAction class
+
+#ifndef B2aSteppingAction_h
+#define B2aSteppingAction_h 1
+
+#include "AcceptanceFilter.hh"
+#include "ImportanceSampler.hh"
+#include "PhaseSpaceWriter.hh"
+#include "Run.hh"
+#include "VoxelScorer.hh"
+
+#include "G4UserSteppingAction.hh"
+
+#include <chrono>
+
+class G4Region;
+class G4Track;
+
+namespace B2a
+{
+
+/// Stepping action class
+///
+/// Counts the steps, the secondaries and the tracks killed by the user
+/// limits in each region, in the Run of this thread. The counters of the
+/// current region are cached, so that a step costs a pointer comparison
+/// as long as the track stays in the same region.
+///
+/// When the run is profiling (/B2/output/profile), the steps, energy
+/// deposit and wall clock time are also added per volume, particle and
+/// step limiting process, and the tracks per start volume, particle and
+/// creator process. The time of a step is the time since the previous
+/// step of the track, or since its start (see TrackingAction).
+///
+/// When the acceptance filter is enabled, a track entering a volume from
+/// which it can never reach a layer is killed (see StackingAction for the
+/// new tracks).
+///
+/// When the phase space is recorded (/B2/output/phaseSpaceFile), the
+/// particles crossing the plane just downstream of the target, towards
+/// the stack, are written with their state on the plane, then killed
+/// (unless kept). So are the secondaries of the crossing step created
+/// beyond the plane, which will never cross it.
+///
+/// When the layers have importances (/B2/det/importance/), the tracks
+/// crossing into a cell of another importance are split or played Russian
+/// roulette (see ImportanceSampler); the population of each cell is
+/// counted in the Run.
+///
+/// With /B2/voxel/ the deposits in the scored volumes go to the voxels
+/// of the thread (see VoxelScorer).
+
+class SteppingAction : public G4UserSteppingAction
+{
+  public:
+    SteppingAction(const AcceptanceFilter* filter = nullptr) : fFilter(filter) {}
+    ~SteppingAction() override = default;
+
+    void UserSteppingAction(const G4Step*) override;
+
+    void BeginOfTrack(const G4Track*);
+
+  private:
+    using Clock = std::chrono::steady_clock;
+
+    void UpdateRun();
+    void ApplyFilter(const G4Step*);
+    void RecordPhaseSpace(const G4Step*);
+
+    const AcceptanceFilter* fFilter = nullptr;
+
+    Run* fRun = nullptr;
+    PhaseSpaceWriter* fPhaseSpace = nullptr;  // nullptr: no recording
+    VoxelScorer* fVoxels = nullptr;  // nullptr: no voxel scoring
+    ImportanceSampler fImportance;
+    const G4Region* fRegion = nullptr;
+    Run::RegionCounters* fRegionCounters = nullptr;
+
+    Clock::time_point fLastTime;
+    Run::ProfileKey fProfileKey{nullptr, nullptr, nullptr};
+    Run::ProfileCounters* fProfileCounters = nullptr;
+};
+
+}  // namespace B2a
+
+#endif
@@ -0,0 +1,201 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file SubEventDriver.cc
+/// \brief Implementation of the B2a::SubEventDriver class
+
+#include "SubEventDriver.hh"
+
+#include "EventAction.hh"
+#include "SubEventMessenger.hh"
+
+#include "G4AutoLock.hh"
+#include "G4Event.hh"
+#include "G4EventManager.hh"
+#include "G4HCofThisEvent.hh"
+#include "G4RunManager.hh"
+#include "G4SDManager.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4Track.hh"
+
+#ifdef B2A_SUBEVENT_PARALLEL
+#  include "G4SubEvtRunManager.hh"
+#endif
+
+#include <algorithm>
+#include <tuple>
+
+namespace
+{
+// The collections of the tracker (see TrackerSD), nullptr if absent
+template<typename Collection>
+Collection* GetCollection(const G4Event* event, const G4String& name)
+{
+  auto hce = event->GetHCofThisEvent();
+  G4int id = G4SDManager::GetSDMpointer()->GetCollectionID(name);
+  if (!hce || id < 0) return nullptr;
+  return static_cast<Collection*>(hce->GetHC(id));
+}
+}  // namespace
+
+namespace B2a
+{
+
+SubEventDriver* SubEventDriver::fgInstance = nullptr;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SubEventDriver::SubEventDriver() : fMinEnergy(1. * GeV)
+{
+  fgInstance = this;
+  fMessenger = new SubEventMessenger(this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SubEventDriver::~SubEventDriver()
+{
+  delete fMessenger;
+  fgInstance = nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SubEventDriver::BeginOfRun()
+{
+  fNbOfSplitTracks = 0;
+  fNbOfSubEvents = 0;
+  fNbOfMergedHits = 0;
+
+  // one sub-event type, registered once: the bundle size is only set in
+  // PreInit state
+  if (fRegistered) return;
+#ifdef B2A_SUBEVENT_PARALLEL
+  auto runManager = static_cast<G4SubEvtRunManager*>(G4RunManager::GetRunManager());
+  runManager->RegisterSubEventType(0, fBundleSize);
+#endif
+  fRegistered = true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SubEventDriver::EndOfRun(G4int runID) const
+{
+  G4double perSubEvent = (fNbOfSubEvents > 0) ? G4double(fNbOfMergedHits) / fNbOfSubEvents : 0.;
+  G4cout << G4endl << " Sub-events: " << fNbOfSplitTracks << " tracks in " << fNbOfSubEvents
+         << " sub-events of up to " << fBundleSize << " tracks, " << perSubEvent
+         << " hits merged per sub-event" << G4endl
+         << "B2a-subevent run=" << runID << " tracks=" << fNbOfSplitTracks
+         << " subevents=" << fNbOfSubEvents << " bundle=" << fBundleSize
+         << " min_energy_MeV=" << fMinEnergy / MeV << " merged_hits=" << fNbOfMergedHits
+         << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4ClassificationOfNewTrack SubEventDriver::Classify(const G4Track* track)
+{
+  // the workers process their sub-events entirely
+  if (G4Threading::IsWorkerThread() || track->GetParentID() == 0) return fUrgent;
+  if (track->GetKineticEnergy() < fMinEnergy) return fUrgent;
+
+#ifdef B2A_SUBEVENT_PARALLEL
+  ++fNbOfSplitTracks;
+  return fSubEvent_0;
+#else
+  return fUrgent;
+#endif
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SubEventDriver::BeginOfEvent(StartupProfiler::Clock::time_point start)
+{
+  // owned by the event
+  auto buffer = new EventBuffer;
+  buffer->start = start;
+  G4EventManager::GetEventManager()->SetUserInformation(buffer);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SubEventDriver::MergeSubEvent(G4Event* masterEvent, const G4Event* subEvent)
+{
+  auto buffer = static_cast<EventBuffer*>(masterEvent->GetUserInformation());
+  if (!buffer) return;
+
+  auto hits = GetCollection<TrackerHitsCollection>(subEvent, "TrackerHitsCollection");
+  auto pixels = GetCollection<PixelHitsCollection>(subEvent, "PixelHitsCollection");
+
+  // the sub-events of an event may end together on several workers; the
+  // hits are copied by value, those of the worker belong to its allocator
+  G4AutoLock lock(&buffer->mutex);
+  std::size_t nofHits = 0;
+  if (hits) {
+    for (std::size_t i = 0; i < hits->entries(); ++i) buffer->hits.push_back(*(*hits)[i]);
+    nofHits += hits->entries();
+  }
+  if (pixels) {
+    for (std::size_t i = 0; i < pixels->entries(); ++i) {
+      buffer->pixels.push_back(pixels->GetEntry(i));
+    }
+    nofHits += pixels->entries();
+  }
+  ++fNbOfSubEvents;
+  fNbOfMergedHits += nofHits;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SubEventDriver::CompleteEvent(const G4Event* event)
+{
+  auto buffer = static_cast<EventBuffer*>(event->GetUserInformation());
+  if (!buffer) return;
+
+  // no sub-event of this event is running any more
+  if (auto hits = GetCollection<TrackerHitsCollection>(event, "TrackerHitsCollection")) {
+    for (const auto& hit : buffer->hits) hits->insert(new TrackerHit(hit));
+    auto key = [](const TrackerHit* hit) {
+      auto position = hit->GetPos();
+      return std::make_tuple(hit->GetChamberNb(), hit->GetTime(), position.z(), position.x(),
+                             position.y(), hit->GetEdep(), hit->GetWeight(), hit->GetTrackID());
+    };
+    auto vector = hits->GetVector();
+    std::sort(vector->begin(), vector->end(),
+              [&key](const TrackerHit* a, const TrackerHit* b) { return key(a) < key(b); });
+  }
+  if (auto pixels = GetCollection<PixelHitsCollection>(event, "PixelHitsCollection")) {
+    pixels->Merge(std::move(buffer->pixels));
+  }
+  buffer->hits.clear();
+  buffer->pixels.clear();
+
+  if (fEventAction) fEventAction->CompleteEvent(event, buffer->start);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}  // namespace B2a
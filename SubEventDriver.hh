@@ -0,0 +1,148 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file SubEventDriver.hh
+/// \brief Definition of the B2a::SubEventDriver class
+
+#ifndef B2aSubEventDriver_h
+#define B2aSubEventDriver_h 1
+
+#include "PixelHitsCollection.hh"
+#include "StartupProfiler.hh"
+#include "TrackerHit.hh"
+
+#include "G4ClassificationOfNewTrack.hh"
+#include "G4Threading.hh"
+#include "G4VUserEventInformation.hh"
+#include "G4Version.hh"
+#include "globals.hh"
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+// The sub-event parallel run manager comes with Geant4 11.2
+#if G4VERSION_NUMBER >= 1120
+#  define B2A_SUBEVENT_PARALLEL 1
+#endif
+
+class G4Event;
+class G4Track;
+
+namespace B2a
+{
+
+class EventAction;
+class SubEventMessenger;
+
+/// Driver of the sub-event parallel mode (--mode SubEvt, Geant4 11.2).
+///
+/// The master processes the events; the new tracks of an event above
+/// /B2/subevent/minEnergy are stacked as sub-events of
+/// /B2/subevent/bundleSize tracks, which the idle workers process with
+/// all their descendants. A heavy event is then shared by all the cores
+/// instead of holding one of them while the others wait at the end of
+/// the run.
+///
+/// The thread ending a sub-event copies its hits, or pixels, into the
+/// buffer of the parent event (see EventAction::MergeSubEvent), whatever
+/// the thread. Once all the sub-events are merged (see Run::RecordEvent),
+/// the master adds the buffer to the "TrackerHitsCollection", or the
+/// "PixelHitsCollection", of the event and sorts it in a canonical order
+/// (by layer, time, position and deposit; by layer and pixel, the
+/// deposits of a pixel summed in that order), so that the hits, and the
+/// sums computed from them, do not depend on the order in which the
+/// sub-events end. Only then is the event accounted and passed to the
+/// output stages, its time being that of the whole event.
+///
+/// The region counters and the stepping profile of the workers cover
+/// the tracks of the sub-events. The phase space, the voxel scoring and
+/// the checkpoints would be handled by the master, and only see its
+/// tracks: a run with any of them is refused (see RunAction).
+///
+/// Master thread only, driven by SubEventMessenger; the stacking actions
+/// read the classification, any thread merges sub-events.
+
+class SubEventDriver
+{
+  public:
+    SubEventDriver();
+    ~SubEventDriver();
+
+    // nullptr if the job does not run in sub-event mode
+    static SubEventDriver* GetInstance() { return fgInstance; }
+
+    void SetBundleSize(G4int size) { fBundleSize = size; }
+    void SetMinEnergy(G4double energy) { fMinEnergy = energy; }
+
+    // The event action of the master, which accounts the complete events
+    void SetEventAction(EventAction* action) { fEventAction = action; }
+
+    // Master: registers the sub-event type before the first event loop
+    void BeginOfRun();
+    void EndOfRun(G4int runID) const;
+
+    // Stacking: the secondaries of the master above the energy threshold
+    // go to the sub-events
+    G4ClassificationOfNewTrack Classify(const G4Track*);
+
+    // Master: the buffer of the sub-events of a new event
+    void BeginOfEvent(StartupProfiler::Clock::time_point start);
+
+    // Thread ending a sub-event
+    void MergeSubEvent(G4Event* masterEvent, const G4Event* subEvent);
+
+    // Master, all the sub-events merged
+    void CompleteEvent(const G4Event*);
+
+  private:
+    // Hits of the sub-events of an event, attached to the event
+    struct EventBuffer : public G4VUserEventInformation {
+      void Print() const override {}
+
+      G4Mutex mutex;
+      std::vector<TrackerHit> hits;
+      std::vector<PixelHitsCollection::Entry> pixels;
+      StartupProfiler::Clock::time_point start;
+    };
+
+    static SubEventDriver* fgInstance;
+
+    G4int fBundleSize = 20;
+    G4double fMinEnergy;
+    G4bool fRegistered = false;
+    EventAction* fEventAction = nullptr;
+
+    std::uint64_t fNbOfSplitTracks = 0;  // classified by the master
+    std::atomic<std::uint64_t> fNbOfSubEvents{0};
+    std::atomic<std::uint64_t> fNbOfMergedHits{0};
+
+    SubEventMessenger* fMessenger = nullptr;
+};
+
+}  // namespace B2a
+
+#endif
@@ -0,0 +1,92 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file SubEventMessenger.cc
+/// \brief Implementation of the B2a::SubEventMessenger class
+
+#include "SubEventMessenger.hh"
+
+#include "SubEventDriver.hh"
+
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIdirectory.hh"
+
+namespace B2a
+{
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SubEventMessenger::SubEventMessenger(SubEventDriver* driver) : fSubEventDriver(driver)
+{
+  fDirectory = new G4UIdirectory("/B2/subevent/");
+  fDirectory->SetGuidance("Sub-event parallel processing of the events (--mode SubEvt).");
+
+  fBundleSizeCmd = new G4UIcmdWithAnInteger("/B2/subevent/bundleSize", this);
+  fBundleSizeCmd->SetGuidance("Tracks per sub-event (default 20): a sub-event is handed to a");
+  fBundleSizeCmd->SetGuidance("worker once that many tracks are stacked, or at the end of");
+  fBundleSizeCmd->SetGuidance("the part of the event processed by the master.");
+  fBundleSizeCmd->SetParameterName("nofTracks", false);
+  fBundleSizeCmd->SetRange("nofTracks>0");
+  fBundleSizeCmd->AvailableForStates(G4State_PreInit);
+  fBundleSizeCmd->SetToBeBroadcasted(false);
+
+  fMinEnergyCmd = new G4UIcmdWithADoubleAndUnit("/B2/subevent/minEnergy", this);
+  fMinEnergyCmd->SetGuidance("Kinetic energy above which a secondary created by the master");
+  fMinEnergyCmd->SetGuidance("goes to a sub-event (default 1 GeV); the others, and all the");
+  fMinEnergyCmd->SetGuidance("tracks of the sub-events, stay on their thread.");
+  fMinEnergyCmd->SetParameterName("energy", false);
+  fMinEnergyCmd->SetRange("energy>=0.");
+  fMinEnergyCmd->SetUnitCategory("Energy");
+  fMinEnergyCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fMinEnergyCmd->SetToBeBroadcasted(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SubEventMessenger::~SubEventMessenger()
+{
+  delete fBundleSizeCmd;
+  delete fMinEnergyCmd;
+  delete fDirectory;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SubEventMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+  if (command == fBundleSizeCmd) {
+    fSubEventDriver->SetBundleSize(fBundleSizeCmd->GetNewIntValue(newValue));
+  }
+
+  if (command == fMinEnergyCmd) {
+    fSubEventDriver->SetMinEnergy(fMinEnergyCmd->GetNewDoubleValue(newValue));
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}  // namespace B2a
@@ -0,0 +1,125 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file SweepDriver.cc
+/// \brief Implementation of the B2a::SweepDriver class
+
+#include "SweepDriver.hh"
+
+#include "DetectorConstruction.hh"
+#include "Run.hh"
+#include "RunAction.hh"
+#include "SweepMessenger.hh"
+
+#include "G4RunManager.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4Timer.hh"
+
+#include <fstream>
+
+namespace B2a
+{
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SweepDriver::SweepDriver(DetectorConstruction* det) : fDetectorConstruction(det)
+{
+  fMessenger = new SweepMessenger(this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SweepDriver::~SweepDriver()
+{
+  delete fMessenger;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SweepDriver::BeamOn(G4int nofEvents)
+{
+  auto runManager = G4RunManager::GetRunManager();
+
+  std::ofstream summary(fSummaryFileName);
+  if (!summary) {
+    G4ExceptionDescription msg;
+    msg << "Cannot open sweep summary file " << fSummaryFileName;
+    G4Exception("SweepDriver::BeamOn()", "B2aSweep001", JustWarning, msg);
+    return;
+  }
+  summary << "config,chamberMaterial,targetMaterial,stepMax_mm,events,total_s,eventLoop_s,"
+             "events_per_s,hits_per_event,edep_per_event_MeV\n";
+
+  // An empty list keeps the current setting
+  auto chambers = fChamberMaterials.empty() ? std::vector<G4String>{""} : fChamberMaterials;
+  auto targets = fTargetMaterials.empty() ? std::vector<G4String>{""} : fTargetMaterials;
+  auto stepMaxs = fStepMaxValues.empty() ? std::vector<G4double>{0.} : fStepMaxValues;
+
+  G4int config = 0;
+  for (const auto& chamber : chambers) {
+    if (!chamber.empty()) fDetectorConstruction->SetChamberMaterial(chamber);
+
+    for (const auto& target : targets) {
+      if (!target.empty()) fDetectorConstruction->SetTargetMaterial(target);
+
+      for (auto stepMax : stepMaxs) {
+        if (stepMax > 0.) fDetectorConstruction->SetMaxStep(stepMax);
+
+        G4cout << G4endl << "---> Sweep configuration " << config << ": chamber "
+               << (chamber.empty() ? "-" : chamber) << ", target "
+               << (target.empty() ? "-" : target) << ", stepMax "
+               << (stepMax > 0. ? std::to_string(stepMax / mm) + " mm" : "-") << G4endl;
+
+        G4Timer timer;
+        timer.Start();
+        runManager->BeamOn(nofEvents);
+        timer.Stop();
+
+        auto run = static_cast<const Run*>(runManager->GetCurrentRun());
+        auto runAction = static_cast<const RunAction*>(runManager->GetUserRunAction());
+        if (!run || !runAction) continue;
+
+        G4int nofDone = run->GetNumberOfEvent();
+        G4double loopTime = runAction->GetEventLoopTime();
+        G4double norm = (nofDone > 0) ? 1. / nofDone : 0.;
+
+        summary << config << ',' << chamber << ',' << target << ',' << stepMax / mm << ','
+                << nofDone << ',' << timer.GetRealElapsed() << ',' << loopTime << ','
+                << (loopTime > 0. ? nofDone / loopTime : 0.) << ','
+                << run->GetNbOfHits() * norm << ',' << run->GetEdep() * norm / MeV << '\n';
+        summary.flush();
+        ++config;
+      }
+    }
+  }
+
+  G4cout << G4endl << "---> Sweep done: " << config << " configurations, summary in "
+         << fSummaryFileName << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}  // namespace B2a
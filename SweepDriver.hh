@@ -0,0 +1,80 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file SweepDriver.hh
+/// \brief Definition of the B2a::SweepDriver class
+
+#ifndef B2aSweepDriver_h
+#define B2aSweepDriver_h 1
+
+#include "globals.hh"
+
+#include <vector>
+
+namespace B2a
+{
+
+class DetectorConstruction;
+class SweepMessenger;
+
+/// Parameter sweep driver.
+///
+/// Runs the grid (chamber material x target material x step max) back to
+/// back in the same process and writes one summary row per configuration.
+/// Physics tables and geometry are kept between the configurations: the
+/// materials are swapped in place and the kernel only builds the tables
+/// of the material-cuts couples that are new to the job. The loops are
+/// ordered so that the chamber material, the most expensive change,
+/// changes least often.
+///
+/// Master thread only; it is driven by SweepMessenger.
+
+class SweepDriver
+{
+  public:
+    SweepDriver(DetectorConstruction*);
+    ~SweepDriver();
+
+    void SetTargetMaterials(const std::vector<G4String>& names) { fTargetMaterials = names; }
+    void SetChamberMaterials(const std::vector<G4String>& names) { fChamberMaterials = names; }
+    void SetStepMaxValues(const std::vector<G4double>& values) { fStepMaxValues = values; }
+    void SetSummaryFileName(const G4String& name) { fSummaryFileName = name; }
+
+    void BeamOn(G4int nofEvents);
+
+  private:
+    DetectorConstruction* fDetectorConstruction = nullptr;
+    SweepMessenger* fMessenger = nullptr;
+
+    std::vector<G4String> fTargetMaterials;
+    std::vector<G4String> fChamberMaterials;
+    std::vector<G4double> fStepMaxValues;
+    G4String fSummaryFileName = "sweep.csv";
+};
+
+}  // namespace B2a
+
+#endif
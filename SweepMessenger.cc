@@ -0,0 +1,142 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file SweepMessenger.cc
+/// \brief Implementation of the B2a::SweepMessenger class
+
+#include "SweepMessenger.hh"
+
+#include "SweepDriver.hh"
+
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcommand.hh"
+#include "G4UIdirectory.hh"
+
+#include <sstream>
+
+namespace B2a
+{
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SweepMessenger::SweepMessenger(SweepDriver* sweep) : fSweepDriver(sweep)
+{
+  fDirectory = new G4UIdirectory("/B2/sweep/");
+  fDirectory->SetGuidance("Parameter sweep in a single job.");
+
+  fTargMatsCmd = new G4UIcmdWithAString("/B2/sweep/targetMaterials", this);
+  fTargMatsCmd->SetGuidance("List of target materials to sweep.");
+  fTargMatsCmd->SetParameterName("names", false);
+  fTargMatsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fTargMatsCmd->SetToBeBroadcasted(false);
+
+  fChamMatsCmd = new G4UIcmdWithAString("/B2/sweep/chamberMaterials", this);
+  fChamMatsCmd->SetGuidance("List of chamber materials to sweep.");
+  fChamMatsCmd->SetParameterName("names", false);
+  fChamMatsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fChamMatsCmd->SetToBeBroadcasted(false);
+
+  fStepMaxsCmd = new G4UIcmdWithAString("/B2/sweep/stepMaxValues", this);
+  fStepMaxsCmd->SetGuidance("List of tracker step max values to sweep, followed by the unit.");
+  fStepMaxsCmd->SetParameterName("values", false);
+  fStepMaxsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fStepMaxsCmd->SetToBeBroadcasted(false);
+
+  fSummaryCmd = new G4UIcmdWithAString("/B2/sweep/summaryFile", this);
+  fSummaryCmd->SetGuidance("CSV file receiving one row per configuration.");
+  fSummaryCmd->SetParameterName("name", false);
+  fSummaryCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fSummaryCmd->SetToBeBroadcasted(false);
+
+  fBeamOnCmd = new G4UIcmdWithAnInteger("/B2/sweep/beamOn", this);
+  fBeamOnCmd->SetGuidance("Run all the configurations of the grid.");
+  fBeamOnCmd->SetParameterName("nofEvents", false);
+  fBeamOnCmd->SetRange("nofEvents>0");
+  fBeamOnCmd->AvailableForStates(G4State_Idle);
+  fBeamOnCmd->SetToBeBroadcasted(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SweepMessenger::~SweepMessenger()
+{
+  delete fTargMatsCmd;
+  delete fChamMatsCmd;
+  delete fStepMaxsCmd;
+  delete fSummaryCmd;
+  delete fBeamOnCmd;
+  delete fDirectory;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SweepMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+  std::istringstream is(newValue);
+
+  if (command == fTargMatsCmd || command == fChamMatsCmd) {
+    std::vector<G4String> names;
+    G4String name;
+    while (is >> name) names.push_back(name);
+    if (command == fTargMatsCmd) {
+      fSweepDriver->SetTargetMaterials(names);
+    }
+    else {
+      fSweepDriver->SetChamberMaterials(names);
+    }
+  }
+
+  if (command == fStepMaxsCmd) {
+    // numbers first, the unit last
+    std::vector<G4String> tokens;
+    G4String token;
+    while (is >> token) tokens.push_back(token);
+    G4double unit = 1.;
+    G4double number = 0.;
+    if (!tokens.empty() && !(std::istringstream(tokens.back()) >> number)) {
+      unit = G4UIcommand::ValueOf(tokens.back());
+      tokens.pop_back();
+    }
+    std::vector<G4double> values;
+    for (const auto& value : tokens) {
+      values.push_back(G4UIcommand::ConvertToDouble(value) * unit);
+    }
+    fSweepDriver->SetStepMaxValues(values);
+  }
+
+  if (command == fSummaryCmd) {
+    fSweepDriver->SetSummaryFileName(newValue);
+  }
+
+  if (command == fBeamOnCmd) {
+    fSweepDriver->BeamOn(fBeamOnCmd->GetNewIntValue(newValue));
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}  // namespace B2a
@@ -0,0 +1,78 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file SweepMessenger.hh
+/// \brief Definition of the B2a::SweepMessenger class
+
+#ifndef B2aSweepMessenger_h
+#define B2aSweepMessenger_h 1
+
+#include "G4UImessenger.hh"
+
+class G4UIdirectory;
+class G4UIcmdWithAString;
+class G4UIcmdWithAnInteger;
+class G4UIcommand;
+
+namespace B2a
+{
+
+class SweepDriver;
+
+/// Messenger class that defines commands for SweepDriver.
+///
+/// It implements commands:
+/// - /B2/sweep/targetMaterials name1 name2 ...
+/// - /B2/sweep/chamberMaterials name1 name2 ...
+/// - /B2/sweep/stepMaxValues value1 value2 ... unit
+/// - /B2/sweep/summaryFile name
+/// - /B2/sweep/beamOn nofEvents
+///
+/// The sweep runs on the master only, so no command is broadcast.
+
+class SweepMessenger : public G4UImessenger
+{
+  public:
+    SweepMessenger(SweepDriver*);
+    ~SweepMessenger() override;
+
+    void SetNewValue(G4UIcommand*, G4String) override;
+
+  private:
+    SweepDriver* fSweepDriver = nullptr;
+
+    G4UIdirectory* fDirectory = nullptr;
+
+    G4UIcmdWithAString* fTargMatsCmd = nullptr;
+    G4UIcmdWithAString* fChamMatsCmd = nullptr;
+    G4UIcmdWithAString* fStepMaxsCmd = nullptr;
+    G4UIcmdWithAString* fSummaryCmd = nullptr;
+    G4UIcmdWithAnInteger* fBeamOnCmd = nullptr;
+};
+
+}  // namespace B2a
+
+#endif
@@ -0,0 +1,96 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file TabulatedField.cc
+/// \brief Implementation of the B2a::TabulatedField class
+
+#include "TabulatedField.hh"
+
+#include "FieldMap.hh"
+
+#include <algorithm>
+
+namespace B2a
+{
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+TabulatedField::TabulatedField(const FieldMap* map) : fMap(map) {}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void TabulatedField::GetFieldValue(const G4double point[4], G4double* field) const
+{
+  const G4int nofNodes[3] = {fMap->GetNx(), fMap->GetNy(), fMap->GetNz()};
+
+  // cell of the point, and position in the cell
+  G4int cell[3];
+  G4double u[3];
+  for (G4int axis = 0; axis < 3; ++axis) {
+    u[axis] = (point[axis] - fMap->GetMin(axis)) * fMap->GetInverseStep(axis);
+    if (!(u[axis] >= 0. && u[axis] <= nofNodes[axis] - 1)) {
+      field[0] = field[1] = field[2] = 0.;
+      return;
+    }
+    cell[axis] = std::min(G4int(u[axis]), nofNodes[axis] - 2);
+    u[axis] -= cell[axis];
+  }
+
+  if (cell[0] != fCell[0] || cell[1] != fCell[1] || cell[2] != fCell[2]) {
+    LoadCell(cell);
+  }
+
+  // trilinear weights, then one dot product per component
+  G4double weight[8];
+  for (G4int k = 0; k < 8; ++k) {
+    weight[k] = ((k & 1) ? u[0] : 1. - u[0]) * ((k & 2) ? u[1] : 1. - u[1])
+                * ((k & 4) ? u[2] : 1. - u[2]);
+  }
+  for (G4int component = 0; component < 3; ++component) {
+    G4double sum = 0.;
+    for (G4int k = 0; k < 8; ++k) {
+      sum += weight[k] * fCorner[component][k];
+    }
+    field[component] = sum;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void TabulatedField::LoadCell(const G4int cell[3]) const
+{
+  for (G4int k = 0; k < 8; ++k) {
+    auto node = fMap->GetNode(cell[0] + (k & 1), cell[1] + ((k >> 1) & 1), cell[2] + (k >> 2));
+    for (G4int component = 0; component < 3; ++component) {
+      fCorner[component][k] = node[component];
+    }
+  }
+  std::copy(cell, cell + 3, fCell);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}  // namespace B2a
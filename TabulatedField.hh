@@ -0,0 +1,69 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file TabulatedField.hh
+/// \brief Definition of the B2a::TabulatedField class
+
+#ifndef B2aTabulatedField_h
+#define B2aTabulatedField_h 1
+
+#include "G4MagneticField.hh"
+
+namespace B2a
+{
+
+class FieldMap;
+
+/// Magnetic field interpolated (trilinear) in a FieldMap; zero outside
+/// the map.
+///
+/// One instance per thread, all pointing to the same map. The field at
+/// the 8 corners of the last cell is cached: consecutive calls of the
+/// stepper mostly fall in the same cell, and then only the 8 weights
+/// are computed.
+
+class TabulatedField : public G4MagneticField
+{
+  public:
+    explicit TabulatedField(const FieldMap* map);
+    ~TabulatedField() override = default;
+
+    void GetFieldValue(const G4double point[4], G4double* field) const override;
+
+  private:
+    void LoadCell(const G4int cell[3]) const;
+
+    const FieldMap* fMap = nullptr;
+
+    // last cell, and its corners per component (corner k: x + 2y + 4z);
+    // mutable as GetFieldValue() is const, safe as the field is per thread
+    mutable G4int fCell[3] = {-1, -1, -1};
+    mutable G4double fCorner[3][8] = {};
+};
+
+}  // namespace B2a
+
+#endif
@@ -0,0 +1,212 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file TargetShowerModel.cc
+/// \brief Implementation of the B2a::TargetShowerModel class
+
+#include "TargetShowerModel.hh"
+
+#include "G4DynamicParticle.hh"
+#include "G4Electron.hh"
+#include "G4FastStep.hh"
+#include "G4FastTrack.hh"
+#include "G4Gamma.hh"
+#include "G4LogicalVolume.hh"
+#include "G4Material.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4Positron.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4Tubs.hh"
+#include "Randomize.hh"
+
+#include <cmath>
+#include <vector>
+
+namespace
+{
+// Regularised upper incomplete gamma function Q(a, x) = 1 - P(a, x)
+G4double GammaQ(G4double a, G4double x)
+{
+  if (x <= 0.) return 1.;
+  G4double logPrefactor = a * std::log(x) - x - std::lgamma(a);
+
+  if (x < a + 1.) {
+    // series of P(a, x)
+    G4double term = 1. / a;
+    G4double sum = term;
+    for (G4int n = 1; n < 200 && term > sum * 1.e-10; ++n) {
+      term *= x / (a + n);
+      sum += term;
+    }
+    return 1. - sum * std::exp(logPrefactor);
+  }
+
+  // continued fraction of Q(a, x) (modified Lentz)
+  const G4double tiny = 1.e-300;
+  G4double b = x + 1. - a;
+  G4double c = 1. / tiny;
+  G4double d = 1. / b;
+  G4double h = d;
+  for (G4int n = 1; n < 200; ++n) {
+    G4double an = -n * (n - a);
+    b += 2.;
+    d = an * d + b;
+    if (std::abs(d) < tiny) d = tiny;
+    c = b + an / c;
+    if (std::abs(c) < tiny) c = tiny;
+    d = 1. / d;
+    G4double delta = d * c;
+    h *= delta;
+    if (std::abs(delta - 1.) < 1.e-10) break;
+  }
+  return std::exp(logPrefactor) * h;
+}
+}  // namespace
+
+namespace B2a
+{
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+TargetShowerModel::TargetShowerModel(const G4String& name, G4Region* envelope,
+                                     const ShowerParameters* parameters)
+  : G4VFastSimulationModel(name, envelope), fParameters(parameters)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool TargetShowerModel::IsApplicable(const G4ParticleDefinition& particle)
+{
+  return &particle == G4Electron::Definition() || &particle == G4Positron::Definition()
+         || &particle == G4Gamma::Definition();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double TargetShowerModel::DepthToExit(const G4FastTrack& fastTrack) const
+{
+  auto tubs = static_cast<const G4Tubs*>(fastTrack.GetEnvelopeSolid());
+  G4double dz = fastTrack.GetPrimaryTrackLocalDirection().z();
+  if (dz <= 0.) return DBL_MAX;  // backwards: nothing leaks downstream
+  return (tubs->GetZHalfLength() - fastTrack.GetPrimaryTrackLocalPosition().z()) / dz;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool TargetShowerModel::ModelTrigger(const G4FastTrack& fastTrack)
+{
+  if (!fParameters->enabled) return false;
+  if (fastTrack.GetPrimaryTrack()->GetKineticEnergy() < fParameters->threshold) return false;
+
+  // only the tracks heading downstream, whose axis leaves through the
+  // downstream face: the others would leak through the side or upstream,
+  // which the model does not describe
+  if (fastTrack.GetPrimaryTrackLocalDirection().z() <= 0.) return false;
+  G4double depth = DepthToExit(fastTrack);
+  G4double exit = fastTrack.GetEnvelopeSolid()->DistanceToOut(
+    fastTrack.GetPrimaryTrackLocalPosition(), fastTrack.GetPrimaryTrackLocalDirection());
+  if (exit < depth - 1. * um) return false;
+
+  G4double radiationLength = fastTrack.GetEnvelopeLogicalVolume()->GetMaterial()->GetRadlen();
+  return depth > radiationLength;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void TargetShowerModel::DoIt(const G4FastTrack& fastTrack, G4FastStep& fastStep)
+{
+  auto track = fastTrack.GetPrimaryTrack();
+  G4double energy = track->GetKineticEnergy();
+  auto material = fastTrack.GetEnvelopeLogicalVolume()->GetMaterial();
+  auto tubs = static_cast<const G4Tubs*>(fastTrack.GetEnvelopeSolid());
+
+  // Shower scale of the material
+  G4double radiationLength = material->GetRadlen();
+  G4double effectiveZ =
+    material->GetTotNbOfElectPerVolume() / material->GetTotNbOfAtomsPerVolume();
+  G4double criticalEnergy = 610. * MeV / (effectiveZ + 1.24);
+  G4double moliereRadius = 21.2 * MeV * radiationLength / criticalEnergy;
+
+  // Leaked energy: tail of the longitudinal profile beyond the exit
+  G4double depth = DepthToExit(fastTrack);
+  G4bool isGamma = (track->GetDefinition() == G4Gamma::Definition());
+  G4double tMax = std::max(0., std::log(energy / criticalEnergy) + (isGamma ? 0.5 : -0.5));
+  G4double b = fParameters->profileB;
+  G4double a = b * tMax + 1.;
+  G4double leaked = energy * fParameters->leakageScale * GammaQ(a, b * depth / radiationLength);
+  leaked = std::min(leaked, energy);
+
+  // Sample the leaked particles: power law in [minEnergy, leaked]
+  G4ThreeVector axis = fastTrack.GetPrimaryTrackLocalDirection();
+  G4ThreeVector exitPoint = fastTrack.GetPrimaryTrackLocalPosition() + depth * axis;
+  G4double zExit = tubs->GetZHalfLength() - 1. * um;  // just inside the face
+  G4double radius = tubs->GetOuterRadius() - 1. * um;
+  G4double time = track->GetGlobalTime() + depth / c_light;
+
+  struct Leaked {
+    G4double energy;
+    G4bool charged;
+  };
+  std::vector<Leaked> particles;
+  G4double remaining = leaked;
+  G4double minEnergy = fParameters->minEnergy;
+  G4double slope = fParameters->spectrumSlope;
+  while (remaining > minEnergy) {
+    // inverse transform of E^-slope (slope != 1) between minEnergy and remaining
+    G4double u = G4UniformRand();
+    G4double e1 = std::pow(minEnergy, 1. - slope);
+    G4double e2 = std::pow(remaining, 1. - slope);
+    G4double e = std::pow(e1 + u * (e2 - e1), 1. / (1. - slope));
+    particles.push_back({e, G4UniformRand() < fParameters->chargedFraction});
+    remaining -= e;
+  }
+
+  fastStep.SetNumberOfSecondaryTracks(particles.size());
+  for (const auto& particle : particles) {
+    // lateral spread within a Moliere radius, angular spread ~ 1/sqrt(E)
+    G4ThreeVector position(exitPoint.x() + G4RandGauss::shoot(0., moliereRadius),
+                           exitPoint.y() + G4RandGauss::shoot(0., moliereRadius), zExit);
+    if (position.perp() > radius) position.setPerp(radius);
+
+    G4double theta = std::abs(G4RandGauss::shoot(0., std::sqrt(MeV / particle.energy)));
+    G4ThreeVector direction = axis;
+    direction.rotate(axis.orthogonal(), std::min(theta, 0.5 * pi));
+    direction.rotate(axis, twopi * G4UniformRand());
+    if (direction.z() <= 0.) direction = axis;
+
+    auto definition = particle.charged ? G4Electron::Definition() : G4Gamma::Definition();
+    G4DynamicParticle dynamic(definition, direction, particle.energy);
+    fastStep.CreateSecondaryTrack(dynamic, position, time, true);  // local coordinates
+  }
+
+  // what does not leak is deposited here
+  fastStep.KillPrimaryTrack();
+  fastStep.ProposeTotalEnergyDeposited(energy - leaked + remaining);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}  // namespace B2a
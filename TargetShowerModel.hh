@@ -0,0 +1,92 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file TargetShowerModel.hh
+/// \brief Definition of the B2a::TargetShowerModel class
+
+#ifndef B2aTargetShowerModel_h
+#define B2aTargetShowerModel_h 1
+
+#include "CLHEP/Units/SystemOfUnits.h"
+#include "G4VFastSimulationModel.hh"
+#include "globals.hh"
+
+namespace B2a
+{
+
+/// Settings of the target shower model, shared by the models of all
+/// threads; they are only changed in Idle state, from the master.
+struct ShowerParameters {
+  G4bool enabled = false;
+  G4double threshold = 1. * CLHEP::GeV;  // e-, e+, gamma kinetic energy
+  G4double leakageScale = 1.;  // tuning of the leaked energy
+  G4double spectrumSlope = 2.;  // leaked particles: dN/dE ~ E^-slope
+  G4double minEnergy = 1. * CLHEP::MeV;  // of the leaked particles
+  G4double chargedFraction = 0.1;  // electrons among the leaked particles
+  G4double profileB = 0.5;  // b parameter of the longitudinal profile
+};
+
+/// Electromagnetic shower parameterisation in the target.
+///
+/// An e-, e+ or gamma above threshold is killed where it triggers, and
+/// only what its shower leaks out of the downstream face of the target
+/// (a G4Tubs along z) is produced:
+/// - the leaked energy is the tail of the longitudinal profile
+///   dE/dt ~ (bt)^(a-1) exp(-bt) beyond the remaining depth, with
+///   t_max = (a-1)/b = ln(E/Ec) -+ 0.5 (Longo-Sestili);
+/// - it is shared among photons (and a fraction of electrons) sampled
+///   from a power-law spectrum, started on the downstream face, around
+///   the shower axis within one Moliere radius.
+/// The rest is deposited locally. The parameters are tuned against the
+/// full simulation with /B2/fastSim/validate (see FastSimValidator).
+///
+/// The model only triggers on tracks heading downstream whose axis leaves
+/// the target through the downstream face, more than one radiation length
+/// away, so that it never triggers on its own products. The lateral
+/// leakage is ignored: the leaked particles are clipped to the face, so a
+/// shower close to the side of the target deposits too much locally.
+
+class TargetShowerModel : public G4VFastSimulationModel
+{
+  public:
+    TargetShowerModel(const G4String& name, G4Region* envelope,
+                      const ShowerParameters* parameters);
+    ~TargetShowerModel() override = default;
+
+    G4bool IsApplicable(const G4ParticleDefinition&) override;
+    G4bool ModelTrigger(const G4FastTrack&) override;
+    void DoIt(const G4FastTrack&, G4FastStep&) override;
+
+  private:
+    // Depth (along the track) to the downstream face, in the envelope frame
+    G4double DepthToExit(const G4FastTrack&) const;
+
+    const ShowerParameters* fParameters = nullptr;
+};
+
+}  // namespace B2a
+
+#endif
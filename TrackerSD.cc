@@ -0,0 +1,197 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file TrackerSD.cc
+/// \brief Implementation of the B2a::TrackerSD class
+
+#include "TrackerSD.hh"
+
+#include "DetectorConstruction.hh"
+
+#include "G4HCofThisEvent.hh"
+#include "G4RunManager.hh"
+#include "G4SDManager.hh"
+#include "G4Step.hh"
+#include "G4ios.hh"
+
+#include <algorithm>
+
+namespace B2a
+{
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+TrackerSD::TrackerSD(const G4String& name, const G4String& hitsCollectionName,
+                     const G4String& pixelsCollectionName)
+  : G4VSensitiveDetector(name)
+{
+  collectionName.insert(hitsCollectionName);
+  collectionName.insert(pixelsCollectionName);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void TrackerSD::UpdateGrid()
+{
+  // the layer layout is constant during a run (see DetectorConstruction)
+  auto detector = static_cast<const DetectorConstruction*>(
+    G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+  const auto& layers = detector->GetLayerExtents();
+
+  fGrid.nofPixels = detector->GetNbOfPixels();
+  fGrid.halfWidth = detector->GetLayerHalfWidth();
+  fGrid.pitch = (fGrid.nofPixels > 0) ? 2. * fGrid.halfWidth / fGrid.nofPixels : 0.;
+  fGrid.layerZ.resize(layers.size());
+  for (std::size_t i = 0; i < layers.size(); ++i) {
+    fGrid.layerZ[i] = 0.5 * (layers[i].zMin + layers[i].zMax);
+  }
+
+  if (fPixelEdep.size() != fGrid.GetNbOfCells()) {
+    fPixelEdep.assign(fGrid.GetNbOfCells(), 0.);
+    fPixelTime.assign(fGrid.GetNbOfCells(), 0.);
+    fPixelWeightedEdep.assign(fGrid.GetNbOfCells(), 0.);
+    fTouched.clear();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void TrackerSD::Initialize(G4HCofThisEvent* hce)
+{
+  // the grid is only rebuilt when the stack or the pixels change
+  auto detector = static_cast<const DetectorConstruction*>(
+    G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+  if (detector->GetReadoutVersion() != fGridVersion) {
+    UpdateGrid();
+    fGridVersion = detector->GetReadoutVersion();
+  }
+
+  // Create the hits or pixels collection, and add it in hce
+
+  if (fGrid.nofPixels > 0) {
+    fHitsCollection = nullptr;
+    fPixelsCollection = new PixelHitsCollection(SensitiveDetectorName, collectionName[1], &fGrid);
+    fPixelsCollection->Reserve(fLastNbOfPixels);
+    G4int hcID = G4SDManager::GetSDMpointer()->GetCollectionID(collectionName[1]);
+    hce->AddHitsCollection(hcID, fPixelsCollection);
+    return;
+  }
+
+  fPixelsCollection = nullptr;
+  fHitsCollection = new TrackerHitsCollection(SensitiveDetectorName, collectionName[0]);
+
+  G4int hcID = G4SDManager::GetSDMpointer()->GetCollectionID(collectionName[0]);
+  hce->AddHitsCollection(hcID, fHitsCollection);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool TrackerSD::ProcessHits(G4Step* aStep, G4TouchableHistory*)
+{
+  // energy deposit
+  G4double edep = aStep->GetTotalEnergyDeposit();
+
+  if (edep == 0.) return false;
+
+  const G4VTouchable* touchable = aStep->GetPreStepPoint()->GetTouchable();
+  G4int layer = touchable->GetCopyNumber(0) + touchable->GetCopyNumber(1);
+
+  if (fPixelsCollection) {
+    // pixel of the step middle point, in the layer frame
+    auto position =
+      0.5 * (aStep->GetPreStepPoint()->GetPosition() + aStep->GetPostStepPoint()->GetPosition());
+    auto local = touchable->GetHistory()->GetTopTransform().TransformPoint(position);
+    G4int n = fGrid.nofPixels;
+    G4int ix = std::clamp(G4int((local.x() + fGrid.halfWidth) / fGrid.pitch), 0, n - 1);
+    G4int iy = std::clamp(G4int((local.y() + fGrid.halfWidth) / fGrid.pitch), 0, n - 1);
+    G4int cell = (layer * n + iy) * n + ix;
+
+    G4double time = aStep->GetPostStepPoint()->GetGlobalTime();
+    if (fPixelEdep[cell] == 0.) {
+      fTouched.push_back(cell);
+      fPixelTime[cell] = time;
+    }
+    else {
+      fPixelTime[cell] = std::min(fPixelTime[cell], time);
+    }
+    fPixelEdep[cell] += edep;
+    fPixelWeightedEdep[cell] += aStep->GetTrack()->GetWeight() * edep;
+    return true;
+  }
+
+  auto newHit = new TrackerHit();
+
+  newHit->SetTrackID(aStep->GetTrack()->GetTrackID());
+  newHit->SetChamberNb(layer);
+  newHit->SetEdep(edep);
+  newHit->SetPos(aStep->GetPostStepPoint()->GetPosition());
+  newHit->SetTime(aStep->GetPostStepPoint()->GetGlobalTime());
+  newHit->SetWeight(aStep->GetTrack()->GetWeight());
+
+  fHitsCollection->insert(newHit);
+
+  // newHit->Print();
+
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void TrackerSD::EndOfEvent(G4HCofThisEvent*)
+{
+  if (fPixelsCollection) {
+    // emit the non-empty pixels, ordered by layer and pixel, and reset them
+    std::sort(fTouched.begin(), fTouched.end());
+    G4int nofPixels = fGrid.nofPixels * fGrid.nofPixels;
+    for (auto cell : fTouched) {
+      fPixelsCollection->Add(cell / nofPixels, cell % nofPixels, fPixelEdep[cell],
+                             fPixelTime[cell], fPixelWeightedEdep[cell] / fPixelEdep[cell]);
+      fPixelEdep[cell] = 0.;
+      fPixelWeightedEdep[cell] = 0.;
+    }
+    fLastNbOfPixels = fTouched.size();
+    fTouched.clear();
+
+    if (verboseLevel > 1) {
+      G4cout << G4endl << "-------->Pixels Collection: in this event they are "
+             << fPixelsCollection->entries() << " pixels hit in the tracker chambers: " << G4endl;
+      fPixelsCollection->PrintAllHits();
+    }
+    return;
+  }
+
+  if (verboseLevel > 1) {
+    std::size_t nofHits = fHitsCollection->entries();
+    G4cout << G4endl << "-------->Hits Collection: in this event they are " << nofHits
+           << " hits in the tracker chambers: " << G4endl;
+    for (std::size_t i = 0; i < nofHits; i++)
+      (*fHitsCollection)[i]->Print();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}  // namespace B2a
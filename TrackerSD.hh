@@ -0,0 +1,88 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file TrackerSD.hh
+/// \brief Definition of the B2a::TrackerSD class
+
+#ifndef B2aTrackerSD_h
+#define B2aTrackerSD_h 1
+
+#include "PixelHitsCollection.hh"
+#include "TrackerHit.hh"
+
+#include "G4VSensitiveDetector.hh"
+
+class G4Step;
+class G4HCofThisEvent;
+
+namespace B2a
+{
+
+/// Tracker sensitive detector class
+///
+/// The hits are accounted in hits in ProcessHits() function which is called
+/// by Geant4 kernel at each step. A hit is created with each step with non zero
+/// energy deposit. The layer number is taken from the touchable: the
+/// parameterised copy number within its block plus the copy number of the
+/// block envelope (see DetectorConstruction).
+///
+/// With a pixelated readout (/B2/det/setPixels), no hit object is created:
+/// the deposits of the event are summed in dense per-thread arrays indexed
+/// by (layer, pixel), and only the non-empty pixels are emitted, in a
+/// PixelHitsCollection, at the end of the event. The arrays are allocated
+/// once, when the pixel grid or the stack changes, and only the touched
+/// pixels are reset.
+
+class TrackerSD : public G4VSensitiveDetector
+{
+  public:
+    TrackerSD(const G4String& name, const G4String& hitsCollectionName,
+              const G4String& pixelsCollectionName);
+    ~TrackerSD() override = default;
+
+    // methods from base class
+    void Initialize(G4HCofThisEvent* hitCollection) override;
+    G4bool ProcessHits(G4Step* step, G4TouchableHistory* history) override;
+    void EndOfEvent(G4HCofThisEvent* hitCollection) override;
+
+  private:
+    void UpdateGrid();
+
+    TrackerHitsCollection* fHitsCollection = nullptr;
+
+    PixelGrid fGrid;
+    PixelHitsCollection* fPixelsCollection = nullptr;
+    std::vector<G4double> fPixelEdep;  // (layer * nofPixels^2 + pixel), zero if empty
+    std::vector<G4double> fPixelTime;  // time of the first deposit
+    std::vector<G4double> fPixelWeightedEdep;  // sum of weight x edep
+    std::vector<G4int> fTouched;  // non-empty cells, in order of first deposit
+    std::size_t fLastNbOfPixels = 0;  // of the previous event
+    G4int fGridVersion = -1;  // readout version of the grid
+};
+
+}  // namespace B2a
+
+#endif
@@ -0,0 +1,186 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file TriggerMessenger.cc
+/// \brief Implementation of the B2a::TriggerMessenger class
+
+#include "TriggerMessenger.hh"
+
+#include "CoincidenceTrigger.hh"
+
+#include "G4UIcmdWithoutParameter.hh"
+#include "G4UIcommand.hh"
+#include "G4UIdirectory.hh"
+#include "G4UIparameter.hh"
+
+#include <sstream>
+
+namespace B2a
+{
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+TriggerMessenger::TriggerMessenger(CoincidenceTrigger* trigger) : fTrigger(trigger)
+{
+  fDirectory = new G4UIdirectory("/B2/trigger/");
+  fDirectory->SetGuidance("Coincidence trigger before the output stages");
+
+  fAddCmd = new G4UIcommand("/B2/trigger/add", this);
+  fAddCmd->SetGuidance("Add (or redefine) a trigger condition: a deposit in a scatter");
+  fAddCmd->SetGuidance("layer and one in an absorber layer. A layer set is \"all\",");
+  fAddCmd->SetGuidance("a material name or layer numbers separated by commas.");
+  fAddCmd->SetGuidance("Events are kept if any condition is fulfilled; without");
+  fAddCmd->SetGuidance("conditions all events are kept.");
+  fAddCmd->SetParameter(new G4UIparameter("name", 's', false));
+  fAddCmd->SetParameter(new G4UIparameter("scatterSet", 's', false));
+  fAddCmd->SetParameter(new G4UIparameter("absorberSet", 's', false));
+  fAddCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fClearCmd = new G4UIcmdWithoutParameter("/B2/trigger/clear", this);
+  fClearCmd->SetGuidance("Remove all trigger conditions.");
+  fClearCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  // Window commands: condition name, min, max and unit
+  auto makeWindowCmd = [this](const char* name, const char* guidance) {
+    auto cmd = new G4UIcommand(name, this);
+    cmd->SetGuidance(guidance);
+    cmd->SetParameter(new G4UIparameter("name", 's', false));
+    auto minPrm = new G4UIparameter("min", 'd', false);
+    minPrm->SetParameterRange("min>=0.");
+    cmd->SetParameter(minPrm);
+    auto maxPrm = new G4UIparameter("max", 'd', false);
+    maxPrm->SetParameterRange("max>0.");
+    cmd->SetParameter(maxPrm);
+    auto unitPrm = new G4UIparameter("unit", 's', true);
+    unitPrm->SetDefaultUnit("keV");
+    cmd->SetParameter(unitPrm);
+    cmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    return cmd;
+  };
+  fScatterWindowCmd = makeWindowCmd("/B2/trigger/setScatterWindow",
+                                    "Set the energy window of the scatter layer.");
+  fAbsorberWindowCmd = makeWindowCmd("/B2/trigger/setAbsorberWindow",
+                                     "Set the energy window of the absorber layer.");
+  fTotalWindowCmd = makeWindowCmd("/B2/trigger/setTotalWindow",
+                                  "Set the window of the summed scatter and absorber energy.");
+
+  fTimeWindowCmd = new G4UIcommand("/B2/trigger/setTimeWindow", this);
+  fTimeWindowCmd->SetGuidance("Set the coincidence window of the scatter and absorber.");
+  fTimeWindowCmd->SetParameter(new G4UIparameter("name", 's', false));
+  auto timePrm = new G4UIparameter("value", 'd', false);
+  timePrm->SetParameterRange("value>0.");
+  fTimeWindowCmd->SetParameter(timePrm);
+  auto unitPrm = new G4UIparameter("unit", 's', true);
+  unitPrm->SetDefaultUnit("ns");
+  fTimeWindowCmd->SetParameter(unitPrm);
+  fTimeWindowCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fComptonCmd = new G4UIcommand("/B2/trigger/setCompton", this);
+  fComptonCmd->SetGuidance("Require allowed Compton kinematics (default true).");
+  fComptonCmd->SetParameter(new G4UIparameter("name", 's', false));
+  fComptonCmd->SetParameter(new G4UIparameter("required", 'b', false));
+  fComptonCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+TriggerMessenger::~TriggerMessenger()
+{
+  delete fAddCmd;
+  delete fClearCmd;
+  delete fScatterWindowCmd;
+  delete fAbsorberWindowCmd;
+  delete fTotalWindowCmd;
+  delete fTimeWindowCmd;
+  delete fComptonCmd;
+  delete fDirectory;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void TriggerMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+  std::istringstream is(newValue);
+  G4String name;
+  is >> name;
+
+  if (command == fAddCmd) {
+    G4String scatterSet, absorberSet;
+    is >> scatterSet >> absorberSet;
+    fTrigger->AddCondition(name, scatterSet, absorberSet);
+    return;
+  }
+
+  if (command == fClearCmd) {
+    fTrigger->ClearConditions();
+    return;
+  }
+
+  auto condition = fTrigger->GetCondition(name);
+  if (!condition) {
+    G4cout << G4endl << "-->  WARNING from TriggerMessenger : no trigger condition " << name
+           << ", add it first" << G4endl;
+    return;
+  }
+
+  if (command == fScatterWindowCmd || command == fAbsorberWindowCmd
+      || command == fTotalWindowCmd) {
+    G4double min = 0., max = 0.;
+    G4String unit;
+    is >> min >> max >> unit;
+    min *= G4UIcommand::ValueOf(unit);
+    max *= G4UIcommand::ValueOf(unit);
+    if (command == fScatterWindowCmd) {
+      condition->scatterMin = min;
+      condition->scatterMax = max;
+    }
+    else if (command == fAbsorberWindowCmd) {
+      condition->absorberMin = min;
+      condition->absorberMax = max;
+    }
+    else {
+      condition->totalMin = min;
+      condition->totalMax = max;
+    }
+  }
+
+  if (command == fTimeWindowCmd) {
+    G4double value = 0.;
+    G4String unit;
+    is >> value >> unit;
+    condition->timeWindow = value * G4UIcommand::ValueOf(unit);
+  }
+
+  if (command == fComptonCmd) {
+    G4String required;
+    is >> required;
+    condition->compton = G4UIcommand::ConvertToBool(required);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}  // namespace B2a
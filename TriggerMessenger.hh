@@ -0,0 +1,82 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file TriggerMessenger.hh
+/// \brief Definition of the B2a::TriggerMessenger class
+
+#ifndef B2aTriggerMessenger_h
+#define B2aTriggerMessenger_h 1
+
+#include "G4UImessenger.hh"
+
+class G4UIdirectory;
+class G4UIcmdWithoutParameter;
+class G4UIcommand;
+
+namespace B2a
+{
+
+class CoincidenceTrigger;
+
+/// Messenger class that defines commands for the CoincidenceTrigger.
+///
+/// It implements commands:
+/// - /B2/trigger/add name scatterSet absorberSet
+/// - /B2/trigger/clear
+/// - /B2/trigger/setScatterWindow name min max unit
+/// - /B2/trigger/setAbsorberWindow name min max unit
+/// - /B2/trigger/setTotalWindow name min max unit
+/// - /B2/trigger/setTimeWindow name value unit
+/// - /B2/trigger/setCompton name true|false
+///
+/// A messenger exists on the master and on each worker (the commands are
+/// broadcast), each one configuring the trigger of its own thread.
+
+class TriggerMessenger : public G4UImessenger
+{
+  public:
+    TriggerMessenger(CoincidenceTrigger*);
+    ~TriggerMessenger() override;
+
+    void SetNewValue(G4UIcommand*, G4String) override;
+
+  private:
+    CoincidenceTrigger* fTrigger = nullptr;
+
+    G4UIdirectory* fDirectory = nullptr;
+
+    G4UIcommand* fAddCmd = nullptr;
+    G4UIcmdWithoutParameter* fClearCmd = nullptr;
+    G4UIcommand* fScatterWindowCmd = nullptr;
+    G4UIcommand* fAbsorberWindowCmd = nullptr;
+    G4UIcommand* fTotalWindowCmd = nullptr;
+    G4UIcommand* fTimeWindowCmd = nullptr;
+    G4UIcommand* fComptonCmd = nullptr;
+};
+
+}  // namespace B2a
+
+#endif
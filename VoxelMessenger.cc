@@ -0,0 +1,127 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file VoxelMessenger.cc
+/// \brief Implementation of the B2a::VoxelMessenger class
+
+#include "VoxelMessenger.hh"
+
+#include "VoxelScorer.hh"
+
+#include "G4UIcmdWithADouble.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithoutParameter.hh"
+#include "G4UIcommand.hh"
+#include "G4UIdirectory.hh"
+#include "G4UIparameter.hh"
+
+#include <sstream>
+
+namespace B2a
+{
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+VoxelMessenger::VoxelMessenger(VoxelScorer* scorer) : fScorer(scorer)
+{
+  fDirectory = new G4UIdirectory("/B2/voxel/");
+  fDirectory->SetGuidance("Sparse voxel scoring of the deposit and dose in chosen volumes");
+
+  fAddCmd = new G4UIcommand("/B2/voxel/add", this);
+  fAddCmd->SetGuidance("Score the voxels of the given size in a logical volume, e.g.");
+  fAddCmd->SetGuidance("Target or Chamber_LV (all the layers); only the voxels with a");
+  fAddCmd->SetGuidance("deposit are stored. A volume added again gets the new size.");
+  fAddCmd->SetParameter(new G4UIparameter("volume", 's', false));
+  for (auto axis : {"dx", "dy", "dz"}) {
+    auto sizePrm = new G4UIparameter(axis, 'd', false);
+    sizePrm->SetParameterRange(G4String(axis) + ">0.");
+    fAddCmd->SetParameter(sizePrm);
+  }
+  auto unitPrm = new G4UIparameter("unit", 's', true);
+  unitPrm->SetDefaultUnit("mm");
+  fAddCmd->SetParameter(unitPrm);
+  fAddCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fClearCmd = new G4UIcmdWithoutParameter("/B2/voxel/clear", this);
+  fClearCmd->SetGuidance("Remove all the scored volumes: the scoring is disabled.");
+  fClearCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fMaxMemoryCmd = new G4UIcmdWithADouble("/B2/voxel/maxMemory", this);
+  fMaxMemoryCmd->SetGuidance("Memory bound of the voxel table of each thread, in MB");
+  fMaxMemoryCmd->SetGuidance("(default 256); the deposits beyond are counted as lost.");
+  fMaxMemoryCmd->SetParameterName("megabytes", false);
+  fMaxMemoryCmd->SetRange("megabytes>0.");
+  fMaxMemoryCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fFileCmd = new G4UIcmdWithAString("/B2/voxel/file", this);
+  fFileCmd->SetGuidance("Binary file receiving the voxels of each run:");
+  fFileCmd->SetGuidance("  <name>_r<run>.b2vox (default name: voxels)");
+  fFileCmd->SetGuidance("An empty name disables the file, the summary is printed.");
+  fFileCmd->SetParameterName("name", true);
+  fFileCmd->SetDefaultValue("");
+  fFileCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+VoxelMessenger::~VoxelMessenger()
+{
+  delete fAddCmd;
+  delete fClearCmd;
+  delete fMaxMemoryCmd;
+  delete fFileCmd;
+  delete fDirectory;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void VoxelMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+  if (command == fAddCmd) {
+    G4String volume, unit;
+    G4double dx = 0., dy = 0., dz = 0.;
+    std::istringstream is(newValue);
+    is >> volume >> dx >> dy >> dz >> unit;
+    G4double scale = G4UIcommand::ValueOf(unit);
+    fScorer->AddVolume(volume, G4ThreeVector(dx, dy, dz) * scale);
+  }
+
+  if (command == fClearCmd) {
+    fScorer->ClearVolumes();
+  }
+
+  if (command == fMaxMemoryCmd) {
+    fScorer->SetMaxMemory(fMaxMemoryCmd->GetNewDoubleValue(newValue));
+  }
+
+  if (command == fFileCmd) {
+    fScorer->SetFileName(newValue);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}  // namespace B2a
@@ -0,0 +1,78 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file VoxelMessenger.hh
+/// \brief Definition of the B2a::VoxelMessenger class
+
+#ifndef B2aVoxelMessenger_h
+#define B2aVoxelMessenger_h 1
+
+#include "G4UImessenger.hh"
+
+class G4UIdirectory;
+class G4UIcmdWithADouble;
+class G4UIcmdWithAString;
+class G4UIcmdWithoutParameter;
+class G4UIcommand;
+
+namespace B2a
+{
+
+class VoxelScorer;
+
+/// Messenger class that defines commands for the VoxelScorer.
+///
+/// It implements commands:
+/// - /B2/voxel/add volume dx dy dz unit
+/// - /B2/voxel/clear
+/// - /B2/voxel/maxMemory megabytes
+/// - /B2/voxel/file name
+///
+/// A messenger exists on the master and on each worker (the commands are
+/// broadcast), each one configuring the scorer of its own thread.
+
+class VoxelMessenger : public G4UImessenger
+{
+  public:
+    VoxelMessenger(VoxelScorer*);
+    ~VoxelMessenger() override;
+
+    void SetNewValue(G4UIcommand*, G4String) override;
+
+  private:
+    VoxelScorer* fScorer = nullptr;
+
+    G4UIdirectory* fDirectory = nullptr;
+
+    G4UIcommand* fAddCmd = nullptr;
+    G4UIcmdWithoutParameter* fClearCmd = nullptr;
+    G4UIcmdWithADouble* fMaxMemoryCmd = nullptr;
+    G4UIcmdWithAString* fFileCmd = nullptr;
+};
+
+}  // namespace B2a
+
+#endif
@@ -0,0 +1,511 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file VoxelScorer.cc
+/// \brief Implementation of the B2a::VoxelScorer class
+
+#include "VoxelScorer.hh"
+
+#include "VoxelMessenger.hh"
+
+#include "G4AffineTransform.hh"
+#include "G4AutoLock.hh"
+#include "G4LogicalVolume.hh"
+#include "G4LogicalVolumeStore.hh"
+#include "G4Material.hh"
+#include "G4Step.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4VPVParameterisation.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4VSolid.hh"
+#include "G4VTouchable.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+
+namespace
+{
+// Finalizer of MurmurHash3: the voxel indices differ in their low bits
+std::uint64_t Mix(std::uint64_t key)
+{
+  key ^= key >> 33;
+  key *= 0xff51afd7ed558ccdULL;
+  key ^= key >> 33;
+  key *= 0xc4ceb9fe1a85ec53ULL;
+  key ^= key >> 33;
+  return key;
+}
+
+// Points per axis sampling the fraction of a voxel inside its solid
+constexpr G4int kMassSamples = 4;
+}  // namespace
+
+namespace B2a
+{
+
+std::vector<const VoxelScorer*> VoxelScorer::fWorkers;
+G4Mutex VoxelScorer::fWorkersMutex = G4MUTEX_INITIALIZER;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+VoxelScorer::VoxelScorer()
+{
+  fMessenger = new VoxelMessenger(this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+VoxelScorer::~VoxelScorer()
+{
+  delete fMessenger;
+
+  G4AutoLock lock(&fWorkersMutex);
+  for (auto& worker : fWorkers) {
+    if (worker == this) worker = nullptr;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void VoxelScorer::AddVolume(const G4String& name, const G4ThreeVector& size)
+{
+  for (auto& volume : fVolumes) {
+    if (volume.name == name) {
+      volume.size = size;
+      return;
+    }
+  }
+  if (fVolumes.size() >= 255) {
+    G4ExceptionDescription msg;
+    msg << "Too many scored volumes, " << name << " ignored";
+    G4Exception("VoxelScorer::AddVolume()", "B2aVoxel003", JustWarning, msg);
+    return;
+  }
+  fVolumes.push_back({name, size});
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::uint64_t VoxelScorer::Key(G4int volume, G4int copy, G4int ix, G4int iy, G4int iz)
+{
+  return (std::uint64_t(volume) << 54) | (std::uint64_t(copy) << 42)
+         | (std::uint64_t(ix) << (2 * kIndexBits)) | (std::uint64_t(iy) << kIndexBits)
+         | std::uint64_t(iz);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void VoxelScorer::BeginOfRun(G4int runID, const G4String& fileTag)
+{
+  fRunID = runID;
+  fFileTag = fileTag;
+  fVolumeLVs.clear();
+  fLastLV = nullptr;
+  fLastVolume = -1;
+  fOrigins.clear();
+  fNbOfVoxels = 0;
+  fEvent = 0;
+  fLostEdep = 0.;
+  fLostSteps = 0;
+  std::vector<Voxel>().swap(fSlots);  // releases the table of the last run
+  if (!IsEnabled()) return;
+
+  // the geometry is only modified between runs; a name may cover several
+  // logical volumes (one "Chamber_LV" per layer material)
+  for (std::size_t i = 0; i < fVolumes.size(); ++i) {
+    G4bool found = false;
+    for (auto lv : *G4LogicalVolumeStore::GetInstance()) {
+      if (lv->GetName() != fVolumes[i].name) continue;
+      fVolumeLVs.emplace_back(lv, (G4int)i);
+      found = true;
+    }
+    if (!found && !G4Threading::IsWorkerThread()) {
+      G4ExceptionDescription msg;
+      msg << "No logical volume " << fVolumes[i].name << ", not scored";
+      G4Exception("VoxelScorer::BeginOfRun()", "B2aVoxel004", JustWarning, msg);
+    }
+  }
+
+  fMaxSlots = kInitialSlots;
+  while (2 * fMaxSlots * sizeof(Voxel) <= fMaxMemory * 1048576.) fMaxSlots *= 2;
+  fSlots.assign(kInitialSlots, Voxel());
+
+  if (G4Threading::IsWorkerThread()) {
+    auto threadID = (std::size_t)G4Threading::G4GetThreadId();
+    G4AutoLock lock(&fWorkersMutex);
+    if (fWorkers.size() <= threadID) fWorkers.resize(threadID + 1, nullptr);
+    fWorkers[threadID] = this;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+VoxelScorer::Voxel* VoxelScorer::Insert(std::uint64_t key, G4bool& inserted)
+{
+  if (2 * (fNbOfVoxels + 1) > fSlots.size() && fSlots.size() < fMaxSlots) {
+    Rehash(2 * fSlots.size());
+  }
+
+  std::size_t mask = fSlots.size() - 1;
+  for (std::size_t i = Mix(key) & mask;; i = (i + 1) & mask) {
+    auto& slot = fSlots[i];
+    if (slot.key == key) {
+      inserted = false;
+      return &slot;
+    }
+    if (slot.key == kEmpty) {
+      // at the memory limit, filled up to 3/4: the probes stay short
+      if (4 * (fNbOfVoxels + 1) > 3 * fSlots.size()) return nullptr;
+      slot.key = key;
+      ++fNbOfVoxels;
+      inserted = true;
+      return &slot;
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void VoxelScorer::Rehash(std::size_t nofSlots)
+{
+  std::vector<Voxel> slots(nofSlots);
+  std::size_t mask = nofSlots - 1;
+  for (const auto& voxel : fSlots) {
+    if (voxel.key == kEmpty) continue;
+    std::size_t i = Mix(voxel.key) & mask;
+    while (slots[i].key != kEmpty) i = (i + 1) & mask;
+    slots[i] = voxel;
+  }
+  fSlots.swap(slots);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void VoxelScorer::Fill(const G4Step* step)
+{
+  auto preStepPoint = step->GetPreStepPoint();
+  auto touchable = preStepPoint->GetTouchable();
+  auto physical = touchable->GetVolume();
+
+  // consecutive steps mostly stay in the same volume
+  auto lv = physical->GetLogicalVolume();
+  if (lv != fLastLV) {
+    fLastLV = lv;
+    fLastVolume = -1;
+    for (const auto& [volumeLV, volume] : fVolumeLVs) {
+      if (volumeLV == lv) fLastVolume = volume;
+    }
+  }
+  if (fLastVolume < 0) return;
+
+  G4double edep = step->GetTotalEnergyDeposit() * step->GetTrack()->GetWeight();
+  if (edep <= 0.) return;
+
+  // the solid of a parameterised volume is shared by its copies: set the
+  // dimensions of this copy, as the navigator does
+  G4int copy = touchable->GetCopyNumber(0);
+  auto solid = touchable->GetSolid();
+  if (auto parameterisation = physical->GetParameterisation()) {
+    solid = parameterisation->ComputeSolid(copy, physical);
+    solid->ComputeDimensions(parameterisation, copy, physical);
+  }
+  if (touchable->GetHistoryDepth() > 0) copy += touchable->GetCopyNumber(1);
+
+  G4ThreeVector pMin, pMax;
+  solid->BoundingLimits(pMin, pMax);
+  const auto& transform = touchable->GetHistory()->GetTopTransform();
+  auto midpoint = 0.5 * (preStepPoint->GetPosition() + step->GetPostStepPoint()->GetPosition());
+  auto local = transform.TransformPoint(midpoint);
+
+  const auto& size = fVolumes[fLastVolume].size;
+  G4int index[3];
+  G4bool inRange = copy >= 0 && copy < (1 << kCopyBits);
+  for (G4int k = 0; k < 3; ++k) {
+    auto nofVoxels = std::max(1, G4int(std::ceil((pMax[k] - pMin[k]) / size[k])));
+    index[k] = std::clamp(G4int((local[k] - pMin[k]) / size[k]), 0, nofVoxels - 1);
+    inRange = inRange && index[k] < (1 << kIndexBits);
+  }
+
+  G4bool inserted = false;
+  auto key = Key(fLastVolume, copy, index[0], index[1], index[2]);
+  auto voxel = inRange ? Insert(key, inserted) : nullptr;
+  if (!voxel) {
+    fLostEdep += edep;
+    ++fLostSteps;
+    return;
+  }
+
+  if (inserted) {
+    // the voxel box clipped to the placement, and its fraction inside
+    // the solid
+    G4ThreeVector low, high;
+    for (G4int k = 0; k < 3; ++k) {
+      low[k] = pMin[k] + index[k] * size[k];
+      high[k] = std::min(pMax[k], low[k] + size[k]);
+    }
+    auto extent = high - low;
+    G4int nofInside = 0;
+    for (G4int i = 0; i < kMassSamples; ++i) {
+      for (G4int j = 0; j < kMassSamples; ++j) {
+        for (G4int k = 0; k < kMassSamples; ++k) {
+          G4ThreeVector point(low.x() + (i + 0.5) * extent.x() / kMassSamples,
+                              low.y() + (j + 0.5) * extent.y() / kMassSamples,
+                              low.z() + (k + 0.5) * extent.z() / kMassSamples);
+          if (solid->Inside(point) != kOutside) ++nofInside;
+        }
+      }
+    }
+    G4double fraction = std::max(1, nofInside) / std::pow(G4double(kMassSamples), 3);
+    voxel->mass = preStepPoint->GetMaterial()->GetDensity() * extent.x() * extent.y()
+                  * extent.z() * fraction;
+    voxel->event = fEvent;
+
+    if (fOrigins.find(key >> 42) == fOrigins.end()) {
+      fOrigins[key >> 42] = transform.Inverse().TransformPoint(pMin);
+    }
+  }
+
+  // the deposits of the last event touching the voxel go to the sums
+  if (voxel->event != fEvent) {
+    voxel->edep += voxel->eventEdep;
+    voxel->edep2 += voxel->eventEdep * voxel->eventEdep;
+    voxel->eventEdep = 0.;
+    voxel->event = fEvent;
+  }
+  voxel->eventEdep += edep;
+  ++voxel->nofSteps;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void VoxelScorer::Fold()
+{
+  for (auto& voxel : fSlots) {
+    if (voxel.key == kEmpty) continue;
+    voxel.edep += voxel.eventEdep;
+    voxel.edep2 += voxel.eventEdep * voxel.eventEdep;
+    voxel.eventEdep = 0.;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void VoxelScorer::Add(const VoxelScorer& worker)
+{
+  for (const auto& workerVoxel : worker.fSlots) {
+    if (workerVoxel.key == kEmpty) continue;
+    G4bool inserted = false;
+    auto voxel = Insert(workerVoxel.key, inserted);
+    if (!voxel) {
+      fLostEdep += workerVoxel.edep;
+      fLostSteps += workerVoxel.nofSteps;
+      continue;
+    }
+    if (inserted) voxel->mass = workerVoxel.mass;
+    voxel->edep += workerVoxel.edep;
+    voxel->edep2 += workerVoxel.edep2;
+    voxel->nofSteps += workerVoxel.nofSteps;
+  }
+  fOrigins.insert(worker.fOrigins.begin(), worker.fOrigins.end());
+  fEvent += worker.fEvent;
+  fLostEdep += worker.fLostEdep;
+  fLostSteps += worker.fLostSteps;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void VoxelScorer::EndOfRun()
+{
+  if (fSlots.empty()) return;
+
+  // the last event of the thread (in sequential mode, of the master)
+  Fold();
+  if (G4Threading::IsWorkerThread()) return;
+
+  // The workers have ended the run before the master: their tables are
+  // not modified until their next run, and the registry only at the
+  // beginning of a run or by a destructor, neither during this call.
+  G4cout << G4endl << " Voxel scoring, memory per table:" << G4endl;
+  for (std::size_t i = 0; i < fWorkers.size(); ++i) {
+    auto worker = fWorkers[i];
+    if (!worker || worker->fRunID != fRunID) continue;
+    worker->PrintMemory(std::to_string(i));
+    Add(*worker);
+  }
+  PrintMemory(G4Threading::IsMultithreadedApplication() ? "merged" : "master");
+
+  if (fEvent == 0) return;
+
+  Print();
+  if (!fFileName.empty()) Write(fFileName + "_r" + std::to_string(fRunID) + fFileTag + ".b2vox");
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void VoxelScorer::PrintMemory(const G4String& thread) const
+{
+  G4double memory = fSlots.size() * sizeof(Voxel) / 1048576.;
+  G4double fill = fSlots.empty() ? 0. : G4double(fNbOfVoxels) / fSlots.size();
+  G4cout << std::setw(10) << thread << ": " << fNbOfVoxels << " voxels, " << fSlots.size()
+         << " slots, " << memory << " MB, fill " << fill << ", " << fLostSteps
+         << " steps lost" << G4endl
+         << "B2a-voxelmem run=" << fRunID << " thread=" << thread << " voxels=" << fNbOfVoxels
+         << " slots=" << fSlots.size() << " memory_MB=" << memory << " fill=" << fill
+         << " lost_steps=" << fLostSteps << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void VoxelScorer::Print() const
+{
+  struct Summary {
+    std::uint64_t nofVoxels = 0;
+    std::uint64_t nofSteps = 0;
+    G4double edep = 0.;
+    const Voxel* maxDose = nullptr;
+  };
+  std::vector<Summary> summaries(fVolumes.size());
+  G4double totalEdep = fLostEdep;
+  for (const auto& voxel : fSlots) {
+    if (voxel.key == kEmpty) continue;
+    auto& summary = summaries[VolumeOf(voxel.key)];
+    ++summary.nofVoxels;
+    summary.nofSteps += voxel.nofSteps;
+    summary.edep += voxel.edep;
+    totalEdep += voxel.edep;
+    auto maxDose = summary.maxDose;
+    if (voxel.mass > 0. && (!maxDose || voxel.edep / voxel.mass > maxDose->edep / maxDose->mass)) {
+      summary.maxDose = &voxel;
+    }
+  }
+
+  G4cout << G4endl << " Voxel scoring, " << fNbOfVoxels << " voxels, " << fEvent << " events"
+         << G4endl << std::setw(14) << "volume" << std::setw(12) << "voxels" << std::setw(14)
+         << "MeV/event" << std::setw(16) << "max Gy/event" << std::setw(10) << "error"
+         << std::setw(8) << "copy" << G4endl;
+
+  for (std::size_t i = 0; i < fVolumes.size(); ++i) {
+    const auto& summary = summaries[i];
+    G4double maxDose = 0.;
+    G4double error = 0.;
+    G4int copy = -1;
+    if (auto voxel = summary.maxDose) {
+      maxDose = voxel->edep / voxel->mass / fEvent;
+      error = std::sqrt(std::max(0., voxel->edep2 / (voxel->edep * voxel->edep) - 1. / fEvent));
+      copy = CopyOf(voxel->key);
+    }
+    const auto& name = fVolumes[i].name;
+    G4cout << std::setw(14) << name << std::setw(12) << summary.nofVoxels << std::setw(14)
+           << summary.edep / MeV / fEvent << std::setw(16) << maxDose / gray << std::setw(10)
+           << error << std::setw(8) << copy << G4endl
+           << "B2a-voxel run=" << fRunID << " volume=" << name
+           << " voxels=" << summary.nofVoxels << " steps=" << summary.nofSteps
+           << " edep_MeV_per_event=" << summary.edep / MeV / fEvent
+           << " max_dose_Gy_per_event=" << maxDose / gray << " max_dose_error=" << error
+           << " max_dose_copy=" << copy << G4endl;
+  }
+
+  if (fLostSteps > 0) {
+    G4ExceptionDescription msg;
+    msg << fLostSteps << " steps, " << ((totalEdep > 0.) ? fLostEdep / totalEdep : 0.)
+        << " of the deposit, not scored (/B2/voxel/maxMemory, or over " << (1 << kIndexBits)
+        << " voxels per axis)";
+    G4Exception("VoxelScorer::Print()", "B2aVoxel005", JustWarning, msg);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void VoxelScorer::Write(const G4String& fileName) const
+{
+  std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+  if (!file) {
+    G4ExceptionDescription msg;
+    msg << "Cannot open voxel file " << fileName;
+    G4Exception("VoxelScorer::Write()", "B2aVoxel001", JustWarning, msg);
+    return;
+  }
+
+  auto write = [&file](const auto& value) {
+    file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+  };
+
+  char magic[8] = {'B', '2', 'A', 'V', 'O', 'X', 'E', 'L'};
+  file.write(magic, sizeof(magic));
+  write(kVersion);
+  write(std::uint32_t(48));
+  write(std::int32_t(fRunID));
+  write(std::uint32_t(fVolumes.size()));
+  write(std::uint64_t(fEvent));
+  write(std::uint64_t(fNbOfVoxels));
+  write(fLostEdep / MeV);
+
+  for (const auto& volume : fVolumes) {
+    char name[32] = {};
+    std::strncpy(name, volume.name.c_str(), sizeof(name) - 1);
+    file.write(name, sizeof(name));
+    for (G4int k = 0; k < 3; ++k) write(volume.size[k] / mm);
+  }
+
+  write(std::uint64_t(fOrigins.size()));
+  for (const auto& [placement, origin] : fOrigins) {
+    write(std::uint32_t(placement >> kCopyBits));
+    write(std::uint32_t(placement & ((1 << kCopyBits) - 1)));
+    for (G4int k = 0; k < 3; ++k) write(origin[k] / mm);
+  }
+
+  // sorted: the voxels of a placement, then of a row, are contiguous
+  std::vector<const Voxel*> voxels;
+  voxels.reserve(fNbOfVoxels);
+  for (const auto& voxel : fSlots) {
+    if (voxel.key != kEmpty) voxels.push_back(&voxel);
+  }
+  std::sort(voxels.begin(), voxels.end(),
+            [](const Voxel* a, const Voxel* b) { return a->key < b->key; });
+  for (auto voxel : voxels) {
+    write(voxel->key);
+    write(voxel->edep / MeV);
+    write(voxel->edep2 / (MeV * MeV));
+    write(voxel->mass / kg);
+    write(voxel->nofSteps);
+    write(std::uint32_t(0));
+  }
+
+  if (!file) {
+    G4ExceptionDescription msg;
+    msg << "Write error on voxel file " << fileName;
+    G4Exception("VoxelScorer::Write()", "B2aVoxel002", JustWarning, msg);
+    return;
+  }
+  G4cout << " Voxels written to " << fileName << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+}  // namespace B2a
@@ -0,0 +1,203 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file VoxelScorer.hh
+/// \brief Definition of the B2a::VoxelScorer class
+
+#ifndef B2aVoxelScorer_h
+#define B2aVoxelScorer_h 1
+
+#include "G4ThreeVector.hh"
+#include "G4Threading.hh"
+#include "globals.hh"
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+class G4LogicalVolume;
+class G4Step;
+
+namespace B2a
+{
+
+class VoxelMessenger;
+
+/// Sparse voxel scoring of the energy deposit and dose in chosen volumes.
+///
+/// A scored volume is given by its logical volume name ("Target",
+/// "Chamber_LV": all the layers) and a voxel size. The voxels of each
+/// placement are laid out in its local frame from the low corner of its
+/// bounding box; a placement is identified by copyNo(0) + copyNo(1), the
+/// layer index for the chambers (see DetectorConstruction). The deposit
+/// of a step, times the track weight, goes to the voxel of the step
+/// midpoint: the steps must be limited (/B2/det/region/) to resolve
+/// voxels shorter than the mean step.
+///
+/// Only the voxels receiving a deposit are stored, in an open-addressing
+/// hash table with linear probing, keyed by the voxel index
+///   volume (8 bits) | copy (12 bits) | ix, iy, iz (14 bits each)
+/// The table doubles when half full, up to /B2/voxel/maxMemory; beyond,
+/// it is filled up to 3/4 and the deposits of the new voxels are counted
+/// as lost. The mass of a voxel, its box clipped to the bounding box of
+/// its placement, with the fraction inside the solid sampled on a 4^3
+/// grid, is computed when the voxel is created.
+///
+/// The deposits of the current event are kept apart and folded into the
+/// sums, of the deposits and of their squares, when the next event
+/// touches the voxel: the errors are those of the per-event deposits.
+///
+/// As for the OnlineHistograms, the workers register their tables at the
+/// beginning of the run and the master adds them at its end of run,
+/// without a lock, into its own table, bounded alike. The master prints
+/// the memory and fill rate of each table ("B2a-voxelmem" lines), the
+/// voxels, deposit and maximum dose of each volume ("B2a-voxel" lines),
+/// and writes the voxels, sorted by index, to <name>_r<run>.b2vox:
+///
+///   file header, 48 bytes
+///     char     magic[8]      "B2AVOXEL"
+///     uint32   version       1
+///     uint32   headerSize    48
+///     int32    runID
+///     uint32   nofVolumes
+///     uint64   nofEvents
+///     uint64   nofVoxels
+///     float64  lostEdep      MeV, in the voxels not stored
+///   per volume
+///     char     name[32]
+///     float64  size[3]       mm
+///   uint64     nofPlacements
+///   per placement
+///     uint32   volume, copy
+///     float64  origin[3]     mm, world position of the voxel (0, 0, 0)
+///                            low corner (the volumes are not rotated)
+///   per voxel
+///     uint64   index
+///     float64  edep          MeV, sum over the events
+///     float64  edep2         MeV^2, sum of the squared event deposits
+///     float64  mass          kg
+///     uint32   nofSteps
+///     uint32   reserved
+///
+/// The voxel tables are not saved in the checkpoints: a run with voxel
+/// scoring cannot be resumed (see CheckpointManager). One instance per
+/// thread, owned by the RunAction, configured by its VoxelMessenger.
+
+class VoxelScorer
+{
+  public:
+    struct Volume {
+      G4String name;
+      G4ThreeVector size;
+    };
+
+    static constexpr std::uint32_t kVersion = 1;
+
+    VoxelScorer();
+    ~VoxelScorer();
+
+    VoxelScorer(const VoxelScorer&) = delete;
+    VoxelScorer& operator=(const VoxelScorer&) = delete;
+
+    // Configuration; a volume added again gets the new voxel size
+    void AddVolume(const G4String& name, const G4ThreeVector& size);
+    void ClearVolumes() { fVolumes.clear(); }
+    void SetMaxMemory(G4double megabytes) { fMaxMemory = megabytes; }
+    void SetFileName(const G4String& name) { fFileName = name; }
+    G4bool IsEnabled() const { return !fVolumes.empty(); }
+
+    // Bytes of the voxel table (see MemoryMonitor)
+    std::size_t GetMemorySize() const { return fSlots.capacity() * sizeof(Voxel); }
+
+    // All threads: resolves the volumes, allocates an empty table; the
+    // file tag is that of the outputs of the run (shard, checkpoint)
+    void BeginOfRun(G4int runID, const G4String& fileTag);
+
+    // Thread processing events
+    void Fill(const G4Step*);
+    void EndOfEvent() { ++fEvent; }
+
+    // All threads: the workers fold their last event, the master adds up
+    // their tables, prints and writes them
+    void EndOfRun();
+
+  private:
+    struct Voxel {
+      std::uint64_t key = kEmpty;
+      G4double eventEdep = 0.;  // current event, not yet in the sums
+      G4double edep = 0.;
+      G4double edep2 = 0.;
+      G4double mass = 0.;
+      std::uint32_t event = 0;  // event of eventEdep
+      std::uint32_t nofSteps = 0;
+    };
+
+    static constexpr std::uint64_t kEmpty = ~std::uint64_t(0);
+    static constexpr G4int kIndexBits = 14;
+    static constexpr G4int kCopyBits = 12;
+    static constexpr std::size_t kInitialSlots = 4096;
+
+    static std::uint64_t Key(G4int volume, G4int copy, G4int ix, G4int iy, G4int iz);
+    static G4int VolumeOf(std::uint64_t key) { return G4int(key >> 54); }
+    static G4int CopyOf(std::uint64_t key) { return G4int((key >> 42) & 0xfff); }
+
+    // Slot of the key, inserted if absent; nullptr if the table is full
+    Voxel* Insert(std::uint64_t key, G4bool& inserted);
+    void Rehash(std::size_t nofSlots);
+    void Fold();
+    void Add(const VoxelScorer& worker);
+    void Print() const;
+    void PrintMemory(const G4String& thread) const;
+    void Write(const G4String& fileName) const;
+
+    std::vector<Volume> fVolumes;
+    G4double fMaxMemory = 256.;  // MB per table
+    G4String fFileName = "voxels";
+
+    G4int fRunID = -1;
+    G4String fFileTag;
+    std::vector<std::pair<const G4LogicalVolume*, G4int>> fVolumeLVs;
+    const G4LogicalVolume* fLastLV = nullptr;
+    G4int fLastVolume = -1;
+
+    std::vector<Voxel> fSlots;  // power of two
+    std::size_t fMaxSlots = 0;
+    std::size_t fNbOfVoxels = 0;
+    std::map<std::uint64_t, G4ThreeVector> fOrigins;  // by volume and copy
+    std::uint32_t fEvent = 0;  // events scored, also the current event stamp
+    G4double fLostEdep = 0.;
+    std::uint64_t fLostSteps = 0;
+
+    // Tables of the workers, by thread ID
+    static std::vector<const VoxelScorer*> fWorkers;
+    static G4Mutex fWorkersMutex;
+
+    VoxelMessenger* fMessenger = nullptr;
+};
+
+}  // namespace B2a
+
+#endif
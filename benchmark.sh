@@ -0,0 +1,178 @@
+#!/bin/sh
+#
+# Reproducible benchmark suite of exampleB2a.
+#
+# Usage: benchmark.sh [-o result.json] [-b baseline.json] [-t "threads"]
+#                     [-n events] [-r tolerance]
+#   -o  JSON result file (default: benchmark.json)
+#   -b  baseline result file: scenarios with a throughput more than
+#       tolerance % lower, or a median event time more than tolerance %
+#       higher, are flagged and the script exits with status 2
+#   -t  thread counts (default: "1 <number of cores>")
+#   -n  events of each measured run (default: 2000)
+#   -r  tolerance in % (default: 5)
+# The executable is taken from $EXAMPLE (default: ./exampleB2a).
+#
+# Each scenario runs in MT mode with fixed seeds: a warm-up run, then the
+# measured run. The physics table cache is disabled, so that the start-up
+# time ("job to first event") is the one of a cold start. The output of
+# each job is kept in <result>_logs/.
+#
+# The field column is the x component, in tesla, of the global uniform
+# field; "tracker:B" is a uniform field in the tracker only, and "map:B"
+# the map of the same field (written by makeFieldMap.sh), to compare the
+# tracking speed of the two.
+
+exe=${EXAMPLE:-./exampleB2a}
+out=benchmark.json
+baseline=""
+cores=$(nproc)
+threads=1
+[ "$cores" -gt 1 ] && threads="1 $cores"
+events=2000
+tolerance=5
+
+while getopts "o:b:t:n:r:" opt; do
+  case $opt in
+    o) out=$OPTARG ;;
+    b) baseline=$OPTARG ;;
+    t) threads=$OPTARG ;;
+    n) events=$OPTARG ;;
+    r) tolerance=$OPTARG ;;
+    *) sed -n '3,14s/^# \{0,1\}//p' "$0" >&2; exit 1 ;;
+  esac
+done
+
+# name  particle  energy  unit  chamber material  field [tesla]  digitization
+scenarios="
+proton_3GeV    proton 3   GeV default              0 0
+proton_300MeV  proton 300 MeV default              0 0
+e-_1GeV        e-     1   GeV default              0 0
+gamma_10MeV    gamma  10  MeV default              0 0
+si_only        proton 3   GeV G4_Si                0 0
+czt_only       proton 3   GeV G4_CADMIUM_TELLURIDE 0 0
+field_1T       proton 3   GeV default              1 0
+tracker_1T     proton 3   GeV default              tracker:1 0
+fieldmap_1T    proton 3   GeV default              map:1 0
+digitization   proton 3   GeV default              0 1
+"
+
+logs=${out%.json}_logs
+mkdir -p "$logs" || exit 1
+
+# value of key=value in the last line of $2 starting with $1
+value() {
+  sed -n "s/^$1 .*$2=\([^ ]*\).*/\1/p" "$3" | tail -n 1
+}
+
+# $1 as a JSON number: null if missing or not a number (nan, inf)
+json() {
+  if echo "$1" | grep -Eq '^-?[0-9]+(\.[0-9]*)?([eE][-+]?[0-9]+)?$'; then
+    echo "$1"
+  else
+    echo null
+  fi
+}
+
+{
+  echo "{"
+  echo "  \"suite\": \"exampleB2a\","
+  echo "  \"events\": $events,"
+  echo "  \"seeds\": [12345, 67890],"
+  echo "  \"results\": ["
+} > "$out"
+
+first=1
+echo "$scenarios" | while read -r name particle energy unit material field digi; do
+  [ -z "$name" ] && continue
+  for t in $threads; do
+    macro=$logs/$name.mac
+    log=$logs/${name}_t$t.log
+    fieldmap=$logs/field_${field#map:}T.map
+    case $field in
+      map:*)
+        [ -f "$fieldmap" ] ||
+          "$(dirname "$0")/makeFieldMap.sh" -f "${field#map:} 0 0" "$fieldmap" || exit 1 ;;
+    esac
+    {
+      echo "/control/verbose 0"
+      echo "/run/verbose 0"
+      echo "/random/setSeeds 12345 67890"
+      echo "/B2/physics/cache false"
+      [ "$material" != default ] && echo "/B2/det/setChamberMaterial $material"
+      case $field in
+        tracker:*) echo "/B2/det/field/setUniform ${field#tracker:} 0 0 tesla" ;;
+        map:*) echo "/B2/det/field/map $fieldmap" ;;
+      esac
+      echo "/run/initialize"
+      case $field in
+        0|tracker:*|map:*) ;;
+        *) echo "/globalField/setValue $field 0 0 tesla" ;;
+      esac
+      [ "$digi" != 0 ] && echo "/B2/digi/enable true"
+      echo "/gun/particle $particle"
+      echo "/gun/energy $energy $unit"
+      echo "/run/beamOn 100"
+      echo "/run/beamOn $events"
+    } > "$macro"
+
+    "$exe" "$macro" --mode MT --threads "$t" > "$log" 2>&1
+    status=$?
+    rate=$(value B2a-throughput events_per_s "$log")
+    if [ $status -ne 0 ] || [ "$(json "$rate")" = null ]; then
+      echo "benchmark.sh: $name on $t thread(s) failed (status $status), see $log" >&2
+      exit 1
+    fi
+    startup=$(value B2a-startup "phase=job_to_first_event s" "$log")
+
+    [ $first -eq 0 ] && echo "," >> "$out"
+    first=0
+    printf '    {"scenario": "%s", "threads": %d, "events_per_s": %s, "p50_ms": %s, "p90_ms": %s, "p99_ms": %s, "peak_rss_MB": %s, "startup_s": %s}' \
+      "$name" "$t" "$rate" \
+      "$(json "$(value B2a-latency p50_ms "$log")")" \
+      "$(json "$(value B2a-latency p90_ms "$log")")" \
+      "$(json "$(value B2a-latency p99_ms "$log")")" \
+      "$(json "$(value B2a-latency peak_rss_MB "$log")")" \
+      "$(json "$startup")" >> "$out"
+    printf "%-16s %3d threads %12.2f events/s\n" "$name" "$t" "$rate"
+  done
+done || exit 1
+
+{
+  echo ""
+  echo "  ]"
+  echo "}"
+} >> "$out"
+echo "Results written to $out"
+
+[ -z "$baseline" ] && exit 0
+
+# Comparison with the baseline, scenario by scenario
+# (one result per line, as written above)
+number() {
+  echo "$2" | sed -n "s/.*\"$1\": \([^,}]*\).*/\1/p"
+}
+
+printf "\n%-16s %7s %14s %14s %8s %9s\n" scenario threads "events/s" baseline change "p50 chg."
+status=0
+grep '"scenario"' "$out" | {
+  while read -r line; do
+    name=$(echo "$line" | sed -n 's/.*"scenario": "\([^"]*\)".*/\1/p')
+    t=$(number threads "$line")
+    reference=$(grep "\"scenario\": \"$name\", \"threads\": $t," "$baseline")
+    if [ -z "$reference" ]; then
+      printf "%-16s %7d   not in baseline\n" "$name" "$t"
+      continue
+    fi
+    awk -v n="$name" -v t="$t" -v tol="$tolerance" \
+        -v r="$(number events_per_s "$line")" -v b="$(number events_per_s "$reference")" \
+        -v p="$(number p50_ms "$line")" -v q="$(number p50_ms "$reference")" \
+      'BEGIN {
+         c = (b > 0) ? 100 * (r - b) / b : 0; d = (q > 0) ? 100 * (p - q) / q : 0
+         flag = (c < -tol || d > tol) ? "  REGRESSION" : ""
+         printf "%-16s %7d %14.2f %14.2f %7.1f%% %8.1f%%%s\n", n, t, r, b, c, d, flag
+         exit (flag != "")
+       }' || status=2
+  done
+  exit $status
+}
@@ -28,28 +28,147 @@
 /// \brief Main program of the B2a example
 
 #include "ActionInitialization.hh"
+#include "CheckpointManager.hh"
 #include "DetectorConstruction.hh"
+#include "FastSimValidator.hh"
 #include "FTFP_BERT.hh"
+#include "PhysicsTableCache.hh"
+#include "ShardDriver.hh"
+#include "StartupProfiler.hh"
+#include "SubEventDriver.hh"
+#include "SweepDriver.hh"
 
+#include "G4EmParameters.hh"
+#include "G4FastSimulationPhysics.hh"
+#include "G4HadronicParameters.hh"
 #include "G4RunManagerFactory.hh"
 #include "G4StepLimiterPhysics.hh"
 #include "G4SteppingVerbose.hh"
 #include "G4UIExecutive.hh"
+#include "G4UIcommand.hh"
 #include "G4UImanager.hh"
 #include "G4VisExecutive.hh"
 // #include "Randomize.hh"
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+namespace
+{
+void PrintUsage()
+{
+  G4cerr << " Usage: " << G4endl
+         << " exampleB2a [macro] [--mode Serial|MT|Tasking|SubEvt] [--threads N]" << G4endl
+         << "            [--vis] [--verbose] [--check-overlaps] [--shard i/N]" << G4endl
+         << "            [--resume] [--fast-sim]" << G4endl
+         << "   --mode, -m          run manager type (default: Geant4 default)" << G4endl
+         << "                       SubEvt: sub-event parallel (Geant4 11.2)" << G4endl
+         << "   --threads, -t       number of worker threads (MT/Tasking only)" << G4endl
+         << "   --vis               batch mode: initialise visualization" << G4endl
+         << "   --verbose           batch mode: print material and physics tables" << G4endl
+         << "   --check-overlaps    batch mode: validate the geometry" << G4endl
+         << "   --shard             shard i of N of the job (see /B2/shard/)" << G4endl
+         << "   --resume            resume the runs from their checkpoints" << G4endl
+         << "                       (see /B2/checkpoint/)" << G4endl
+         << "   --fast-sim          register the target shower model (see /B2/det/fastSim/)"
+         << G4endl;
+}
+}  // namespace
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
 int main(int argc, char** argv)
 {
-  // Detect interactive mode (if no arguments) and define UI session
+  // Start the job clock of the start-up profile
+  B2a::StartupProfiler::Instance();
+
+  // Parse command line
+  //
+  G4String macro;
+  G4String runMode;
+  G4int nThreads = 0;
+  G4bool vis = false;
+  G4bool verbose = false;
+  G4bool checkOverlaps = false;
+  G4int shardIndex = 0;
+  G4int nofShards = 0;  // not sharded
+  G4bool resume = false;
+  G4bool fastSim = false;
+  for (G4int i = 1; i < argc; ++i) {
+    G4String arg = argv[i];
+    if ((arg == "--mode" || arg == "-m") && i + 1 < argc) {
+      runMode = argv[++i];
+    }
+    else if ((arg == "--threads" || arg == "-t") && i + 1 < argc) {
+      nThreads = G4UIcommand::ConvertToInt(argv[++i]);
+    }
+    else if (arg == "--vis") {
+      vis = true;
+    }
+    else if (arg == "--verbose") {
+      verbose = true;
+    }
+    else if (arg == "--check-overlaps") {
+      checkOverlaps = true;
+    }
+    else if (arg == "--shard" && i + 1 < argc) {
+      if (!B2a::ShardDriver::Parse(argv[++i], shardIndex, nofShards)) {
+        PrintUsage();
+        return 1;
+      }
+    }
+    else if (arg == "--resume") {
+      resume = true;
+    }
+    else if (arg == "--fast-sim") {
+      fastSim = true;
+    }
+    else if (arg[0] != '-' && macro.empty()) {
+      macro = arg;
+    }
+    else {
+      PrintUsage();
+      return 1;
+    }
+  }
+
+  // An explicitly requested run mode must be honoured: do not silently
+  // fall back to another type if this Geant4 build does not provide it.
+  auto runType = G4RunManagerType::Default;
+  if (runMode == "Serial") {
+    runType = G4RunManagerType::SerialOnly;
+  }
+  else if (runMode == "MT") {
+    runType = G4RunManagerType::MTOnly;
+  }
+  else if (runMode == "Tasking") {
+    runType = G4RunManagerType::TaskingOnly;
+  }
+#ifdef B2A_SUBEVENT_PARALLEL
+  else if (runMode == "SubEvt") {
+    runType = G4RunManagerType::SubEvtOnly;
+  }
+#endif
+  else if (!runMode.empty()) {
+    PrintUsage();
+    return 1;
+  }
+
+  // Detect interactive mode (if no macro) and define UI session
   //
   G4UIExecutive* ui = nullptr;
-  if (argc == 1) {
+  if (macro.empty()) {
     ui = new G4UIExecutive(argc, argv);
   }
 
+  // Batch mode starts lean: no visualization, no table dumps and no
+  // overlap validation unless asked for (the macro can still turn them
+  // on); the verdict is cached, so an unchanged geometry is only checked
+  // once
+  G4bool lean = !ui;
+  vis = vis || !lean;
+  verbose = verbose || !lean;
+  checkOverlaps = checkOverlaps || !lean;
+
   // Optionally: choose a different Random engine...
   // G4Random::setTheEngine(new CLHEP::MTwistEngine);
 
@@ -57,29 +176,81 @@ int main(int argc, char** argv)
   G4int precision = 4;
   G4SteppingVerbose::UseBestUnit(precision);
 
-  // Construct the default run manager
+  // Construct the run manager of the requested type
   //
-  auto runManager = G4RunManagerFactory::CreateRunManager(G4RunManagerType::Default);
+  auto runManager = G4RunManagerFactory::CreateRunManager(runType);
+  if (nThreads > 0) {
+    runManager->SetNumberOfThreads(nThreads);
+  }
 
   // Set mandatory initialization classes
   //
-  runManager->SetUserInitialization(new B2a::DetectorConstruction());
+  auto detector = new B2a::DetectorConstruction();
+  detector->SetCheckOverlaps(checkOverlaps);
+  detector->SetFastSimAvailable(fastSim);
+  detector->SetVerboseLevel(verbose ? 1 : 0);
+  runManager->SetUserInitialization(detector);
 
-  auto physicsList = new FTFP_BERT;
+  if (!verbose) {
+    G4EmParameters::Instance()->SetVerbose(0);
+    G4HadronicParameters::Instance()->SetVerboseLevel(0);
+  }
+
+  auto physicsList = new FTFP_BERT(verbose ? 1 : 0);
   physicsList->RegisterPhysics(new G4StepLimiterPhysics());
+
+  // Fast simulation hook for the target shower model (/B2/det/fastSim/),
+  // only on request: the manager process is called at every step of the
+  // e-, e+ and gamma, even with the model off
+  if (fastSim) {
+    auto fastSimulationPhysics = new G4FastSimulationPhysics();
+    fastSimulationPhysics->ActivateFastSimulation("e-");
+    fastSimulationPhysics->ActivateFastSimulation("e+");
+    fastSimulationPhysics->ActivateFastSimulation("gamma");
+    physicsList->RegisterPhysics(fastSimulationPhysics);
+  }
   runManager->SetUserInitialization(physicsList);
 
+  // Physics tables of the first run are reused across jobs (/B2/physics/)
+  auto physicsTableCache = new B2a::PhysicsTableCache(physicsList);
+
+  // Sub-event parallel processing (/B2/subevent/), known to the actions
+  // from their construction on
+  B2a::SubEventDriver* subEventDriver = nullptr;
+  if (runMode == "SubEvt") {
+    subEventDriver = new B2a::SubEventDriver;
+  }
+
   // Set user action classes
-  runManager->SetUserInitialization(new B2::ActionInitialization());
+  runManager->SetUserInitialization(new B2a::ActionInitialization());
+
+  // Parameter sweeps within this job (/B2/sweep/)
+  auto sweepDriver = new B2a::SweepDriver(detector);
+
+  // Validation of the target shower model (/B2/fastSim/)
+  auto fastSimValidator = new B2a::FastSimValidator(detector);
+
+  // One shard of a job split over processes (/B2/shard/)
+  B2a::ShardDriver* shardDriver = nullptr;
+  if (nofShards > 0) {
+    shardDriver = new B2a::ShardDriver(shardIndex, nofShards);
+  }
+
+  // Checkpoints of the runs, and their resume (/B2/checkpoint/)
+  auto checkpointManager = new B2a::CheckpointManager(resume);
 
   // Initialize visualization with the default graphics system
-  auto visManager = new G4VisExecutive(argc, argv);
-  // Constructors can also take optional arguments:
-  // - a graphics system of choice, eg. "OGL"
-  // - and a verbosity argument - see /vis/verbose guidance.
-  // auto visManager = new G4VisExecutive(argc, argv, "OGL", "Quiet");
-  // auto visManager = new G4VisExecutive("Quiet");
-  visManager->Initialize();
+  G4VisManager* visManager = nullptr;
+  if (vis) {
+    B2a::StartupProfiler::Scope scope("visualization");
+    visManager = new G4VisExecutive(argc, argv);
+    // Constructors can also take optional arguments:
+    // - a graphics system of choice, eg. "OGL"
+    // - and a verbosity argument - see /vis/verbose guidance.
+    // auto visManager = new G4VisExecutive(argc, argv, "OGL", "Quiet");
+    // auto visManager = new G4VisExecutive("Quiet");
+    visManager->Initialize();
+  }
 
   // Get the pointer to the User Interface manager
   auto UImanager = G4UImanager::GetUIpointer();
@@ -89,8 +260,7 @@ int main(int argc, char** argv)
   if (!ui) {
     // batch mode
     G4String command = "/control/execute ";
-    G4String fileName = argv[1];
-    UImanager->ApplyCommand(command + fileName);
+    UImanager->ApplyCommand(command + macro);
   }
   else {
     // interactive mode
@@ -107,6 +277,12 @@ int main(int argc, char** argv)
   // owned and deleted by the run manager, so they should not be deleted
   // in the main() program !
   //
+  delete checkpointManager;
+  delete subEventDriver;
+  delete shardDriver;
+  delete fastSimValidator;
+  delete sweepDriver;
+  delete physicsTableCache;
   delete visManager;
   delete runManager;
 }
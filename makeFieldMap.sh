@@ -0,0 +1,42 @@
+#!/bin/sh
+#
+# Writes a field map of exampleB2a (see /B2/det/field/map).
+#
+# Usage: makeFieldMap.sh [-n nodes] [-l halfSize] [-f "Bx By Bz"] [-g gradient]
+#                        map
+#   -n  nodes per axis (default: 41)
+#   -l  half size of the mapped cube, in mm, centred on the tracker
+#       (default: 1500)
+#   -f  field at the centre, in tesla (default: "1 0 0")
+#   -g  relative change of the field per metre along z (default: 0,
+#       i.e. the map of a uniform field, to compare with /B2/det/field/setUniform)
+
+nodes=41
+half=1500
+field="1 0 0"
+gradient=0
+
+while getopts "n:l:f:g:" opt; do
+  case $opt in
+    n) nodes=$OPTARG ;;
+    l) half=$OPTARG ;;
+    f) field=$OPTARG ;;
+    g) gradient=$OPTARG ;;
+    *) sed -n '3,12s/^# \{0,1\}//p' "$0" >&2; exit 1 ;;
+  esac
+done
+shift $((OPTIND - 1))
+[ $# -eq 1 ] || { sed -n '3,12s/^# \{0,1\}//p' "$0" >&2; exit 1; }
+
+awk -v n="$nodes" -v l="$half" -v f="$field" -v g="$gradient" 'BEGIN {
+  split(f, b, " ")
+  printf "# exampleB2a field map: B = (%s) T x (1 + %s z/m)\n", f, g
+  printf "%d %d %d\n", n, n, n
+  printf "%g %g %g %g %g %g\n", -l, l, -l, l, -l, l
+  for (k = 0; k < n; k++) {
+    s = 1 + g * (-l + 2 * l * k / (n - 1)) / 1000
+    for (j = 0; j < n; j++)
+      for (i = 0; i < n; i++)
+        printf "%g %g %g\n", b[1] * s, b[2] * s, b[3] * s
+  }
+}' > "$1"
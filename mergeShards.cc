@@ -0,0 +1,535 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file mergeShards.cc
+/// \brief Merge tool of the outputs of the shards of a B2a job
+
+//
+// Combines the outputs of the shards of a job split over processes
+// (exampleB2a --shard i/N, see ShardDriver):
+//
+//   mergeShards summary merged.txt shard_r0_s*.txt
+//     adds the shard summaries of one run: counters, scores, spectra and
+//     event times; the wall time is that of the slowest shard. The shards
+//     must cover the events of the run exactly once. The merged summary
+//     has the same format, and can be merged again.
+//
+//   mergeShards hits merged.b2h hits_r0_s*.b2h
+//     concatenates the hit blocks of the hit files of one run (see
+//     HitWriter); the events keep their numbers in the run.
+//
+// Standalone, it does not need Geant4:
+//   c++ -std=c++17 -O2 -o mergeShards mergeShards.cc
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+struct Summary
+{
+    struct Score {
+      double sum = 0.;
+      double sum2 = 0.;
+    };
+    struct Trigger {
+      std::uint64_t accepted = 0;
+      double weight = 0.;
+      double energy = 0.;
+      double angle = 0.;
+    };
+    struct Cell {
+      std::uint64_t entries = 0;
+      double weight = 0.;
+      std::uint64_t split = 0;
+      std::uint64_t killed = 0;
+    };
+
+    std::string fileName;  // read from
+    int index = 0;
+    int nofShards = 1;
+    int run = 0;
+    long firstEvent = 0;
+    long nofEvents = 0;
+    long logicalEvents = 0;
+    int threads = 0;
+    double wall = 0.;
+    double core = 0.;
+    std::uint64_t hits = 0;
+    double edep = 0.;  // MeV
+    std::uint64_t writtenHits = 0;
+    std::uint64_t acceptedEvents = 0;
+    std::uint64_t acceptedHits = 0;
+    std::uint64_t recorded = 0;
+    bool biased = false;
+    std::map<int, Score> scores;  // -1: stack, else layer
+    std::vector<std::pair<double, double>> hitBins;  // low edge (MeV), weight
+    std::map<double, std::uint64_t> eventTimes;  // bin centre (s), events
+    double maxEventTime = 0.;
+    std::map<std::string, std::array<std::uint64_t, 3>> regions;
+    std::map<std::string, Trigger> triggers;
+    std::array<std::uint64_t, 5> filter{};
+    std::map<int, Cell> cells;
+
+    bool Read(const std::string& fileName);
+    void Add(const Summary&);
+    void Write(std::ostream&) const;
+    double GetTimeQuantile(double q) const;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool Summary::Read(const std::string& fileName)
+{
+  std::ifstream file(fileName);
+  if (!file) {
+    std::cerr << "mergeShards: cannot open " << fileName << std::endl;
+    return false;
+  }
+
+  this->fileName = fileName;
+  std::string line;
+  int version = 0;
+  while (std::getline(file, line)) {
+    if (line.empty() || line[0] == '#') continue;
+    std::istringstream is(line);
+    std::string key;
+    is >> key;
+    if (key == "version") {
+      is >> version;
+    }
+    else if (key == "shard") {
+      is >> index >> nofShards;
+    }
+    else if (key == "run") {
+      is >> run;
+    }
+    else if (key == "events") {
+      is >> firstEvent >> nofEvents >> logicalEvents;
+    }
+    else if (key == "threads") {
+      is >> threads;
+    }
+    else if (key == "wall_s") {
+      is >> wall;
+    }
+    else if (key == "core_s") {
+      is >> core;
+    }
+    else if (key == "hits") {
+      is >> hits >> edep;
+    }
+    else if (key == "written_hits") {
+      is >> writtenHits;
+    }
+    else if (key == "accepted") {
+      is >> acceptedEvents >> acceptedHits;
+    }
+    else if (key == "recorded") {
+      is >> recorded;
+    }
+    else if (key == "biased") {
+      is >> biased;
+    }
+    else if (key == "score") {
+      std::string which;
+      Score score;
+      is >> which >> score.sum >> score.sum2;
+      scores[which == "stack" ? -1 : std::stoi(which)] = score;
+    }
+    else if (key == "hit_bin") {
+      double low = 0., weight = 0.;
+      is >> low >> weight;
+      hitBins.emplace_back(low, weight);
+    }
+    else if (key == "event_time") {
+      double centre = 0.;
+      std::uint64_t count = 0;
+      is >> centre >> count;
+      eventTimes[centre] += count;
+    }
+    else if (key == "max_event_time_s") {
+      is >> maxEventTime;
+    }
+    else if (key == "region") {
+      std::string name;
+      auto& counters = regions[(is >> name, name)];
+      is >> counters[0] >> counters[1] >> counters[2];
+    }
+    else if (key == "trigger") {
+      std::string name;
+      auto& trigger = triggers[(is >> name, name)];
+      is >> trigger.accepted >> trigger.weight >> trigger.energy >> trigger.angle;
+    }
+    else if (key == "filter") {
+      for (auto& counter : filter) is >> counter;
+    }
+    else if (key == "cell") {
+      int cell = 0;
+      is >> cell;
+      auto& counters = cells[cell];
+      is >> counters.entries >> counters.weight >> counters.split >> counters.killed;
+    }
+    if (is.fail()) {
+      std::cerr << "mergeShards: " << fileName << ": cannot read \"" << line << "\"" << std::endl;
+      return false;
+    }
+  }
+
+  if (version != 1) {
+    std::cerr << "mergeShards: " << fileName << " is not a shard summary (version 1)"
+              << std::endl;
+    return false;
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Summary::Add(const Summary& other)
+{
+  nofEvents += other.nofEvents;
+  threads += other.threads;
+  wall = std::max(wall, other.wall);  // the shards run concurrently
+  core += other.core;
+  hits += other.hits;
+  edep += other.edep;
+  writtenHits += other.writtenHits;
+  acceptedEvents += other.acceptedEvents;
+  acceptedHits += other.acceptedHits;
+  recorded += other.recorded;
+  biased = biased || other.biased;
+
+  for (const auto& entry : other.scores) {
+    scores[entry.first].sum += entry.second.sum;
+    scores[entry.first].sum2 += entry.second.sum2;
+  }
+  if (hitBins.size() < other.hitBins.size()) hitBins.resize(other.hitBins.size());
+  for (std::size_t i = 0; i < other.hitBins.size(); ++i) {
+    hitBins[i].first = other.hitBins[i].first;
+    hitBins[i].second += other.hitBins[i].second;
+  }
+  for (const auto& entry : other.eventTimes) {
+    eventTimes[entry.first] += entry.second;
+  }
+  maxEventTime = std::max(maxEventTime, other.maxEventTime);
+
+  for (const auto& entry : other.regions) {
+    auto& counters = regions[entry.first];
+    for (std::size_t i = 0; i < counters.size(); ++i) counters[i] += entry.second[i];
+  }
+  for (const auto& entry : other.triggers) {
+    auto& trigger = triggers[entry.first];
+    trigger.accepted += entry.second.accepted;
+    trigger.weight += entry.second.weight;
+    trigger.energy += entry.second.energy;
+    trigger.angle += entry.second.angle;
+  }
+  for (std::size_t i = 0; i < filter.size(); ++i) filter[i] += other.filter[i];
+  for (const auto& entry : other.cells) {
+    auto& cell = cells[entry.first];
+    cell.entries += entry.second.entries;
+    cell.weight += entry.second.weight;
+    cell.split += entry.second.split;
+    cell.killed += entry.second.killed;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Summary::Write(std::ostream& out) const
+{
+  out << std::setprecision(std::numeric_limits<double>::max_digits10);
+  out << "# B2a shard summary (see mergeShards)\n"
+      << "version 1\n"
+      << "shard " << index << ' ' << nofShards << '\n'
+      << "run " << run << '\n'
+      << "events " << firstEvent << ' ' << nofEvents << ' ' << logicalEvents << '\n'
+      << "threads " << threads << '\n'
+      << "wall_s " << wall << '\n'
+      << "core_s " << core << '\n'
+      << "hits " << hits << ' ' << edep << '\n'
+      << "written_hits " << writtenHits << '\n'
+      << "accepted " << acceptedEvents << ' ' << acceptedHits << '\n'
+      << "recorded " << recorded << '\n'
+      << "biased " << biased << '\n';
+  for (const auto& entry : scores) {
+    out << "score ";
+    if (entry.first < 0) {
+      out << "stack";
+    }
+    else {
+      out << entry.first;
+    }
+    out << ' ' << entry.second.sum << ' ' << entry.second.sum2 << '\n';
+  }
+  for (const auto& bin : hitBins) {
+    out << "hit_bin " << bin.first << ' ' << bin.second << '\n';
+  }
+  for (const auto& entry : eventTimes) {
+    out << "event_time " << entry.first << ' ' << entry.second << '\n';
+  }
+  out << "max_event_time_s " << maxEventTime << '\n';
+  for (const auto& entry : regions) {
+    out << "region " << entry.first << ' ' << entry.second[0] << ' ' << entry.second[1] << ' '
+        << entry.second[2] << '\n';
+  }
+  for (const auto& entry : triggers) {
+    const auto& trigger = entry.second;
+    out << "trigger " << entry.first << ' ' << trigger.accepted << ' ' << trigger.weight << ' '
+        << trigger.energy << ' ' << trigger.angle << '\n';
+  }
+  out << "filter";
+  for (auto counter : filter) out << ' ' << counter;
+  out << '\n';
+  for (const auto& entry : cells) {
+    const auto& cell = entry.second;
+    out << "cell " << entry.first << ' ' << cell.entries << ' ' << cell.weight << ' '
+        << cell.split << ' ' << cell.killed << '\n';
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+double Summary::GetTimeQuantile(double q) const
+{
+  std::uint64_t total = 0;
+  for (const auto& entry : eventTimes) total += entry.second;
+  if (total == 0) return 0.;
+
+  // same convention as Run::GetEventTimeQuantile()
+  auto rank = std::max<std::uint64_t>(std::uint64_t(std::ceil(q * total)), 1);
+  std::uint64_t sum = 0;
+  for (const auto& entry : eventTimes) {
+    sum += entry.second;
+    if (sum >= rank) return std::min(maxEventTime, entry.first);
+  }
+  return maxEventTime;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+int MergeSummaries(const std::string& output, const std::vector<std::string>& inputs)
+{
+  std::vector<Summary> shards(inputs.size());
+  for (std::size_t i = 0; i < inputs.size(); ++i) {
+    if (!shards[i].Read(inputs[i])) return 1;
+  }
+
+  // the shards of one run, covering its events exactly once
+  std::sort(shards.begin(), shards.end(),
+            [](const Summary& a, const Summary& b) { return a.firstEvent < b.firstEvent; });
+  const auto& first = shards.front();
+  long next = 0;
+  for (std::size_t i = 0; i < shards.size(); ++i) {
+    const auto& shard = shards[i];
+    if (shard.run != first.run || shard.logicalEvents != first.logicalEvents) {
+      std::cerr << "mergeShards: " << shard.fileName << ": run " << shard.run << " of "
+                << shard.logicalEvents << " events, expected run " << first.run << " of "
+                << first.logicalEvents << " (" << first.fileName << ")" << std::endl;
+      return 1;
+    }
+    if (shard.firstEvent > next) {
+      std::cerr << "mergeShards: events " << next << " to " << shard.firstEvent - 1
+                << " are missing before " << shard.fileName << std::endl;
+      return 1;
+    }
+    if (shard.firstEvent < next) {
+      long last = std::min(next, shard.firstEvent + shard.nofEvents) - 1;
+      std::cerr << "mergeShards: events " << shard.firstEvent << " to " << last
+                << " are in both " << shards[i - 1].fileName << " and " << shard.fileName
+                << std::endl;
+      return 1;
+    }
+    next += shard.nofEvents;
+  }
+  if (next != first.logicalEvents) {
+    std::cerr << "mergeShards: events " << next << " to " << first.logicalEvents - 1
+              << " are missing" << std::endl;
+    return 1;
+  }
+
+  Summary merged = first;
+  for (std::size_t i = 1; i < shards.size(); ++i) merged.Add(shards[i]);
+  merged.index = 0;
+  merged.nofShards = 1;
+
+  std::ofstream file(output);
+  if (!file) {
+    std::cerr << "mergeShards: cannot open " << output << std::endl;
+    return 1;
+  }
+  merged.Write(file);
+
+  long nofEvents = merged.nofEvents;
+  double perEvent = (nofEvents > 0) ? 1. / nofEvents : 0.;
+  double rate = (merged.wall > 0.) ? nofEvents / merged.wall : 0.;
+  const auto& stack = merged.scores[-1];
+  double mean = stack.sum * perEvent;
+  double error = 0.;
+  if (nofEvents > 1 && mean > 0.) {
+    double variance = std::max(stack.sum2 * perEvent - mean * mean, 0.) / (nofEvents - 1);
+    error = std::sqrt(variance) / mean;
+  }
+
+  std::cout << " Run " << merged.run << ": " << shards.size() << " shards, " << nofEvents
+            << " events on " << merged.threads << " threads" << std::endl
+            << " Wall time " << merged.wall << " s (slowest shard), " << merged.core
+            << " core.s, " << rate << " events/s" << std::endl
+            << " Event time: " << merged.GetTimeQuantile(0.5) * 1.e3 << " ms median, "
+            << merged.GetTimeQuantile(0.99) * 1.e3 << " ms 99%" << std::endl
+            << " Layers: " << merged.hits * perEvent << " hits, " << merged.edep * perEvent
+            << " MeV per event; stack " << mean << " MeV per primary, "
+            << 100. * error << " % error" << std::endl
+            << "B2a-merge run=" << merged.run << " shards=" << shards.size()
+            << " events=" << nofEvents << " wall_s=" << merged.wall
+            << " events_per_s=" << rate << " core_s=" << merged.core
+            << " p50_ms=" << merged.GetTimeQuantile(0.5) * 1.e3
+            << " p99_ms=" << merged.GetTimeQuantile(0.99) * 1.e3
+            << " mean_MeV=" << mean << " rel_err=" << error << std::endl;
+  return 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+// Hit files: see HitWriter for the layout
+constexpr std::uint32_t kHitVersion = 2;
+constexpr std::uint32_t kBlockMagic = 0x4B4C4248;
+constexpr std::size_t kHitSize = 8 * 4;
+
+int MergeHits(const std::string& output, const std::vector<std::string>& inputs)
+{
+  std::ofstream out(output, std::ios::binary);
+  if (!out) {
+    std::cerr << "mergeShards: cannot open " << output << std::endl;
+    return 1;
+  }
+
+  std::int32_t runID = 0;
+  std::uint64_t nofHits = 0;
+  std::vector<char> buffer;
+  for (std::size_t i = 0; i < inputs.size(); ++i) {
+    std::ifstream in(inputs[i], std::ios::binary);
+    char header[32] = {};
+    std::uint32_t version = 0, headerSize = 0;
+    std::int32_t run = 0;
+    if (in.read(header, sizeof(header))) {
+      std::memcpy(&version, header + 8, 4);
+      std::memcpy(&headerSize, header + 12, 4);
+      std::memcpy(&run, header + 16, 4);
+    }
+    if (!in || std::memcmp(header, "B2AHITS", 8) != 0 || version != kHitVersion
+        || headerSize != sizeof(header))
+    {
+      std::cerr << "mergeShards: " << inputs[i] << " is not a hit file (version "
+                << kHitVersion << ")" << std::endl;
+      return 1;
+    }
+
+    // the merged header: the run of the inputs, no thread
+    if (i == 0) {
+      runID = run;
+      std::int32_t thread = -1;
+      std::memcpy(header + 20, &thread, 4);
+      out.write(header, sizeof(header));
+    }
+    else if (run != runID) {
+      std::cerr << "mergeShards: " << inputs[i] << " is of run " << run << ", not " << runID
+                << std::endl;
+      return 1;
+    }
+
+    std::uint32_t blockHeader[2];
+    while (in.read(reinterpret_cast<char*>(blockHeader), sizeof(blockHeader))) {
+      if (blockHeader[0] != kBlockMagic) {
+        std::cerr << "mergeShards: " << inputs[i] << ": corrupt block" << std::endl;
+        return 1;
+      }
+      buffer.resize(blockHeader[1] * kHitSize);
+      if (!in.read(buffer.data(), buffer.size())) {
+        std::cerr << "mergeShards: " << inputs[i] << ": truncated block" << std::endl;
+        return 1;
+      }
+      out.write(reinterpret_cast<const char*>(blockHeader), sizeof(blockHeader));
+      out.write(buffer.data(), buffer.size());
+      nofHits += blockHeader[1];
+    }
+  }
+
+  if (!out.flush()) {
+    std::cerr << "mergeShards: cannot write " << output << std::endl;
+    return 1;
+  }
+  std::cout << " Run " << runID << ": " << nofHits << " hits from " << inputs.size()
+            << " files in " << output << std::endl;
+  return 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PrintUsage()
+{
+  std::cerr << " Usage: " << std::endl
+            << " mergeShards summary output.txt summary_r<run>_s*.txt" << std::endl
+            << " mergeShards hits output.b2h hits_r<run>_s*.b2h" << std::endl;
+}
+
+}  // namespace
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+int main(int argc, char** argv)
+{
+  if (argc < 4) {
+    PrintUsage();
+    return 1;
+  }
+
+  std::string mode = argv[1];
+  std::string output = argv[2];
+  std::vector<std::string> inputs(argv + 3, argv + argc);
+  if (mode == "summary") return MergeSummaries(output, inputs);
+  if (mode == "hits") return MergeHits(output, inputs);
+
+  PrintUsage();
+  return 1;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,39 @@
+#!/bin/sh
+#
+# Throughput scaling report of exampleB2a for 1..N threads.
+#
+# Usage: scaling.sh [maxThreads] [mode] [macro]
+#   maxThreads  highest thread count to run (default: number of cores)
+#   mode        MT or Tasking (default: MT)
+#   macro       macro to run (default: scaling.mac)
+# The executable is taken from $EXAMPLE (default: ./exampleB2a).
+#
+# Thread counts are 1, 2, 4, ... and maxThreads. The throughput of each
+# point is the last "B2a-throughput" line printed by the run action.
+
+exe=${EXAMPLE:-./exampleB2a}
+max=${1:-$(nproc)}
+mode=${2:-MT}
+macro=${3:-scaling.mac}
+
+threads=""
+t=1
+while [ "$t" -lt "$max" ]; do
+  threads="$threads $t"
+  t=$((t * 2))
+done
+threads="$threads $max"
+
+printf "%8s %14s %10s %11s\n" threads "events/s" speedup efficiency
+base=""
+for t in $threads; do
+  rate=$("$exe" "$macro" --mode "$mode" --threads "$t" 2>/dev/null \
+         | sed -n 's/.*B2a-throughput.*events_per_s=\([0-9.eE+-]*\).*/\1/p' | tail -n 1)
+  if [ -z "$rate" ]; then
+    echo "scaling.sh: no throughput reported for $t thread(s)" >&2
+    exit 1
+  fi
+  [ -z "$base" ] && base=$rate
+  awk -v t="$t" -v r="$rate" -v b="$base" \
+    'BEGIN { s = r / b; printf "%8d %14.2f %10.2f %10.1f%%\n", t, r, s, 100 * s / t }'
+done
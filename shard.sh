@@ -0,0 +1,39 @@
+#!/bin/sh
+#
+# Sharded job of exampleB2a on one node: N processes, then the merge.
+#
+# Usage: shard.sh [nofShards] [threads] [macro]
+#   nofShards  number of processes (default: 4)
+#   threads    worker threads per process (default: 1)
+#   macro      macro run by every shard (default: shard.mac)
+# The executables are taken from $EXAMPLE (default: ./exampleB2a) and
+# $MERGE (default: ./mergeShards).
+#
+# Across nodes, the batch system starts "exampleB2a macro --shard i/N"
+# for i = 0..N-1 in the same directory of the shared storage, then the
+# merge step below is run once.
+
+exe=${EXAMPLE:-./exampleB2a}
+merge=${MERGE:-./mergeShards}
+n=${1:-4}
+threads=${2:-1}
+macro=${3:-shard.mac}
+
+i=0
+while [ "$i" -lt "$n" ]; do
+  "$exe" "$macro" --mode MT --threads "$threads" --shard "$i/$n" > "shard_$i.log" 2>&1 &
+  i=$((i + 1))
+done
+wait
+
+# one merge per run: summaries, and hit files if any
+status=0
+for first in shard_r*_s0.txt; do
+  [ -e "$first" ] || { echo "shard.sh: no shard summary, see shard_*.log" >&2; exit 1; }
+  run=${first#shard_r}
+  run=${run%_s0.txt}
+  "$merge" summary "shard_r$run.txt" shard_r"$run"_s*.txt || status=1
+  set -- hits_r"$run"_s*.b2h
+  [ -e "$1" ] && { "$merge" hits "hits_r$run.b2h" "$@" || status=1; }
+done
+exit $status